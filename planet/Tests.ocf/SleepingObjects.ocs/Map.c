@@ -0,0 +1,9 @@
+/* Empty map; the floor is drawn by the scenario script to be exactly flat */
+
+#include Library_Map
+
+func InitializeMap(proplist map)
+{
+	Resize(100, 50);
+	return true;
+}
@@ -0,0 +1,122 @@
+/**
+	Sleeping Objects
+	Checks that letting objects at rest sleep does not change the game.
+	The same objects are created twice, in the left and in the right half
+	of the landscape. The left ones carry an effect, so they can never fall
+	asleep. Both halves are then disturbed in the same way and the objects
+	must stay the same on both sides in every frame.
+	
+	Runs on its own, e.g. on a dedicated server:
+	openclonk-server --nonetwork Tests.ocf/SleepingObjects.ocs
+*/
+
+
+static const TestFrames = 700;
+
+protected func Initialize()
+{
+	// Material shapes would make a drawn map differ between the halves.
+	DrawMaterialQuad("Brick", 0, 304, LandscapeWidth(), 304, LandscapeWidth(), LandscapeHeight(), 0, LandscapeHeight());
+	// A script player keeps the game running without a human.
+	CreateScriptPlayer("Sleeper", RGB(0, 0, 255), nil, CSPF_NoEliminationCheck);
+	AddEffect("IntSleepTest", nil, 100, 1);
+	return;
+}
+
+protected func InitializePlayer(int plr)
+{
+	// The objects are not owned by anyone.
+	var crew;
+	while (crew = GetCrew(plr))
+		crew->RemoveObject();
+	return;
+}
+
+
+/*-- Test Control --*/
+
+global func FxIntSleepTestStart(object target, proplist effect, int temporary)
+{
+	if (temporary)
+		return FX_OK;
+	effect.offset = LandscapeWidth() / 2;
+	effect.pairs = [];
+	for (var setup in [[Rock, 60], [Wood, 120], [Metal, 180], [Ore, 240], [Coal, 320]])
+	{
+		var awake = CreateObject(setup[0], setup[1], 250, NO_OWNER);
+		var sleeper = CreateObject(setup[0], setup[1] + effect.offset, 250, NO_OWNER);
+		AddEffect("IntKeepAwake", awake, 1, 0);
+		PushBack(effect.pairs, [awake, sleeper]);
+	}
+	Log("Sleeping objects test started with %d object pairs.", GetLength(effect.pairs));
+	return FX_OK;
+}
+
+global func FxIntSleepTestTimer(object target, proplist effect, int time)
+{
+	// Disturb both halves in the same way once the objects had time to fall asleep.
+	for (var x in [0, effect.offset])
+	{
+		if (time == 150)
+			ClearFreeRect(x + 50, 304, 20, 8);
+		if (time == 200)
+			SetGravity(40);
+		if (time == 260)
+			SetGravity(100);
+		if (time == 300)
+		{
+			ClearFreeRect(x + 120, 304, 20, 12);
+			ClearFreeRect(x + 314, 304, 12, 10);
+		}
+	}
+	for (var pair in effect.pairs)
+		for (var obj in pair)
+		{
+			if (time == 350 && obj->GetID() == Wood)
+				obj->SetXDir(30);
+			if (time == 400 && obj->GetID() == Metal)
+				obj->SetR(40);
+			if (time == 450 && obj->GetID() == Ore)
+				obj->SetPosition(obj->GetX(), 250);
+			if (time == 500 && obj->GetID() == Rock)
+				obj.Plane = 250;
+		}
+	// Compare the two halves.
+	for (var pair in effect.pairs)
+	{
+		var error = CompareObjects(pair[0], pair[1], effect.offset);
+		if (error)
+		{
+			Log("Test failed in frame %d: %s differs for %i (%v instead of %v).", time, error[0], pair[0]->GetID(), error[2], error[1]);
+			return FX_Execute_Kill;
+		}
+	}
+	if (time >= TestFrames)
+	{
+		Log("Sleeping objects test successfully completed after %d frames.", time);
+		return FX_Execute_Kill;
+	}
+	return FX_OK;
+}
+
+// Returns the name and both values of the first difference, or nil.
+global func CompareObjects(object awake, object sleeper, int offset)
+{
+	if (!awake || !sleeper)
+		return ["existence", !!awake, !!sleeper];
+	var values = [
+		["x", awake->GetX(1000) + offset * 1000, sleeper->GetX(1000)],
+		["y", awake->GetY(1000), sleeper->GetY(1000)],
+		["r", awake->GetR(), sleeper->GetR()],
+		["xdir", awake->GetXDir(1000), sleeper->GetXDir(1000)],
+		["ydir", awake->GetYDir(1000), sleeper->GetYDir(1000)],
+		["rdir", awake->GetRDir(1000), sleeper->GetRDir(1000)],
+		["action", awake->GetAction(), sleeper->GetAction()],
+		["contact", awake->GetContact(-1), sleeper->GetContact(-1)],
+		["OCF", awake->GetOCF(), sleeper->GetOCF()]
+	];
+	for (var value in values)
+		if (value[1] != value[2])
+			return value;
+	return nil;
+}
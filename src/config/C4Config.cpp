@@ -66,6 +66,10 @@ void C4ConfigGeneral::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(DefRec,              "DefRec",             0              ));
 	pComp->Value(mkNamingAdapt(ScreenshotFolder,    "ScreenshotFolder",   "Screenshots",  false, true));
 	pComp->Value(mkNamingAdapt(ScrollSmooth,        "ScrollSmooth",       4              ));
+	pComp->Value(mkNamingAdapt(LogAsync,            "LogAsync",           1              ));
+	pComp->Value(mkNamingAdapt(LogJSON,             "LogJSON",            0              ));
+	pComp->Value(mkNamingAdapt(LogRepeatLimit,      "LogRepeatLimit",     0              ));
+	pComp->Value(mkNamingAdapt(WorkerThreads,       "WorkerThreads",      -1             ));
 	pComp->Value(mkNamingAdapt(AlwaysDebug,         "DebugMode",          0              ));
 	pComp->Value(mkNamingAdapt(OpenScenarioInGameMode, "OpenScenarioInGameMode", 0   )); 
 #ifdef _WIN32
@@ -48,6 +48,10 @@ public:
 	int32_t DefRec;
 	int32_t MMTimer;  // use multimedia-timers
 	int32_t ScrollSmooth; // view movement smoothing
+	int32_t LogAsync; // write log file and console on a background thread
+	int32_t LogJSON; // additionally write the log as JSON lines with frame number and subsystem
+	int32_t LogRepeatLimit; // identical consecutive log messages written at most this often; 0 for no limit
+	int32_t WorkerThreads; // threads helping with the parallel parts of a frame; -1 for one per additional core
 	int32_t ConfigResetSafety; // safety value: If this value is screwed, the config got corrupted and must be reset
 	// Determined at run-time
 	StdCopyStrBuf ExePath;
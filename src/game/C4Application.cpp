@@ -40,6 +40,7 @@
 #include <C4Network2IRC.h>
 #include <C4Particles.h>
 #include <StdPNG.h>
+#include <C4Profiler.h>
 
 #include <getopt.h>
 
@@ -254,6 +255,7 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 			{"nonetwork", no_argument, 0, 'N'},
 			{"network", no_argument, 0, 'n'},
 			{"record", no_argument, 0, 'r'},
+			{"profile", required_argument, 0, 'F'},
 
 			{"lobby", required_argument, 0, 'l'},
 
@@ -320,6 +322,13 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 			Config.General.DebugRecWrite = 1;
 			break;
 		case 'r': Game.Record = true; break;
+		case 'F':
+			ProfileFile.Copy(optarg);
+			if (Profiler.StartStream(ProfileFile.getData()))
+				Profiler.Enable(true);
+			else
+				LogF("Could not write %s", ProfileFile.getData());
+			break;
 		case 'n': Game.NetworkActive = true; break;
 		case 'N': Game.NetworkActive = false; break;
 		// Language override by parameter
@@ -582,6 +591,14 @@ bool C4Application::ProcessCallback(const char *szMessage, int iProcess)
 
 void C4Application::Clear()
 {
+	// write the rest of the streamed profile
+	if (ProfileFile)
+	{
+		if (Profiler.StopStream())
+			LogF("Profile saved to %s", ProfileFile.getData());
+		Profiler.Enable(false);
+		ProfileFile.Clear();
+	}
 	Game.Clear();
 	NextMission.Clear();
 	// stop timer
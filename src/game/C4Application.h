@@ -77,6 +77,8 @@ public:
 	StdStrBuf IncomingUpdate;
 	// set by ParseCommandLine, for manually invoking an update check by command line or url
 	int CheckForUpdates;
+	// set by ParseCommandLine: profile the whole run and save the trace to this file on exit
+	StdCopyStrBuf ProfileFile;
 
 	bool FullScreenMode();
 	int GetConfigWidth()  { return (!FullScreenMode()) ? Config.Graphics.WindowX : Config.Graphics.ResX; }
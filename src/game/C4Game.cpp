@@ -36,6 +36,8 @@
 #include <C4Viewport.h>
 #include <C4Command.h>
 #include <C4Stat.h>
+#include <C4Profiler.h>
+#include <C4ObjectCost.h>
 #include <C4League.h>
 #include <C4PlayerInfo.h>
 #include <C4LoaderScreen.h>
@@ -345,6 +347,9 @@ bool C4Game::Init()
 	// Store a start time that identifies this game on this host
 	StartTime = time(NULL);
 
+	// Helper threads for the parts of a frame that run in parallel
+	WorkerPool.SetThreadCount(Config.General.WorkerThreads);
+
 	// Get PlayerFilenames from Config, if ParseCommandLine did not fill some in
 	// Must be done here, because InitGame calls PlayerInfos.InitLocal
 	if (!*PlayerFilenames)
@@ -548,6 +553,7 @@ void C4Game::Clear()
 
 	// stop statistics
 	pNetworkStatistics.reset();
+	WorkerPool.SetThreadCount(0);
 	C4AulProfiler::Abort();
 
 	// exit gui
@@ -679,7 +685,7 @@ C4ST_NEW(MusicSystemStat,   "C4Game::Execute MusicSystem.Execute")
 C4ST_NEW(MessagesStat,      "C4Game::Execute Messages.Execute")
 
 #define EXEC_S(Expressions, Stat) \
-  { C4ST_START(Stat) Expressions C4ST_STOP(Stat) }
+  { C4PROFILE_ZONE(#Stat); C4ST_START(Stat) Expressions C4ST_STOP(Stat) }
 
 #define EXEC_S_DR(Expressions, Stat, DebugRecName) { if (Config.General.DebugRec) AddDbgRec(RCT_Block, DebugRecName, 6); EXEC_S(Expressions, Stat) }
 #define EXEC_DR(Expressions, DebugRecName) { if (Config.General.DebugRec) AddDbgRec(RCT_Block, DebugRecName, 6); Expressions }
@@ -691,7 +697,10 @@ bool C4Game::Execute() // Returns true if the game is over
 	GameGo = true;
 
 	// Network
-	Network.Execute();
+	{
+		C4PROFILE_ZONE("C4Network2::Execute");
+		Network.Execute();
+	}
 
 	// Prepare control
 	bool fControl;
@@ -704,11 +713,14 @@ bool C4Game::Execute() // Returns true if the game is over
 	if (Config.General.DebugRec)
 		Landscape.DoRelights();
 
-	// Execute the control
+	// Execute the control; from here on, all script calls are synchronized
+	AulExec.SetSyncExec(true);
 	Control.Execute();
-	if (!IsRunning) return false;
+	if (!IsRunning) { AulExec.SetSyncExec(false); return false; }
 
 	// Ticks
+	Profiler.NewFrame(FrameCounter);
+	ScriptPool.NewFrame();
 	EXEC_DR(    Ticks();                                                , "Ticks")
 
 	if (Config.General.DebugRec)
@@ -720,9 +732,13 @@ bool C4Game::Execute() // Returns true if the game is over
 
 	// Game
 
+	PathFinder.GrantRequests();
 	EXEC_S(     ExecObjects();                    , ExecObjectsStat )
-	if (pGlobalEffects)
-		EXEC_S_DR(  pGlobalEffects->Execute(NULL);  , GEStats             , "GEEx\0");
+	PathFinder.ExpireRequests();
+	if (pGlobalEffects && GlobalEffectTimer.IsDue())
+		{ EXEC_S_DR(  pGlobalEffects->Execute(NULL);  , GEStats             , "GEEx\0"); }
+	else
+		GlobalEffectTimer.Skip();
 	EXEC_S_DR(  PXS.Execute();                    , PXSStat             , "PXSEx")
 	EXEC_S_DR(  MassMover.Execute();              , MassMoverStat       , "MMvEx")
 	EXEC_S_DR(  Weather.Execute();                , WeatherStat         , "WtrEx")
@@ -735,6 +751,7 @@ bool C4Game::Execute() // Returns true if the game is over
 	EXEC_DR(    GameOverCheck();                                        , "Misc\0")
 
 	Control.DoSyncCheck();
+	AulExec.SetSyncExec(false);
 
 	// Evaluation; Game over dlg
 	if (GameOver)
@@ -743,6 +760,9 @@ bool C4Game::Execute() // Returns true if the game is over
 		if (!GameOverDlgShown) ShowGameOverDlg();
 	}
 
+	// dump object costs if requested
+	ObjectCost.Execute(FrameCounter);
+
 	// show stat each 1000 ticks
 	if (!(FrameCounter % 1000))
 	{
@@ -899,6 +919,7 @@ void C4Game::ClearPointers(C4Object * pObj)
 {
 	::AulExec.ClearPointers(pObj);
 	::Objects.ForeObjects.ClearPointers(pObj);
+	::Objects.UnsectoredObjects.ClearPointers(pObj);
 	::Messages.ClearPointers(pObj);
 	ClearObjectPtrs(pObj);
 	Application.SoundSystem.ClearPointers(pObj);
@@ -1297,6 +1318,8 @@ void C4Game::ExecObjects() // Every Tick1 by Execute
 	if (Config.General.DebugRec)
 		AddDbgRec(RCT_Block, "ObjEx", 6);
 
+	Objects.AwakeCount = Objects.SleepingCount = 0;
+	Objects.PrepareSleepChecks();
 	// Execute objects - reverse order to ensure
 	for (C4Object *cObj : Objects.reverse())
 	{
@@ -1464,6 +1487,7 @@ void C4Game::Default()
 	pScenarioSections=pCurrentScenarioSection=NULL;
 	*CurrentScenarioSection=0;
 	pGlobalEffects=NULL;
+	GlobalEffectTimer=C4EffectTimer();
 	fResortAnyObject=false;
 	pNetworkStatistics.reset();
 	::Application.MusicSystem.ClearGame();
@@ -1755,6 +1779,8 @@ void C4Game::CompileFunc(StdCompiler *pComp, CompileSettings comp, C4ValueNumber
 		// Otherwise, just compile effects
 		pComp->Value(mkParAdapt(mkNamingPtrAdapt(pGlobalEffects, "Effects"), numbers));
 	}
+	// loaded effects are bound to the timer in the next execution
+	if (pComp->isCompiler()) GlobalEffectTimer.Schedule(0);
 	pComp->Value(mkNamingAdapt(*numbers, "Values"));
 	pComp->NameEnd();
 }
@@ -2058,7 +2084,11 @@ bool C4Game::ReloadDef(C4ID id)
 		for (C4Object *obj : Objects)
 		{
 			if (obj->id == id)
+			{
 				obj->UpdateFace(true);
+				// the definition may have become a line or stopped being one
+				Objects.UpdateUnsectored(obj);
+			}
 		}
 		fSucc = true;
 	}
@@ -2238,6 +2268,7 @@ bool C4Game::InitGame(C4Group &hGroup, bool fLoadSection, bool fLoadSky, C4Value
 
 	// Pathfinder
 	if (!fLoadSection) PathFinder.Init( &LandscapeFree, &TransferZones );
+	PathFinder.EnableNavigationGraph(C4S.Game.NavigationGraph);
 	SetInitProgress(90);
 
 	// PXS
@@ -26,6 +26,8 @@
 #include "C4Scoreboard.h"
 #include <C4PlayerControl.h>
 #include <C4TransferZone.h>
+#include <C4Effect.h>
+#include <StdWorkerPool.h>
 
 #include <memory>
 
@@ -76,6 +78,7 @@ public:
 	C4Control          &Input; // shortcut
 
 	C4PathFinder        PathFinder;
+	StdWorkerPool       WorkerPool; // helper threads for the parallel parts of a frame
 	C4TransferZones     TransferZones;
 	C4Group             ScenarioFile;
 	C4GroupSet          GroupSet;
@@ -84,6 +87,7 @@ public:
 	class C4ScenarioObjectsScriptHost *pScenarioObjectsScript;
 	C4ScenarioSection   *pScenarioSections, *pCurrentScenarioSection;
 	C4Effect            *pGlobalEffects;
+	C4EffectTimer       GlobalEffectTimer; // execution state of pGlobalEffects
 	C4PlayerControlDefs PlayerControlDefs;
 	C4PlayerControlAssignmentSets PlayerControlUserAssignmentSets, PlayerControlDefaultAssignmentSets;
 	C4Scoreboard        Scoreboard;
@@ -33,6 +33,7 @@
 #include <C4GameObjects.h>
 
 #include <StdPNG.h>
+#include <C4Profiler.h>
 
 C4GraphicsSystem::C4GraphicsSystem()
 {
@@ -84,6 +85,9 @@ void C4GraphicsSystem::Execute()
 {
 	// activity check
 	if (!StartDrawing()) return;
+	C4PROFILE_ZONE("C4GraphicsSystem::Execute");
+	// count draw calls per frame
+	pDraw->NewFrame();
 
 	bool fBGDrawn = false;
 
@@ -119,7 +123,10 @@ void C4GraphicsSystem::Execute()
 		::pGUI->SetMouseInGUI(false, false);
 
 	// Viewports
-	::Viewports.Execute(!Application.isEditor && iRedrawBackground);
+	{
+		C4PROFILE_ZONE("C4ViewportList::Execute");
+		::Viewports.Execute(!Application.isEditor && iRedrawBackground);
+	}
 	if (iRedrawBackground) --iRedrawBackground;
 
 	if (!Application.isEditor)
@@ -137,6 +137,7 @@ static void crash_handler(int signo, siginfo_t * si, void *)
 			break;
 		} // else/fallthrough
 	default:
+		FlushLogOnCrash();
 		int logfd = STDERR_FILENO;
 		for (;;)
 		{
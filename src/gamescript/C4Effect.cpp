@@ -57,11 +57,14 @@ C4Effect::C4Effect(C4Object *pForObj, C4String *szName, int32_t iPrio, int32_t i
 	// assign values
 	iPriority = 0; // effect is not yet valid; some callbacks to other effects are done before
 	iInterval = iTimerInterval;
-	iTime = 0;
 	CommandTarget = pCmdTarget;
 	idCommandTarget = idCmdTarget;
 	AcquireNumber();
 	Register(pForObj, iPrio);
+	// time starts counting with the next execution of the effect list
+	pTimer = pForObj ? &pForObj->EffectTimer : &Game.GlobalEffectTimer;
+	iTime = 0; iTimeTick = pTimer->Now();
+	Schedule();
 	// Set name and callback functions
 	SetProperty(P_Name, C4VString(szName));
 }
@@ -135,7 +138,8 @@ C4Effect * C4Effect::New(C4Object * pForObj, C4String * szName, int32_t iPrio, i
 C4Effect::C4Effect()
 {
 	// defaults
-	iPriority=iTime=iInterval=0;
+	iPriority=iTime=iTimeTick=iInterval=0;
+	pTimer=NULL;
 	CommandTarget=NULL;
 	pNext = NULL;
 }
@@ -268,10 +272,40 @@ C4Effect* C4Effect::Check(C4Object *pForObj, const char *szCheckEffect, int32_t
 	return 0;
 }
 
+void C4Effect::Schedule()
+{
+	if (!pTimer) return;
+	// dead effects are deleted in the next execution
+	if (IsDead()) { pTimer->Schedule(pTimer->Tick+1); return; }
+	int32_t iStep = Abs(iInterval);
+	if (!iStep) return;
+	// next multiple of the interval
+	int32_t iRemainder = GetTime() % iStep;
+	if (iRemainder < 0) iRemainder += iStep;
+	pTimer->Schedule(std::max(pTimer->Tick, iTimeTick) + iStep - iRemainder);
+}
+
+void C4Effect::SetTime(int32_t iToTime)
+{
+	iTime = iToTime;
+	if (pTimer) iTimeTick = pTimer->Now();
+	Schedule();
+}
+
+void C4Effect::SetInterval(int32_t iToInterval)
+{
+	iInterval = iToInterval;
+	Schedule();
+}
+
 void C4Effect::Execute(C4Object *pObj)
 {
 	// get effect list
 	C4Effect **ppEffectList = pObj ? &pObj->pEffects : &Game.pGlobalEffects;
+	C4EffectTimer *pListTimer = pObj ? &pObj->EffectTimer : &Game.GlobalEffectTimer;
+	// the walk reschedules all effects
+	pListTimer->Due = C4EffectTimer::Never;
+	pListTimer->Walking = true;
 	// execute all effects not marked as dead
 	C4Effect *pEffect = this, **ppPrevEffect=ppEffectList;
 	do
@@ -289,32 +323,39 @@ void C4Effect::Execute(C4Object *pObj)
 		else
 		{
 			// execute effect: time elapsed
-			++pEffect->iTime;
+			// effects loaded from a savegame are bound to the list here
+			int32_t iTime = pEffect->GetTime() + 1;
+			pEffect->pTimer = pListTimer;
+			pEffect->iTime = iTime;
+			pEffect->iTimeTick = pListTimer->Tick + 1;
 			// check timer execution
-			if (pEffect->iInterval && !(pEffect->iTime % pEffect->iInterval))
+			if (pEffect->iInterval && !(iTime % pEffect->iInterval))
 			{
 				if (pEffect->pFnTimer)
 				{
-					if (pEffect->pFnTimer->Exec(pEffect->CommandTarget, &C4AulParSet(C4VObj(pObj), C4VPropList(pEffect), C4VInt(pEffect->iTime))).getInt() == C4Fx_Execute_Kill)
+					if (pEffect->pFnTimer->Exec(pEffect->CommandTarget, &C4AulParSet(C4VObj(pObj), C4VPropList(pEffect), C4VInt(iTime))).getInt() == C4Fx_Execute_Kill)
 					{
 						// safety: this class got deleted!
-						if (pObj && !pObj->Status) return;
+						if (pObj && !pObj->Status) { pListTimer->Walking = false; return; }
 						// timer function decided to finish it
 						pEffect->Kill(pObj);
 					}
 					// safety: this class got deleted!
-					if (pObj && !pObj->Status) return;
+					if (pObj && !pObj->Status) { pListTimer->Walking = false; return; }
 				}
 				else
 					// no timer function: mark dead after time elapsed
 					pEffect->Kill(pObj);
 			}
+			pEffect->Schedule();
 			// next effect
 			ppPrevEffect = &pEffect->pNext;
 			pEffect = pEffect->pNext;
 		}
 	}
 	while (pEffect);
+	pListTimer->Walking = false;
+	++pListTimer->Tick;
 }
 
 void C4Effect::Kill(C4Object *pObj)
@@ -455,7 +496,14 @@ void C4Effect::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	// read priority
 	pComp->Value(iPriority); pComp->Separator();
 	// read time and intervall
-	pComp->Value(iTime); pComp->Separator();
+	int32_t iTimeNow = GetTime();
+	pComp->Value(iTimeNow); pComp->Separator();
+	if (pComp->isCompiler())
+	{
+		// bound to the list timer in the first execution
+		iTime = iTimeNow;
+		pTimer = NULL;
+	}
 	pComp->Value(iInterval); pComp->Separator();
 	// read object number
 	pComp->Value(CommandTarget); pComp->Separator();
@@ -493,10 +541,10 @@ void C4Effect::SetPropertyByS(C4String * k, const C4Value & to)
 				return;
 			case P_Priority:
 				throw C4AulExecError("effect: Priority is readonly");
-			case P_Interval: iInterval = to.getInt(); return;
+			case P_Interval: SetInterval(to.getInt()); return;
 			case P_CommandTarget:
 				throw C4AulExecError("effect: CommandTarget is readonly");
-			case P_Time: iTime = to.getInt(); return;
+			case P_Time: SetTime(to.getInt()); return;
 			case P_Prototype:
 				throw new C4AulExecError("effect: Prototype is readonly");
 		}
@@ -514,10 +562,10 @@ void C4Effect::ResetProperty(C4String * k)
 				throw C4AulExecError("effect: Name has to be a nonempty string");
 			case P_Priority:
 				throw C4AulExecError("effect: Priority is readonly");
-			case P_Interval: iInterval = 0; return;
+			case P_Interval: SetInterval(0); return;
 			case P_CommandTarget:
 				throw C4AulExecError("effect: CommandTarget is readonly");
-			case P_Time: iTime = 0; return;
+			case P_Time: SetTime(0); return;
 			case P_Prototype:
 				throw new C4AulExecError("effect: Prototype is readonly");
 		}
@@ -544,7 +592,7 @@ bool C4Effect::GetPropertyByS(C4String *k, C4Value *pResult) const
 				//*pResult = CommandTarget ? C4VObj(CommandTarget) :
 				//           (idCommandTarget ? C4VPropList(Definitions.ID2Def(idCommandTarget)) : C4VNull);
 				return true;
-			case P_Time: *pResult = C4VInt(iTime); return true;
+			case P_Time: *pResult = C4VInt(GetTime()); return true;
 		}
 	}
 	return C4PropListNumbered::GetPropertyByS(k, pResult);
@@ -66,6 +66,22 @@
 #define C4Fx_FireParticle1   "Fire"
 #define C4Fx_FireParticle2   "Fire2"
 
+// Execution state of an effect list. Effect time is counted in executions of
+// the list, and the list only needs to be walked in executions in which an
+// effect timer fires or a dead effect is to be deleted.
+struct C4EffectTimer
+{
+	static const int32_t Never = 0x7fffffff;
+	int32_t Tick;  // number of finished executions of the effect list
+	int32_t Due;   // first execution in which the list has to be walked
+	bool Walking;  // execution Tick+1 is in progress
+	C4EffectTimer(): Tick(0), Due(0), Walking(false) {}
+	bool IsDue() const { return Tick+1 >= Due; }
+	void Skip() { ++Tick; } // execution without walking the list
+	int32_t Now() const { return Tick + Walking; } // tick at which a time set now is valid
+	void Schedule(int32_t iExecution) { if (iExecution < Due) Due = iExecution; }
+};
+
 // generic object effect
 class C4Effect: public C4PropListNumbered
 {
@@ -74,11 +90,14 @@ public:
 	C4ID idCommandTarget;     // ID of command target definition
 
 	int32_t iPriority;          // effect priority for sorting into effect list; -1 indicates a dead effect
-	int32_t iTime, iInterval;  // effect time; effect callback intervall
+	int32_t iInterval;          // effect callback intervall
 
 	C4Effect *pNext;        // next effect in linked list
 
 protected:
+	int32_t iTime, iTimeTick;   // effect time after iTimeTick executions of the effect list
+	C4EffectTimer *pTimer;      // timer of the effect list; NULL for loaded effects until their list is executed
+
 	// presearched callback functions for faster calling
 	C4AulFunc *pFnTimer;           // timer function Fx%sTimer
 	C4AulFunc *pFnStart, *pFnStop; // init/deinit-functions Fx%sStart, Fx%sStop
@@ -86,6 +105,7 @@ protected:
 	C4AulFunc *pFnDamage;          // callback when owned object gets damage
 
 	void AssignCallbackFunctions(); // resolve callback function names
+	void Schedule(); // make sure the effect list is walked when the timer fires next
 
 	C4Effect(C4Object * pForObj, C4String * szName, int32_t iPrio, int32_t iTimerInterval, C4Object * pCmdTarget, C4ID idCmdTarget, const C4Value &rVal1, const C4Value &rVal2, const C4Value &rVal3, const C4Value &rVal4);
 	C4Effect(const C4Effect &); // unimplemented, do not use
@@ -99,12 +119,16 @@ public:
 	void Denumerate(C4ValueNumbers *); // numbers to object pointers
 	void ClearPointers(C4Object *pObj); // clear all pointers to object - may kill some effects w/o callback, because the callback target is lost
 
-	void SetDead() { iPriority=0; }      // mark effect to be removed in next execution cycle
+	void SetDead() { iPriority=0; if (pTimer) pTimer->Schedule(pTimer->Tick+1); } // mark effect to be removed in next execution cycle
 	bool IsDead() { return !iPriority; } // return whether effect is to be removed
 	void FlipActive() { iPriority*=-1; } // alters activation status
 	bool IsActive() { return iPriority>0; } // returns whether effect is active
 	bool IsInactiveAndNotDead() { return iPriority<0; } // as the name says
 
+	int32_t GetTime() const { return pTimer ? iTime + std::max(pTimer->Tick - iTimeTick, 0) : iTime; }
+	void SetTime(int32_t iToTime);
+	void SetInterval(int32_t iToInterval);
+
 	C4Effect *Get(const char *szName, int32_t iIndex=0, int32_t iMaxPriority=0);  // get effect by name
 	int32_t GetCount(const char *szMask, int32_t iMaxPriority=0); // count effects that match the mask
 	C4Effect *Check(C4Object *pForObj, const char *szCheckEffect, int32_t iPrio, int32_t iTimer, const C4Value &rVal1, const C4Value &rVal2, const C4Value &rVal3, const C4Value &rVal4); // do some effect callbacks
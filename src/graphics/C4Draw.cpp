@@ -28,7 +28,7 @@
 #include "C4Rect.h"
 #include <C4Config.h>
 #include "StdMesh.h"
-#include <CSurface8.h>
+#include <C4TiledSurface8.h>
 
 #include <stdio.h>
 
@@ -184,10 +184,15 @@ void C4Draw::Default()
 	ZoomX = 0; ZoomY = 0; Zoom = 1;
 	MeshTransform = NULL;
 	fUsePerspective = false;
+	BatchDepth = 0;
+	BatchVertices.clear();
+	DrawCalls = LastFrameDrawCalls = 0;
 }
 
 void C4Draw::Clear()
 {
+	BatchDepth = 0;
+	BatchVertices.clear();
 	ResetGamma();
 	Active=BlitModulated=false;
 	dwBlitMode = 0;
@@ -221,6 +226,8 @@ bool C4Draw::RestorePrimaryClipper()
 
 bool C4Draw::SetPrimaryClipper(int iX1, int iY1, int iX2, int iY2)
 {
+	// pending blits were clipped to the old rect
+	FlushBatch();
 	// set clipper
 	fClipX1=iX1; fClipY1=iY1; fClipX2=iX2; fClipY2=iY2;
 	iClipX1=iX1; iClipY1=iY1; iClipX2=iX2; iClipY2=iY2;
@@ -253,7 +260,7 @@ void C4Draw::BlitLandscape(C4Surface * sfcSource, float fx, float fy,
 	Blit(sfcSource, fx, fy, wdt, hgt, sfcTarget, tx, ty, wdt, hgt, false);
 }
 
-void C4Draw::Blit8Fast(CSurface8 * sfcSource, int fx, int fy,
+void C4Draw::Blit8Fast(C4TiledSurface8 * sfcSource, int fx, int fy,
                           C4Surface * sfcTarget, int tx, int ty, int wdt, int hgt)
 {
 	// blit 8bit-sfc
@@ -434,13 +441,53 @@ bool C4Draw::BlitUnscaled(C4Surface * sfcSource, float fx, float fy, float fwdt,
 
 			// ClrByOwner is always fully opaque
 			const DWORD dwOverlayClrMod = 0xff000000 | sfcSource->ClrByOwnerClr;
-			PerformMultiTris(sfcTarget, vertices, 6, pTransform, pBaseTex, fBaseSfc ? pTex : NULL, pNormalTex, dwOverlayClrMod, NULL);
+			if (BatchDepth && !pTransform)
+			{
+				// append to the pending batch if it is drawn with the same state
+				BatchState State = { sfcTarget, pBaseTex, fBaseSfc ? pTex : NULL, pNormalTex, dwOverlayClrMod,
+				                     BlitModulated, BlitModulateClr, dwBlitMode, pFoW, ZoomX, ZoomY, Zoom };
+				if (!BatchVertices.empty() && !(State == Batch)) FlushBatch();
+				Batch = State;
+				BatchVertices.insert(BatchVertices.end(), vertices, vertices + 6);
+			}
+			else
+				PerformMultiTris(sfcTarget, vertices, 6, pTransform, pBaseTex, fBaseSfc ? pTex : NULL, pNormalTex, dwOverlayClrMod, NULL);
 		}
 	}
 	// success
 	return true;
 }
 
+bool C4Draw::BatchState::operator==(const BatchState &r) const
+{
+	return pTarget == r.pTarget && pTex == r.pTex && pOverlay == r.pOverlay && pNormal == r.pNormal
+	       && dwOverlayClrMod == r.dwOverlayClrMod && BlitModulated == r.BlitModulated
+	       && (!BlitModulated || BlitModulateClr == r.BlitModulateClr) && dwBlitMode == r.dwBlitMode
+	       && pFoW == r.pFoW && ZoomX == r.ZoomX && ZoomY == r.ZoomY && Zoom == r.Zoom;
+}
+
+void C4Draw::FlushBatch()
+{
+	if (BatchVertices.empty()) return;
+	// take the vertices out first: the device flushes again before drawing
+	BatchDrawn.swap(BatchVertices);
+	// draw with the blit state the vertices were collected under
+	const bool fWasModulated = BlitModulated; const DWORD dwWasModulateClr = BlitModulateClr;
+	const DWORD dwWasBlitMode = dwBlitMode;
+	const C4FoWRegion *pWasFoW = pFoW;
+	const float fWasZoomX = ZoomX, fWasZoomY = ZoomY, fWasZoom = Zoom;
+	BlitModulated = Batch.BlitModulated; BlitModulateClr = Batch.BlitModulateClr;
+	dwBlitMode = Batch.dwBlitMode;
+	pFoW = Batch.pFoW;
+	ZoomX = Batch.ZoomX; ZoomY = Batch.ZoomY; Zoom = Batch.Zoom;
+	PerformMultiTris(Batch.pTarget, &BatchDrawn[0], BatchDrawn.size(), NULL, Batch.pTex, Batch.pOverlay, Batch.pNormal, Batch.dwOverlayClrMod, NULL);
+	BlitModulated = fWasModulated; BlitModulateClr = dwWasModulateClr;
+	dwBlitMode = dwWasBlitMode;
+	pFoW = pWasFoW;
+	ZoomX = fWasZoomX; ZoomY = fWasZoomY; Zoom = fWasZoom;
+	BatchDrawn.clear();
+}
+
 bool C4Draw::RenderMesh(StdMeshInstance &instance, C4Surface * sfcTarget, float tx, float ty, float twdt, float thgt, DWORD dwPlayerColor, C4BltTransform* pTransform)
 {
 	// TODO: Emulate rendering
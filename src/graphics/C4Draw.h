@@ -122,6 +122,7 @@ struct ZoomData
 };
 
 class C4FoWRegion;
+class C4TiledSurface8;
 
 // Shader combinations
 static const int C4SSC_MOD2 = 1; // signed addition instead of multiplication for clrMod
@@ -136,7 +137,7 @@ class C4Draw
 public:
 	enum DrawOperation { OP_POINTS, OP_TRIANGLES };
 
-	C4Draw(): MaxTexSize(0) { }
+	C4Draw(): MaxTexSize(0), BatchDepth(0), DrawCalls(0), LastFrameDrawCalls(0) { }
 	virtual ~C4Draw() { pDraw=NULL; }
 public:
 	C4AbstractApp * pApp; // the application
@@ -159,8 +160,26 @@ protected:
 	float ZoomX; float ZoomY;
 	const StdMeshMatrix* MeshTransform; // Transformation to apply to mesh before rendering
 	bool fUsePerspective;
+	// sprite batching: consecutive blits with equal state are collected and drawn at once
+	struct BatchState
+	{
+		C4Surface *pTarget;
+		C4TexRef *pTex, *pOverlay, *pNormal;
+		DWORD dwOverlayClrMod;
+		bool BlitModulated; DWORD BlitModulateClr;
+		DWORD dwBlitMode;
+		const C4FoWRegion *pFoW;
+		float ZoomX, ZoomY, Zoom;
+		bool operator==(const BatchState &r) const;
+	};
+	int32_t BatchDepth;                      // BeginBatch nesting
+	BatchState Batch;                        // state of the pending vertices
+	std::vector<C4BltVertex> BatchVertices;  // pending vertices
+	std::vector<C4BltVertex> BatchDrawn;     // vertices being drawn by FlushBatch
 public:
 	float Zoom;
+	uint32_t DrawCalls;         // draw calls issued to the device this frame
+	uint32_t LastFrameDrawCalls; // draw calls of the previous frame
 	// General
 	bool Init(C4AbstractApp * pApp, unsigned int iXRes, unsigned int iYRes, int iBitDepth, unsigned int iMonitor);
 	virtual void Clear();
@@ -190,7 +209,7 @@ public:
 	// Blit
 	virtual void BlitLandscape(C4Surface * sfcSource, float fx, float fy,
 	                           C4Surface * sfcTarget, float tx, float ty, float wdt, float hgt);
-	void Blit8Fast(CSurface8 * sfcSource, int fx, int fy,
+	void Blit8Fast(C4TiledSurface8 * sfcSource, int fx, int fy,
 	               C4Surface * sfcTarget, int tx, int ty, int wdt, int hgt);
 	bool Blit(C4Surface * sfcSource, float fx, float fy, float fwdt, float fhgt,
 	          C4Surface * sfcTarget, float tx, float ty, float twdt, float thgt,
@@ -209,6 +228,11 @@ public:
 	bool BlitSurface(C4Surface * sfcSurface, C4Surface * sfcTarget, int tx, int ty, bool fBlitBase);
 	bool BlitSurfaceTile(C4Surface * sfcSurface, C4Surface * sfcTarget, float iToX, float iToY, float iToWdt, float iToHgt, float iOffsetX, float iOffsetY, C4ShaderCall* shader_call);
 	virtual void FillBG(DWORD dwClr=0) = 0;
+	// batching of untransformed blits; must be flushed before other drawing changes device state
+	void BeginBatch() { ++BatchDepth; }
+	void EndBatch() { if (!--BatchDepth) FlushBatch(); }
+	void FlushBatch();
+	void NewFrame() { LastFrameDrawCalls = DrawCalls; DrawCalls = 0; }
 	// Text
 	enum { DEFAULT_MESSAGE_COLOR = 0xffffffff };
 	bool TextOut(const char *szText, CStdFont &rFont, float fZoom, C4Surface * sfcDest, float iTx, float iTy, DWORD dwFCol=0xffffffff, BYTE byForm=ALeft, bool fDoMarkup=true);
@@ -152,6 +152,7 @@ void CStdGL::Clear()
 void CStdGL::FillBG(DWORD dwClr)
 {
 	if (!pCurrCtx) return;
+	FlushBatch();
 	glClearColor((float)GetRedValue(dwClr)/255.0f, (float)GetGreenValue(dwClr)/255.0f, (float)GetBlueValue(dwClr)/255.0f, 0.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -188,6 +189,8 @@ bool CStdGL::PrepareRendering(C4Surface * sfcToSurface)
 	// target is already set as render target?
 	if (sfcToSurface != RenderTarget)
 	{
+		// pending blits go to the old target
+		FlushBatch();
 		// target is a render-target?
 		if (!sfcToSurface->IsRenderTarget()) return false;
 		// context
@@ -487,6 +490,7 @@ void CStdGL::SetupMultiBlt(C4ShaderCall& call, const C4BltTransform* pTransform,
 
 void CStdGL::PerformMultiPix(C4Surface* sfcTarget, const C4BltVertex* vertices, unsigned int n_vertices, C4ShaderCall* shader_call)
 {
+	FlushBatch();
 	// Draw on pixel center:
 	StdProjectionMatrix transform = StdProjectionMatrix::Translate(0.5f, 0.5f, 0.0f);
 
@@ -514,6 +518,7 @@ void CStdGL::PerformMultiPix(C4Surface* sfcTarget, const C4BltVertex* vertices,
 
 void CStdGL::PerformMultiLines(C4Surface* sfcTarget, const C4BltVertex* vertices, unsigned int n_vertices, float width, C4ShaderCall* shader_call)
 {
+	FlushBatch();
 	// In a first step, we transform the lines array to a triangle array, so that we can draw
 	// the lines with some thickness.
 	// In principle, this step could be easily (and probably much more efficiently) performed
@@ -574,6 +579,8 @@ void CStdGL::PerformMultiLines(C4Surface* sfcTarget, const C4BltVertex* vertices
 
 void CStdGL::PerformMultiTris(C4Surface* sfcTarget, const C4BltVertex* vertices, unsigned int n_vertices, const C4BltTransform* pTransform, C4TexRef* pTex, C4TexRef* pOverlay, C4TexRef* pNormal, DWORD dwOverlayModClr, C4ShaderCall* shader_call)
 {
+	// a pending batch must be drawn first to keep the order
+	FlushBatch();
 	// Feed the vertices to the GL
 	if (!shader_call)
 	{
@@ -636,6 +643,7 @@ void CStdGL::PerformMultiBlt(C4Surface* sfcTarget, DrawOperation op, const C4Blt
 			glVertexAttribPointer(texcoord, 2, GL_FLOAT, GL_FALSE, sizeof(C4BltVertex), reinterpret_cast<const uint8_t*>(offsetof(C4BltVertex, tx)));
 	}
 
+	++DrawCalls;
 	switch (op)
 	{
 	case OP_POINTS:
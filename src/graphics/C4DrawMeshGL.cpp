@@ -846,6 +846,7 @@ namespace
 			size_t vertex_count = 3 * instance.GetNumFaces();
 			assert (vertex_buffer_offset % sizeof(StdMeshVertex) == 0);
 			size_t base_vertex = vertex_buffer_offset / sizeof(StdMeshVertex);
+			++pDraw->DrawCalls;
 			glDrawElementsBaseVertex(GL_TRIANGLES, vertex_count, GL_UNSIGNED_INT, reinterpret_cast<void*>(index_buffer_offset), base_vertex);
 			glBindVertexArray(0);
 			call.Finish();
@@ -911,6 +912,9 @@ void CStdGL::PerformMesh(StdMeshInstance &instance, float tx, float ty, float tw
 	static const float FOV = 60.0f;
 	static const float TAN_FOV = tan(FOV / 2.0f / 180.0f * M_PI);
 
+	// a pending sprite batch must be drawn first to keep the order
+	FlushBatch();
+
 	// Check mesh transformation; abort when it is degenerate.
 	bool mesh_transform_parity = false;
 	if (MeshTransform)
@@ -34,7 +34,7 @@ public:
 	virtual bool PrepareRendering(C4Surface *) { return true; }
 	virtual bool PrepareSpriteShader(C4Shader& shader, const char* name, int ssc, C4GroupSet* pGroups, const char* const* additionalDefines, const char* const* additionalSlices) { return true; }
 	virtual void FillBG(DWORD dwClr=0) { }
-	virtual void PerformMesh(StdMeshInstance &, float, float, float, float, DWORD, C4BltTransform* pTransform) { }
+	virtual void PerformMesh(StdMeshInstance &, float, float, float, float, DWORD, C4BltTransform* pTransform) { FlushBatch(); ++DrawCalls; }
 	virtual void PerformLine(C4Surface *, float, float, float, float, DWORD, float) { }
 	virtual void PerformPix(C4Surface *, float, float, DWORD) { }
 	virtual bool InitDeviceObjects() { return true; }
@@ -45,9 +45,9 @@ public:
 	virtual bool CreatePrimarySurfaces(unsigned int, unsigned int, int, unsigned int);
 	virtual bool SetOutputAdapter(unsigned int) { return true; }
 
-	virtual void PerformMultiPix(C4Surface *, const C4BltVertex *, unsigned int, C4ShaderCall*) {}
-	virtual void PerformMultiLines(C4Surface *, const C4BltVertex *, unsigned int, float, C4ShaderCall*) {}
-	virtual void PerformMultiTris(C4Surface *, const C4BltVertex *, unsigned int, const C4BltTransform *, C4TexRef *, C4TexRef *, C4TexRef *, DWORD, C4ShaderCall*) {}
+	virtual void PerformMultiPix(C4Surface *, const C4BltVertex *, unsigned int, C4ShaderCall*) { FlushBatch(); ++DrawCalls; }
+	virtual void PerformMultiLines(C4Surface *, const C4BltVertex *, unsigned int, float, C4ShaderCall*) { FlushBatch(); ++DrawCalls; }
+	virtual void PerformMultiTris(C4Surface *, const C4BltVertex *, unsigned int, const C4BltTransform *, C4TexRef *, C4TexRef *, C4TexRef *, DWORD, C4ShaderCall*) { FlushBatch(); ++DrawCalls; }
 };
 
 #endif
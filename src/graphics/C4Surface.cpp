@@ -311,6 +311,16 @@ bool C4Surface::CreateColorByOwner(C4Surface *pBySurface)
 	// safety
 	if (!pBySurface) return false;
 	if (pBySurface->textures.empty()) return false;
+#ifdef USE_HEADLESS
+	// headless server: no pixels to separate
+	if (pBySurface->textures[0].iFlags & C4SF_Unlocked)
+	{
+		if (!Create(pBySurface->Wdt, pBySurface->Hgt, C4SF_Unlocked)) return false;
+		Scale = pBySurface->Scale;
+		pMainSfc=pBySurface;
+		return true;
+	}
+#endif
 	// create in same size
 	if (!Create(pBySurface->Wdt, pBySurface->Hgt)) return false;
 	// copy scale
@@ -51,6 +51,7 @@ extern CStdGL *pGL;
 const int C4SF_Tileable = 1;
 const int C4SF_MipMap   = 2;
 const int C4SF_Unlocked = 4;
+const int C4SF_Pixels   = 8; // keep the pixels on a headless server, because synchronized code reads them
 
 class C4Surface
 {
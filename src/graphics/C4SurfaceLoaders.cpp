@@ -149,6 +149,21 @@ bool C4Surface::Read(CStdStream &hGroup, const char * extension, int iFlags)
 
 bool C4Surface::ReadPNG(CStdStream &hGroup, int iFlags)
 {
+#ifdef USE_HEADLESS
+	// A headless server draws nothing, so unless synchronized code reads the
+	// pixels, get the size from the image header and don't decode anything
+	if (!(iFlags & C4SF_Pixels))
+	{
+		size_t size=hGroup.AccessedEntrySize();
+		std::vector<unsigned char> Data(size);
+		if (size < 24 || !hGroup.Read(&Data[0], size)) return false;
+		if (memcmp(&Data[0], "\x89PNG\r\n\x1a\n", 8) || memcmp(&Data[12], "IHDR", 4)) return false;
+		int iWdt = (Data[16] << 24) | (Data[17] << 16) | (Data[18] << 8) | Data[19];
+		int iHgt = (Data[20] << 24) | (Data[21] << 16) | (Data[22] << 8) | Data[23];
+		if (iWdt <= 0 || iHgt <= 0) return false;
+		return Create(iWdt, iHgt, iFlags | C4SF_Unlocked);
+	}
+#endif
 	// create mem block
 	int iSize=hGroup.AccessedEntrySize();
 	BYTE *pData=new BYTE[iSize];
@@ -375,10 +390,28 @@ bool C4Surface::ReadJPEG(CStdStream &hGroup, int iFlags)
 
 #else // ifndef USE_CONSOLE
 
-bool C4Surface::ReadJPEG(CStdStream &, int) {
-	// Dummy surface
-	if (!Create(1, 1)) return false;
-	return true;
+bool C4Surface::ReadJPEG(CStdStream &hGroup, int)
+{
+	// No decoder here, but the size of a texture is needed for its material
+	// shape, which shapes the landscape. Find it in the frame header.
+	size_t size=hGroup.AccessedEntrySize();
+	std::vector<unsigned char> Data(size);
+	if (!size || !hGroup.Read(&Data[0], size)) return false;
+	size_t i = 2;
+	while (i + 9 <= size && Data[i] == 0xff)
+	{
+		unsigned char Marker = Data[i + 1];
+		if (Marker >= 0xc0 && Marker <= 0xcf && Marker != 0xc4 && Marker != 0xc8 && Marker != 0xcc)
+		{
+			// Dummy surface of the right size, but without pixels
+			Clear(); Default();
+			Hgt = (Data[i + 5] << 8) | Data[i + 6];
+			Wdt = (Data[i + 7] << 8) | Data[i + 8];
+			return Wdt && Hgt;
+		}
+		i += 2 + ((Data[i + 2] << 8) | Data[i + 3]);
+	}
+	return false;
 }
 
 #endif // USE_CONSOLE
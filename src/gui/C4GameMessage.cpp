@@ -383,6 +383,11 @@ bool C4GameMessageList::New(int32_t iType, const StdStrBuf & sText, C4Object *pT
 	// Empty message? (only deleting old message)
 	if (!sText.getLength()) return true;
 
+#ifdef USE_HEADLESS
+	// nobody reads messages on a dedicated server
+	return true;
+#endif
+
 	// Add new message
 	C4GameMessage *msgNew = new C4GameMessage;
 	msgNew->Init(iType, sText,pTarget,iPlayer,iX,iY,dwClr, idDecoID, pSrc, dwFlags, width);
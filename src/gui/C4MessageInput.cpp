@@ -30,6 +30,13 @@
 #include <C4PlayerList.h>
 #include <C4GameControl.h>
 #include <C4GraphicsResource.h>
+#include <C4Landscape.h>
+#include <C4Profiler.h>
+#include <C4ObjectCost.h>
+#include <C4GameObjects.h>
+#include <C4Particles.h>
+#include <C4DefList.h>
+#include <C4FoW.h>
 
 // --------------------------------------------------
 // C4ChatInputDialog
@@ -762,6 +769,122 @@ bool C4MessageInput::ProcessCommand(const char *szCommand)
 		if (SEqual(szCmdName, "chart"))
 			return Game.ToggleChart();
 
+	// compare pathfinder query times (local only, does not affect the game)
+	if (SEqual(szCmdName, "pathbench"))
+	{
+		if (!Game.IsRunning) return false;
+		int32_t iQueries = atoi(pCmdPar);
+		Game.PathFinder.Benchmark(iQueries > 0 ? iQueries : 100);
+		return true;
+	}
+
+	// compare flat and tiled landscape storage (local only, does not affect the game)
+	if (SEqual(szCmdName, "lsbench"))
+	{
+		int32_t iSize = atoi(pCmdPar);
+		::Landscape.Benchmark(pCmdPar && *pCmdPar ? iSize : 8192);
+		return true;
+	}
+
+	// evaluate the animations of all meshes without drawing them (local only, does not affect the game)
+	if (SEqual(szCmdName, "meshbench"))
+	{
+		int32_t iInstances = atoi(pCmdPar);
+		::Definitions.BenchmarkMeshAnimation(iInstances > 0 ? iInstances : 20);
+		return true;
+	}
+
+#ifndef USE_CONSOLE
+	// compare serial and parallel particle calculation (local only, does not affect the game)
+	if (SEqual(szCmdName, "particlebench"))
+	{
+		int32_t iCount = atoi(pCmdPar);
+		::Particles.Benchmark(iCount > 0 ? iCount : 100000);
+		return true;
+	}
+
+	// compare light updates (local only, does not affect the game)
+	if (SEqual(szCmdName, "fowbench"))
+	{
+		if (!::Landscape.pFoW) { Log("FoW benchmark: fog of war is off"); return false; }
+		int32_t iCount = atoi(pCmdPar);
+		::Landscape.pFoW->Benchmark(iCount > 0 ? iCount : 500);
+		return true;
+	}
+#endif
+
+	// draw calls of the last frame (local only)
+	if (SEqual(szCmdName, "drawcalls"))
+	{
+		LogF("Draw calls last frame: %u", (unsigned int) pDraw->LastFrameDrawCalls);
+		return true;
+	}
+
+	// frame profiler (local only): /profile on|off|save [file]|slow [count]
+	if (SEqual(szCmdName, "profile"))
+	{
+		char szSubCmd[20+1]; SCopyUntil(pCmdPar, szSubCmd, ' ', 20);
+		const char *szArg = SSearch(pCmdPar, " ");
+		if (SEqual(szSubCmd, "on") || SEqual(szSubCmd, "off"))
+		{
+			Profiler.Enable(szSubCmd[1] == 'n');
+			LogF("Profiler %s", C4Profiler::Enabled ? "on" : "off");
+			return true;
+		}
+		if (SEqual(szSubCmd, "save"))
+		{
+			const char *szFilename = szArg && *szArg ? szArg : Config.AtUserDataPath("Profile.json");
+			if (!Profiler.SaveTrace(szFilename)) { LogF("Could not write %s", szFilename); return false; }
+			LogF("Profile saved to %s", szFilename);
+			return true;
+		}
+		if (SEqual(szSubCmd, "slow"))
+		{
+			Profiler.LogSlowestFrames(szArg ? std::max(atoi(szArg), 1) : 5);
+			return true;
+		}
+		return false;
+	}
+
+	// CPU cost per definition and object (local only): /cost on [dump interval]|off|show [count]|reset
+	if (SEqual(szCmdName, "cost"))
+	{
+		char szSubCmd[20+1]; SCopyUntil(pCmdPar, szSubCmd, ' ', 20);
+		const char *szArg = SSearch(pCmdPar, " ");
+		if (SEqual(szSubCmd, "on") || SEqual(szSubCmd, "off"))
+		{
+			ObjectCost.Enable(szSubCmd[1] == 'n', szArg ? atoi(szArg) : 0);
+			LogF("Cost accounting %s", C4ObjectCost::Enabled ? "on" : "off");
+			return true;
+		}
+		if (!C4ObjectCost::Enabled) return false;
+		if (SEqual(szSubCmd, "show"))
+		{
+			ObjectCost.Log(szArg ? std::max(atoi(szArg), 1) : 10);
+			return true;
+		}
+		if (SEqual(szSubCmd, "reset"))
+		{
+			ObjectCost.Reset();
+			return true;
+		}
+		return false;
+	}
+
+	// script allocations of the last frame (local only)
+	if (SEqual(szCmdName, "scriptmem"))
+	{
+		ScriptPool.Log();
+		return true;
+	}
+
+	// sleeping objects of the last frame (local only)
+	if (SEqual(szCmdName, "sleep"))
+	{
+		LogF("Objects last frame: %d awake, %d asleep", (int) ::Objects.AwakeCount, (int) ::Objects.SleepingCount);
+		return true;
+	}
+
 	// whole map screenshot
 	if (SEqual(szCmdName, "screenshot"))
 	{
@@ -38,6 +38,7 @@
 #include <C4Application.h>
 #include <C4Log.h>
 #include <C4Stat.h>
+#include <C4Profiler.h>
 #include <C4MassMover.h>
 #include <C4PXS.h>
 #include <C4Weather.h>
@@ -54,6 +55,8 @@
 #include <C4GameObjects.h>
 #include <C4MapScript.h>
 
+#include <chrono>
+
 namespace
 {
 	bool ForLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
@@ -127,7 +130,10 @@ void C4Landscape::Execute()
 {
 	// Landscape scan
 	if (!NoScan)
+	{
+		C4PROFILE_ZONE("C4Landscape::ExecuteScan");
 		ExecuteScan();
+	}
 	// move sky
 	Sky.Execute();
 
@@ -135,7 +141,10 @@ void C4Landscape::Execute()
 	// this just makes sure relights don't accumulate over a long period of time if no
 	// viewport is open (developer mode).
 	if (!::Game.iTick35)
+	{
+		C4PROFILE_ZONE("C4Landscape::DoRelights");
 		DoRelights();
+	}
 }
 
 
@@ -785,6 +794,9 @@ bool C4Landscape::_SetPix2(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
 	// set 8bpp-surface only!
 	Surface8->SetPix(x, y, fgPix);
 	Surface8Bkg->SetPix(x, y, bgPix);
+	// update pathfinder graph
+	if (DensitySolid(Pix2Dens[fgPix]) != DensitySolid(Pix2Dens[opix]))
+		::Game.PathFinder.Invalidate(C4Rect(x, y, 1, 1));
 	// note for relight
 	if(pLandscapeRender)
 	{
@@ -807,6 +819,8 @@ void C4Landscape::_SetPix2Tmp(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
 {
 	// set 8bpp-surface only!
 	assert(x >= 0 && y >= 0 && x < Width && y < Height);
+	if (fgPix != Transparent && DensitySolid(Pix2Dens[fgPix]) != DensitySolid(Pix2Dens[_GetPix(x, y)]))
+		::Game.PathFinder.Invalidate(C4Rect(x, y, 1, 1));
 	if (fgPix != Transparent) Surface8->SetPix(x, y, fgPix);
 	if (bgPix != Transparent) Surface8Bkg->SetPix(x, y, bgPix);
 }
@@ -850,11 +864,39 @@ void C4Landscape::CheckInstabilityRange(int32_t tx, int32_t ty)
 }
 void C4Landscape::DrawMaterialRect(int32_t mat, int32_t tx, int32_t ty, int32_t wdt, int32_t hgt)
 {
-	int32_t cx,cy;
-	for (cy=ty; cy<ty+hgt; cy++)
-		for (cx=tx; cx<tx+wdt; cx++)
-			if ( (MatDensity(mat)>=GetDensity(cx,cy)))
-				SetPix2(cx,cy,Mat2PixColDefault(mat), Surface8Bkg->GetPix(cx, cy));
+	if (!MatValid(mat)) return;
+	// Same as bridging: replace all pixels of lower or equal density
+	uint8_t *conversion_table = GetBridgeMatConversion(Mat2PixColDefault(mat));
+	if (!conversion_table) return;
+	C4Rect BoundingBox(tx, ty, wdt, hgt);
+	BoundingBox.Intersect(C4Rect(0, 0, Width, Height));
+	if (!BoundingBox.Wdt || !BoundingBox.Hgt) return;
+	PrepareChange(BoundingBox);
+	for (int32_t cy=BoundingBox.y; cy<BoundingBox.y+BoundingBox.Hgt; cy++)
+		Surface8->ConvertSpan(BoundingBox.x, BoundingBox.x+BoundingBox.Wdt, cy, conversion_table);
+	FinishChange(BoundingBox);
+}
+
+void C4Landscape::ClearRectDensity(int32_t iTx, int32_t iTy, int32_t iWdt, int32_t iHgt, int32_t iOfDensity)
+{
+	C4Rect BoundingBox(iTx, iTy, iWdt, iHgt);
+	BoundingBox.Intersect(C4Rect(0, 0, Width, Height));
+	if (!BoundingBox.Wdt || !BoundingBox.Hgt) return;
+	PrepareChange(BoundingBox);
+	// Replace pixels of the given density or above by the background pixel
+	for (int32_t cy=BoundingBox.y; cy<BoundingBox.y+BoundingBox.Hgt; cy++)
+		for (int32_t cx=BoundingBox.x, iLen; cx<BoundingBox.x+BoundingBox.Wdt; cx+=iLen)
+		{
+			const BYTE *pSpan = Surface8->GetSpan(cx, cy, iLen);
+			iLen = std::min(iLen, BoundingBox.x+BoundingBox.Wdt-cx);
+			// Skip spans without any such pixel before touching the tile
+			int32_t i = 0;
+			while (i < iLen && Pix2Dens[pSpan[i]] < iOfDensity) ++i;
+			for (; i < iLen; ++i)
+				if (Pix2Dens[Surface8->_GetPix(cx+i, cy)] >= iOfDensity)
+					Surface8->_SetPix(cx+i, cy, Surface8Bkg->_GetPix(cx+i, cy));
+		}
+	FinishChange(BoundingBox);
 }
 
 void C4Landscape::RaiseTerrain(int32_t tx, int32_t ty, int32_t wdt)
@@ -1202,18 +1244,15 @@ int32_t C4Landscape::ForPolygon(int *vtcs, int length, bool (C4Landscape::*fnCal
 				}
 			}
 			else if (conversion_table)
-				for (int xcnt=x2-x1-1; xcnt>=0; xcnt--)
-				{
-					const uint8_t pix = conversion_table[uint8_t(GetPix(x1+xcnt, y))];
-					Surface8->SetPix(x1+xcnt, y, pix);
-					if (colBkg != Transparent) Surface8Bkg->SetPix(x1+xcnt, y, colBkg);
-				}
+			{
+				Surface8->ConvertSpan(x1, x2, y, conversion_table);
+				if (colBkg != Transparent) Surface8Bkg->FillSpan(x1, x2, y, colBkg);
+			}
 			else
-				for (int xcnt=x2-x1-1; xcnt>=0; xcnt--)
-				{
-					if (col != Transparent) Surface8->SetPix(x1+xcnt, y, col);
-					if (colBkg != Transparent) Surface8Bkg->SetPix(x1+xcnt, y, colBkg);
-				}
+			{
+				if (col != Transparent) Surface8->FillSpan(x1, x2, y, col);
+				if (colBkg != Transparent) Surface8Bkg->FillSpan(x1, x2, y, colBkg);
+			}
 			edge = edge->next->next;
 		}
 
@@ -1281,8 +1320,8 @@ void C4Landscape::Clear(bool fClearMapCreator, bool fClearSky, bool fClearRender
 	delete Map; Map=NULL;
 	delete MapBkg; MapBkg=NULL;
 	// clear initial landscape
-	delete [] pInitial; pInitial = NULL;
-	delete [] pInitialBkg; pInitialBkg = NULL;
+	delete pInitial; pInitial = NULL;
+	delete pInitialBkg; pInitialBkg = NULL;
 	delete pFoW; pFoW = NULL;
 	// clear relight array
 	for (int32_t i = 0; i < C4LS_MaxRelights; ++i)
@@ -1497,14 +1536,15 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 		assert(Surface8Bkg == NULL);
 
 		// Create landscape surface
-		Surface8 = new CSurface8();
+		Surface8 = new C4TiledSurface8();
 		if (!Surface8->Create(Width, Height))
 		{
 			delete Surface8; Surface8 = NULL;
 			return false;
 		}
+		UpdateDensityPlanes();
 
-		Surface8Bkg = new CSurface8();
+		Surface8Bkg = new C4TiledSurface8();
 		if (!Surface8Bkg->Create(Width, Height) || !Mat2Pal())
 		{
 			delete Surface8Bkg; Surface8Bkg = NULL;
@@ -1519,6 +1559,9 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 		bool map2landscape_success = MapToLandscape();
 		pLandscapeRender = lsrender_backup;
 		if (!map2landscape_success) return false;
+		// release tiles that came out uniform
+		Surface8->Compact();
+		Surface8Bkg->Compact();
 	}
 
 	// Init out-of-landscape pixels for bottom
@@ -1528,11 +1571,14 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 
 	if (Config.General.DebugRec)
 	{
+		std::vector<BYTE> Pixels(Width * Height);
 		AddDbgRec(RCT_Block, "|---LANDSCAPE---|", 18);
-		AddDbgRec(RCT_Map, Surface8->Bits, Surface8->Pitch*Surface8->Hgt);
+		Surface8->CopyTo(&Pixels[0]);
+		AddDbgRec(RCT_Map, &Pixels[0], Pixels.size());
 
 		AddDbgRec(RCT_Block, "|---LANDSCAPE BKG---|", 22);
-		AddDbgRec(RCT_Map, Surface8Bkg->Bits, Surface8Bkg->Pitch*Surface8Bkg->Hgt);
+		Surface8Bkg->CopyTo(&Pixels[0]);
+		AddDbgRec(RCT_Map, &Pixels[0], Pixels.size());
 	}
 
 	// Create FoW
@@ -1650,26 +1696,28 @@ bool C4Landscape::SaveDiffInternal(C4Group &hGroup, bool fSyncSave) const
 
 	// If it shouldn't be sync-save: Clear all bytes that have not changed, i.e.
 	// set them to C4M_MaxTexIndex
-	bool fChanged = false, fChangedBkg = false;;
-	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
-			{
-				if (pInitial[y * Width + x] == Surface8->_GetPix(x, y))
-					Surface8->SetPix(x,y,C4M_MaxTexIndex);
-				else
-					fChanged = true;
+	// The diff is built in separate flat surfaces, so the tiles stay shared
+	CSurface8 sfcDiff(Width, Height), sfcDiffBkg(Width, Height);
+	bool fChanged = false, fChangedBkg = false;
+	for (int y = 0; y < Height; y++)
+		for (int x = 0; x < Width; x++)
+		{
+			BYTE byPix = Surface8->_GetPix(x, y), byPixBkg = Surface8Bkg->_GetPix(x, y);
+			if (!fSyncSave && pInitial->_GetPix(x, y) == byPix)
+				sfcDiff._SetPix(x, y, C4M_MaxTexIndex);
+			else
+				{ sfcDiff._SetPix(x, y, byPix); fChanged = true; }
 
-				if (pInitialBkg[y * Width + x] == Surface8Bkg->_GetPix(x, y))
-					Surface8Bkg->SetPix(x,y,C4M_MaxTexIndex);
-				else
-					fChangedBkg = true;
-			}
+			if (!fSyncSave && pInitialBkg->_GetPix(x, y) == byPixBkg)
+				sfcDiffBkg._SetPix(x, y, C4M_MaxTexIndex);
+			else
+				{ sfcDiffBkg._SetPix(x, y, byPixBkg); fChangedBkg = true; }
+		}
 
 	if (fSyncSave || fChanged)
 	{
 		// Save landscape surface
-		if (!Surface8->Save(Config.AtTempPath(C4CFN_TempLandscape)))
+		if (!sfcDiff.Save(Config.AtTempPath(C4CFN_TempLandscape), Surface8->pPal))
 			return false;
 
 		// Move temp file to group
@@ -1681,7 +1729,7 @@ bool C4Landscape::SaveDiffInternal(C4Group &hGroup, bool fSyncSave) const
 	if (fSyncSave || fChangedBkg)
 	{
 		// Save landscape surface
-		if (!Surface8Bkg->Save(Config.AtTempPath(C4CFN_TempLandscapeBkg)))
+		if (!sfcDiffBkg.Save(Config.AtTempPath(C4CFN_TempLandscapeBkg), Surface8Bkg->pPal))
 			return false;
 
 		// Move temp file to group
@@ -1690,17 +1738,6 @@ bool C4Landscape::SaveDiffInternal(C4Group &hGroup, bool fSyncSave) const
 			return false;
 	}
 
-	// Restore landscape pixels
-	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
-			{
-				if (Surface8->_GetPix(x, y) == C4M_MaxTexIndex)
-					Surface8->SetPix(x,y,pInitial[y * Width + x]);
-				if (Surface8Bkg->_GetPix(x, y) == C4M_MaxTexIndex)
-					Surface8Bkg->SetPix(x,y,pInitialBkg[y * Width + x]);
-			}
-
 	// Save changed map, too
 	if (fMapChanged && Map)
 		if (!SaveMap(hGroup)) return false;
@@ -1714,21 +1751,158 @@ bool C4Landscape::SaveDiffInternal(C4Group &hGroup, bool fSyncSave) const
 bool C4Landscape::SaveInitial()
 {
 
-	// Create array
-	delete [] pInitial;
-	delete [] pInitialBkg;
-	pInitial = new BYTE [Width * Height];
-	pInitialBkg = new BYTE [Width * Height];
+	// Copy surfaces; uniform tiles stay shared
+	delete pInitial;
+	delete pInitialBkg;
+	pInitial = new C4TiledSurface8();
+	pInitialBkg = new C4TiledSurface8();
+	return pInitial->Create(*Surface8) && pInitialBkg->Create(*Surface8Bkg);
+}
 
-	// Save material data
-	for (int y = 0; y < Height; y++)
-		for (int x = 0; x < Width; x++)
+namespace
+{
+	// Access benchmark for flat and tiled surfaces. Returns nanoseconds per pixel.
+	template<class TSurface> double BenchmarkPixelAccess(const TSurface &rSfc, const std::vector<int32_t> &rPoints, int32_t &iSum)
+	{
+		typedef std::chrono::steady_clock Clock;
+		Clock::time_point tStart = Clock::now();
+		for (size_t i = 0; i < rPoints.size(); i += 2)
+			iSum += rSfc._GetPix(rPoints[i], rPoints[i+1]);
+		return std::chrono::duration<double, std::nano>(Clock::now() - tStart).count() / (rPoints.size() / 2);
+	}
+
+	template<class TSurface> double BenchmarkRowScan(const TSurface &rSfc, int32_t &iSum)
+	{
+		typedef std::chrono::steady_clock Clock;
+		Clock::time_point tStart = Clock::now();
+		for (int32_t y = 0; y < rSfc.Hgt; ++y)
+			for (int32_t x = 0; x < rSfc.Wdt; ++x)
+				iSum += rSfc._GetPix(x, y);
+		return std::chrono::duration<double, std::nano>(Clock::now() - tStart).count() / (double(rSfc.Wdt) * rSfc.Hgt);
+	}
+}
+
+void C4Landscape::Benchmark(int32_t iSize)
+{
+	// Memory of the current landscape
+	if (Surface8 && Surface8Bkg)
+	{
+		size_t iTiled = Surface8->GetMemoryUsage() + Surface8Bkg->GetMemoryUsage(), iFlat = 2 * size_t(Width) * Height;
+		if (pInitial && pInitialBkg)
+			{ iTiled += pInitial->GetMemoryUsage() + pInitialBkg->GetMemoryUsage(); iFlat *= 2; }
+		LogF("Landscape storage: %dx%d, %d of %d tiles own data, %d KB tiled vs. %d KB flat", (int) Width, (int) Height,
+		     (int) (Surface8->GetOwnTileCount() + Surface8Bkg->GetOwnTileCount()), (int) (Surface8->GetTileCount() + Surface8Bkg->GetTileCount()),
+		     (int) (iTiled / 1024), (int) (iFlat / 1024));
+	}
+	// Generated map: sky above a hilly surface, earth with caves, rock at the bottom.
+	// Uses its own random numbers so the game is not affected.
+	if (iSize <= 0) return;
+	int32_t iWdt = iSize, iHgt = iSize / 2;
+	uint32_t iSeed = 12345;
+	auto fnRandom = [&iSeed](int32_t iRange) { iSeed = iSeed * 1103515245 + 12345; return int32_t((iSeed >> 8) % iRange); };
+	CSurface8 Flat(iWdt, iHgt);
+	std::vector<int32_t> Caves;
+	for (int32_t i = 0; i < iWdt * iHgt / 40000; ++i)
+		{ Caves.push_back(fnRandom(iWdt)); Caves.push_back(iHgt / 3 + fnRandom(iHgt / 2)); Caves.push_back(10 + fnRandom(40)); }
+	for (int32_t y = 0; y < iHgt; ++y)
+		for (int32_t x = 0; x < iWdt; ++x)
 		{
-			pInitial[y * Width + x] = Surface8->_GetPix(x, y);
-			pInitialBkg[y * Width + x] = Surface8Bkg->_GetPix(x, y);
+			BYTE byPix = 0;
+			int32_t iSurface = iHgt / 4 + (int32_t) (iHgt / 16 * sin(x / 200.0));
+			if (y > iHgt * 7 / 8) byPix = 2; // rock
+			else if (y > iSurface) byPix = (x + y) % 17 ? 1 : 3; // earth with some texture noise
+			Flat._SetPix(x, y, byPix);
 		}
-
-	return true;
+	for (size_t i = 0; i < Caves.size(); i += 3)
+		Flat.Circle(Caves[i], Caves[i+1], Caves[i+2], 0);
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point tStart = Clock::now();
+	C4TiledSurface8 Tiled;
+	Tiled.Create(Flat);
+	double tConvert = std::chrono::duration<double, std::milli>(Clock::now() - tStart).count();
+	// Random and sequential reads
+	std::vector<int32_t> Points;
+	for (int32_t i = 0; i < 1000000; ++i)
+		{ Points.push_back(fnRandom(iWdt)); Points.push_back(fnRandom(iHgt)); }
+	int32_t iSum = 0;
+	double tFlatRandom = BenchmarkPixelAccess(Flat, Points, iSum), tTiledRandom = BenchmarkPixelAccess(Tiled, Points, iSum);
+	double tFlatScan = BenchmarkRowScan(Flat, iSum), tTiledScan = BenchmarkRowScan(Tiled, iSum);
+	// Mark solid pixels in a plane, like the game does
+	BYTE Classes[256] = { 0 };
+	Classes[1] = Classes[2] = Classes[3] = 1 << C4LS_SolidPlane;
+	Tiled.SetPlaneClasses(Classes);
+	// Writes: dig tunnels through earth, which unshares tiles
+	tStart = Clock::now();
+	for (int32_t i = 0; i < 200; ++i)
+		Tiled.Circle(fnRandom(iWdt), iHgt / 4 + fnRandom(iHgt / 2), 20, 0);
+	double tDig = std::chrono::duration<double, std::milli>(Clock::now() - tStart).count();
+	// Sweeps as done by moving objects: pixel by pixel vs. the solid plane, which the digs kept up to date
+	std::vector<int32_t> Sweeps;
+	for (int32_t i = 0; i < 200000; ++i)
+	{
+		int32_t x = fnRandom(iWdt), y = fnRandom(iHgt), iDir = fnRandom(4), dx = iDir < 2 ? iDir * 2 - 1 : 0, dy = dx ? 0 : iDir * 2 - 5;
+		int32_t iLen = 1 + fnRandom(64);
+		iLen = std::min(iLen, dx > 0 ? iWdt - x : dx < 0 ? x + 1 : dy > 0 ? iHgt - y : y + 1);
+		Sweeps.push_back(x); Sweeps.push_back(y); Sweeps.push_back(dx); Sweeps.push_back(dy); Sweeps.push_back(iLen);
+	}
+	std::vector<int32_t> Runs(Sweeps.size() / 5);
+	tStart = Clock::now();
+	for (size_t i = 0; i < Sweeps.size(); i += 5)
+	{
+		int32_t iRun = 0;
+		while (iRun < Sweeps[i+4] && !Classes[Tiled._GetPix(Sweeps[i] + iRun * Sweeps[i+2], Sweeps[i+1] + iRun * Sweeps[i+3])]) ++iRun;
+		Runs[i / 5] = iRun;
+	}
+	double tSweepPixel = std::chrono::duration<double, std::nano>(Clock::now() - tStart).count() / Runs.size();
+	int32_t iMismatches = 0;
+	tStart = Clock::now();
+	for (size_t i = 0; i < Sweeps.size(); i += 5)
+		if (Tiled.GetPlaneRun(C4LS_SolidPlane, Sweeps[i], Sweeps[i+1], Sweeps[i+2], Sweeps[i+3], Sweeps[i+4]) != Runs[i / 5])
+			++iMismatches;
+	double tSweepPlane = std::chrono::duration<double, std::nano>(Clock::now() - tStart).count() / Runs.size();
+	// Region fills (material rects, explosions, polygons): pixel by pixel vs. row spans
+	std::vector<int32_t> Regions;
+	for (int32_t i = 0; i < 500; ++i)
+		{ Regions.push_back(fnRandom(iWdt)); Regions.push_back(fnRandom(iHgt)); Regions.push_back(8 + fnRandom(120)); }
+	uint8_t Conversion[256];
+	for (int32_t i = 0; i < 256; ++i) Conversion[i] = (i == 1 || i == 3) ? 4 : i; // earth to something else
+	double tRegionPixel = 0, tRegionSpan = 0;
+	for (int32_t iPass = 0; iPass < 2; ++iPass)
+	{
+		C4TiledSurface8 Work;
+		Work.Create(Tiled);
+		tStart = Clock::now();
+		for (size_t i = 0; i < Regions.size(); i += 3)
+		{
+			int32_t x = Regions[i], y = Regions[i+1], r = Regions[i+2];
+			int32_t x1 = std::max<int32_t>(x - r, 0), x2 = std::min<int32_t>(x + r, iWdt), y1 = std::max<int32_t>(y - r, 0), y2 = std::min<int32_t>(y + r, iHgt);
+			if (iPass == 0)
+			{
+				for (int32_t cy = y1; cy < y2; ++cy)
+					for (int32_t cx = x1; cx < x2; ++cx)
+						Work._SetPix(cx, cy, i % 2 ? Conversion[Work._GetPix(cx, cy)] : 5);
+				for (int32_t ycnt = -r; ycnt < r; ++ycnt)
+				{
+					int32_t lwdt = (int32_t) sqrt(float(r*r - ycnt*ycnt));
+					for (int32_t cx = x - lwdt; cx < x + lwdt; ++cx) Work.SetPix(cx, y + ycnt, 0);
+				}
+			}
+			else
+			{
+				for (int32_t cy = y1; cy < y2; ++cy)
+					if (i % 2) Work.ConvertSpan(x1, x2, cy, Conversion); else Work.FillSpan(x1, x2, cy, 5);
+				Work.Circle(x, y, r, 0);
+			}
+		}
+		(iPass ? tRegionSpan : tRegionPixel) = std::chrono::duration<double, std::milli>(Clock::now() - tStart).count();
+	}
+	LogF("Generated %dx%d map: %d of %d tiles own data, %d KB tiled vs. %d KB flat, converted in %.1f ms", (int) iWdt, (int) iHgt,
+	     Tiled.GetOwnTileCount(), Tiled.GetTileCount(), (int) (Tiled.GetMemoryUsage() / 1024), (int) (size_t(iWdt) * iHgt / 1024), tConvert);
+	LogF("  random read: %.2f ns flat, %.2f ns tiled", tFlatRandom, tTiledRandom);
+	LogF("  row scan:    %.2f ns flat, %.2f ns tiled", tFlatScan, tTiledScan);
+	LogF("  200 digs:    %.1f ms tiled, %d of %d tiles own data afterwards (checksum %d)", tDig, Tiled.GetOwnTileCount(), Tiled.GetTileCount(), (int) iSum);
+	LogF("  500 region fills: %.1f ms per pixel, %.1f ms per span", tRegionPixel, tRegionSpan);
+	LogF("  sweeps up to 64 px: %.1f ns per pixel, %.1f ns with the solid plane (%d mismatches)", tSweepPixel, tSweepPlane, (int) iMismatches);
 }
 
 bool C4Landscape::Load(C4Group &hGroup, bool fLoadSky, bool fSavegame)
@@ -1736,16 +1910,18 @@ bool C4Landscape::Load(C4Group &hGroup, bool fLoadSky, bool fSavegame)
 	assert(!Surface8 && !Surface8Bkg);
 
 	// Load exact landscape from group
-	if (!(Surface8=GroupReadSurface8(hGroup, C4CFN_Landscape)))
+	CSurface8 *sfcFg, *sfcBg;
+	if (!(sfcFg=GroupReadSurface8(hGroup, C4CFN_Landscape)))
 	{
-		if (!(Surface8=GroupReadSurface8(hGroup, C4CFN_LandscapeFg))) return false;
-		Surface8Bkg = GroupReadSurface8(hGroup, C4CFN_LandscapeBg);
+		if (!(sfcFg=GroupReadSurface8(hGroup, C4CFN_LandscapeFg))) return false;
+		sfcBg = GroupReadSurface8(hGroup, C4CFN_LandscapeBg);
 
-		if (Surface8Bkg)
+		if (sfcBg)
 		{
-			if ( (Surface8->Wdt != Surface8Bkg->Wdt || Surface8->Hgt != Surface8Bkg->Hgt))
+			if ( (sfcFg->Wdt != sfcBg->Wdt || sfcFg->Hgt != sfcBg->Hgt))
 			{
-				LogFatal(FormatString("Landscape has different dimensions than background landscape (%dx%d vs. %dx%d)", Surface8->Wdt, Surface8->Hgt, Surface8Bkg->Wdt, Surface8Bkg->Hgt).getData());
+				LogFatal(FormatString("Landscape has different dimensions than background landscape (%dx%d vs. %dx%d)", sfcFg->Wdt, sfcFg->Hgt, sfcBg->Wdt, sfcBg->Hgt).getData());
+				delete sfcFg; delete sfcBg;
 				return false;
 			}
 		}
@@ -1753,16 +1929,24 @@ bool C4Landscape::Load(C4Group &hGroup, bool fLoadSky, bool fSavegame)
 		{
 			// LandscapeFg.bmp loaded: Assume full 8bit mat-tex values
 			// when creating background surface.
-			Surface8Bkg = CreateDefaultBkgSurface(*Surface8, false);
+			sfcBg = CreateDefaultBkgSurface(*sfcFg, false);
 		}
 	}
 	else
 	{
 		// Landscape.bmp loaded: Assume msb is IFT flag when creating
 		// background surface.
-		Surface8Bkg = CreateDefaultBkgSurface(*Surface8, true);
+		sfcBg = CreateDefaultBkgSurface(*sfcFg, true);
 	}
 
+	// Convert to tiled storage
+	Surface8 = new C4TiledSurface8();
+	Surface8Bkg = new C4TiledSurface8();
+	bool fConverted = sfcBg && Surface8->Create(*sfcFg) && Surface8Bkg->Create(*sfcBg);
+	delete sfcFg; delete sfcBg;
+	if (!fConverted) return false;
+	UpdateDensityPlanes();
+
 	int iWidth, iHeight;
 	Surface8->GetSurfaceSize(iWidth,iHeight);
 	Width = iWidth; Height = iHeight;
@@ -2384,6 +2568,38 @@ bool C4Landscape::_PathFree(int32_t x, int32_t y, int32_t x2, int32_t y2) const
 	return !PixCnt[x * PixCntPitch + y];
 }
 
+int32_t C4Landscape::GetDensityRun(int32_t x, int32_t y, int32_t dx, int32_t dy, int32_t iMax, int32_t iDensity) const
+{
+	// the planes only know two densities; use the next lower one, which may stop the run early
+	int iPlane;
+	if (iDensity >= C4M_Solid) iPlane = C4LS_SolidPlane;
+	else if (iDensity >= C4M_Liquid) iPlane = C4LS_LiquidPlane;
+	else return 0;
+	if (!Surface8 || !Surface8->HasPlanes()) return 0;
+	// stop at the border
+	if (x < 0 || y < 0 || x >= Width || y >= Height) return 0;
+	if (dx) iMax = std::min<int32_t>(iMax, dx > 0 ? Width - x : x + 1);
+	else iMax = std::min<int32_t>(iMax, dy > 0 ? Height - y : y + 1);
+	return Surface8->GetPlaneRun(iPlane, x, y, dx, dy, iMax);
+}
+
+bool C4Landscape::GetDensityHash(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t &rHash) const
+{
+	if (!Surface8 || !Surface8->HasPlanes()) return false;
+	x1 = std::max<int32_t>(x1, 0); y1 = std::max<int32_t>(y1, 0);
+	x2 = std::min<int32_t>(x2 + 1, Width); y2 = std::min<int32_t>(y2 + 1, Height);
+	rHash = Surface8->GetPlaneHash(x1, y1, x2, y2);
+	return true;
+}
+
+uint64_t C4Landscape::GetDensityVersion(int32_t x1, int32_t y1, int32_t x2, int32_t y2) const
+{
+	if (!Surface8 || !Surface8->HasPlanes()) return 0;
+	x1 = std::max<int32_t>(x1, 0); y1 = std::max<int32_t>(y1, 0);
+	x2 = std::min<int32_t>(x2 + 1, Width); y2 = std::min<int32_t>(y2 + 1, Height);
+	return Surface8->GetPlaneVersion(x1, y1, x2, y2);
+}
+
 int32_t C4Landscape::GetMatHeight(int32_t x, int32_t y, int32_t iYDir, int32_t iMat, int32_t iMax) const
 {
 	if (iYDir > 0)
@@ -3582,6 +3798,8 @@ void C4Landscape::FinishChange(C4Rect BoundingBox)
 	}
 	C4SolidMask::CheckConsistency();
 	UpdatePixCnt(BoundingBox);
+	// update pathfinder graph
+	::Game.PathFinder.Invalidate(BoundingBox);
 	// update FoW
 	if (pFoW)
 	{
@@ -3827,7 +4045,19 @@ void C4Landscape::UpdatePixMaps()
 	{
 		delete [] BridgeMatConversion[i];
 		BridgeMatConversion[i] = NULL;
+	}	// densities may have changed
+	if (Surface8) UpdateDensityPlanes();
+}
+
+void C4Landscape::UpdateDensityPlanes()
+{
+	BYTE Classes[256] = { 0 };
+	for (int32_t i = 0; i < C4M_MaxTexIndex; i++)
+	{
+		if (Pix2Dens[i] >= C4M_Solid) Classes[i] |= 1 << C4LS_SolidPlane;
+		if (Pix2Dens[i] >= C4M_Liquid) Classes[i] |= 1 << C4LS_LiquidPlane;
 	}
+	Surface8->SetPlaneClasses(Classes);
 }
 
 bool C4Landscape::Mat2Pal()
@@ -3857,10 +4087,16 @@ void C4Landscape::UpdatePixCnt(const C4Rect &Rect, bool fCheck)
 		for (int32_t x = std::max<int32_t>(0, Rect.x / 17); x < std::min<int32_t>(PixCntWidth, (Rect.x + Rect.Wdt + 16) / 17); x++)
 		{
 			int iCnt = 0;
-			for (int32_t x2 = x * 17; x2 < std::min<int32_t>(x * 17 + 17, Width); x2++)
-				for (int32_t y2 = y * 15; y2 < std::min<int32_t>(y * 15 + 15, Height); y2++)
-					if (_GetDensity(x2, y2))
-						iCnt++;
+			int32_t iEndX = std::min<int32_t>(x * 17 + 17, Width);
+			for (int32_t y2 = y * 15; y2 < std::min<int32_t>(y * 15 + 15, Height); y2++)
+				for (int32_t x2 = x * 17, iLen; x2 < iEndX; x2 += iLen)
+				{
+					const BYTE *pSpan = Surface8->GetSpan(x2, y2, iLen);
+					iLen = std::min(iLen, iEndX - x2);
+					for (int32_t i = 0; i < iLen; ++i)
+						if (Pix2Dens[pSpan[i]])
+							iCnt++;
+				}
 			if (fCheck)
 				assert(iCnt == PixCnt[x * PixCntPitch + y]);
 			PixCnt[x * PixCntPitch + y] = iCnt;
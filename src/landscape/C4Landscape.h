@@ -24,6 +24,7 @@
 #include "C4Shape.h"
 
 #include <CSurface8.h>
+#include <C4TiledSurface8.h>
 #include <C4Material.h>
 
 const int32_t C4MaxMaterial = 125;
@@ -35,6 +36,10 @@ const int32_t C4LSC_Undefined = 0,
 
 const int32_t C4LS_MaxRelights = 50;
 
+// bit planes of the landscape surface
+const int C4LS_SolidPlane = 0, // density >= C4M_Solid
+          C4LS_LiquidPlane = 1; // density >= C4M_Liquid
+
 class C4Landscape
 {
 public:
@@ -56,13 +61,13 @@ public:
 	C4Sky Sky;
 	C4MapCreatorS2 *pMapCreator; // map creator for script-generated maps
 	bool fMapChanged;
-	BYTE *pInitial; // Initial landscape after creation - used for diff
-	BYTE *pInitialBkg; // Initial bkg landscape after creation - used for diff
+	C4TiledSurface8 *pInitial; // Initial landscape after creation - used for diff
+	C4TiledSurface8 *pInitialBkg; // Initial bkg landscape after creation - used for diff
 	class C4FoW *pFoW;
 
 private:
-	CSurface8 * Surface8;
-	CSurface8 * Surface8Bkg; // Background material
+	C4TiledSurface8 * Surface8;
+	C4TiledSurface8 * Surface8Bkg; // Background material
 	CSurface8 * Map;
 	CSurface8 * MapBkg;
 	class C4LandscapeRender *pLandscapeRender;
@@ -109,6 +114,7 @@ public:
 	bool MapToLandscape();
 	bool ApplyDiff(C4Group &hGroup);
 	bool SetMode(int32_t iMode);
+	void Benchmark(int32_t iSize); // log memory use and pixel access times of the tiled storage
 	bool SetPix2(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix); // set landscape pixel (bounds checked)
 	bool _SetPix2(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix); // set landsape pixel (bounds not checked)
 	void _SetPix2Tmp(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix); // set landsape pixel (bounds not checked, no material count updates, no landscape relighting). Material must be reset to original value with this function before modifying landscape in any other way. Only used for temporary pixel changes by SolidMask (C4SolidMask::RemoveTemporary, C4SolidMask::PutTemporary).
@@ -258,6 +264,9 @@ public:
 	inline int32_t GetPixMat(BYTE byPix) const { return Pix2Mat[byPix]; }
 	inline int32_t GetPixDensity(BYTE byPix) const { return Pix2Dens[byPix]; }
 	bool _PathFree(int32_t x, int32_t y, int32_t x2, int32_t y2) const; // quickly checks wether there *might* be pixel in the path.
+	int32_t GetDensityRun(int32_t x, int32_t y, int32_t dx, int32_t dy, int32_t iMax, int32_t iDensity) const; // number of pixels from x/y on in direction dx/dy (one of them +-1) that are sure to be less dense than iDensity, up to iMax; stops at the landscape border
+	bool GetDensityHash(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t &rHash) const; // hash of which pixels from x1/y1 to x2/y2 are solid or liquid, clipped to the landscape; fails without density planes
+	uint64_t GetDensityVersion(int32_t x1, int32_t y1, int32_t x2, int32_t y2) const; // changes whenever GetDensityHash of the area may have changed
 	int32_t GetMatHeight(int32_t x, int32_t y, int32_t iYDir, int32_t iMat, int32_t iMax) const;
 
 	int32_t AreaSolidCount(int32_t x, int32_t y, int32_t wdt, int32_t hgt) const;
@@ -294,6 +303,7 @@ private:
 	bool CreateMap(CSurface8*& sfcMap, CSurface8*& sfcMapBkg); // create map by landscape attributes
 	bool CreateMapS2(C4Group &ScenFile, CSurface8*& sfcMap, CSurface8*& sfcMapBkg); // create map by def file
 	bool Mat2Pal(); // assign material colors to landscape palette
+	void UpdateDensityPlanes(); // mark solid and liquid pixels in the bit planes of the landscape surface
 	void UpdatePixCnt(const class C4Rect &Rect, bool fCheck = false);
 	void UpdateMatCnt(C4Rect Rect, bool fPlus);
 	void PrepareChange(C4Rect BoundingBox);
@@ -1110,6 +1110,7 @@ void C4LandscapeRenderGL::Draw(const C4TargetFacet &cgo, const C4FoWRegion *Ligh
 	}
 
 	// Do the blit
+	++pDraw->DrawCalls;
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
 	// Reset state
@@ -497,13 +497,12 @@ void C4MapScriptLayer::ConvertSkyToTransparent()
 	if (!HasSurface()) return;
 	for (int32_t y=0; y<fg_surface->Hgt; ++y)
 	{
+		BYTE *fg_row = fg_surface->Bits + y*fg_surface->Pitch;
+		BYTE *bg_row = bg_surface->Bits + y*bg_surface->Pitch;
 		for (int32_t x=0; x<fg_surface->Wdt; ++x)
 		{
-			if (fg_surface->_GetPix(x,y) == C4M_MaxTexIndex)
-				fg_surface->_SetPix(x,y, 0);
-
-			if (bg_surface->_GetPix(x,y) == C4M_MaxTexIndex)
-				bg_surface->_SetPix(x,y, 0);
+			if (fg_row[x] == C4M_MaxTexIndex) fg_row[x] = 0;
+			if (bg_row[x] == C4M_MaxTexIndex) bg_row[x] = 0;
 		}
 	}
 }
@@ -520,10 +519,20 @@ bool C4MapScriptLayer::Fill(uint8_t fg, uint8_t bg, const C4Rect &rcBounds, cons
 	uint8_t temp_fg, temp_bg;
 	if (!HasSurface()) return false;
 	assert(rcBounds.x>=0 && rcBounds.y>=0 && rcBounds.x+rcBounds.Wdt<=fg_surface->Wdt && rcBounds.y+rcBounds.Hgt<=fg_surface->Hgt);
+	// without algo, whole rows are filled at once
+	if (!algo)
+	{
+		for (int32_t y=rcBounds.y; y<rcBounds.y+rcBounds.Hgt; ++y)
+		{
+			memset(fg_surface->Bits + y*fg_surface->Pitch + rcBounds.x, fg, rcBounds.Wdt);
+			memset(bg_surface->Bits + y*bg_surface->Pitch + rcBounds.x, bg, rcBounds.Wdt);
+		}
+		return true;
+	}
 	// set all non-masked pixels within bounds that fulfill algo
 	for (int32_t y=rcBounds.y; y<rcBounds.y+rcBounds.Hgt; ++y)
 		for (int32_t x=rcBounds.x; x<rcBounds.x+rcBounds.Wdt; ++x)
-			if (!algo || (*algo)(x,y,temp_fg,temp_bg))
+			if ((*algo)(x,y,temp_fg,temp_bg))
 			{
 				fg_surface->_SetPix(x,y,fg);
 				bg_surface->_SetPix(x,y,bg);
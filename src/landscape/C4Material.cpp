@@ -73,6 +73,7 @@ void C4MaterialReaction::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(iDepth,              "Depth",                    0               ));
 	pComp->Value(mkNamingAdapt(mkParAdapt(sConvertMat, StdCompiler::RCT_IdtfAllowEmpty),         "ConvertMat",               StdCopyStrBuf() ));
 	pComp->Value(mkNamingAdapt(iCorrosionRate,      "CorrosionRate",            100             ));
+	pComp->Value(mkNamingAdapt(fBatched,            "Batched",                  false           ));
 }
 
 
@@ -294,6 +295,7 @@ void C4MaterialMap::Clear()
 {
 	if (Map) delete [] Map; Map=NULL; Num=0;
 	delete [] ppReactionMap; ppReactionMap = NULL;
+	delete [] pBatchMap; pBatchMap = NULL;
 }
 
 int32_t C4MaterialMap::Load(C4Group &hGroup)
@@ -508,6 +510,11 @@ bool C4MaterialMap::CrossMapMaterials(const char* szEarthMaterial) // Called aft
 			}
 		}
 	}
+	// build batch kernel map from the final reactions
+	delete [] pBatchMap;
+	pBatchMap = new C4MaterialBatchFunc[(Num+1)*(Num+1)];
+	for (int32_t i=0; i<(Num+1)*(Num+1); ++i)
+		pBatchMap[i] = GetBatchFunc(ppReactionMap[i]);
 	// second loop (DefaultMatTex is needed by GetIndexMatTex)
 	for (cnt=0; cnt<Num; cnt++)
 	{
@@ -547,6 +554,21 @@ void C4MaterialMap::SetMatReaction(int32_t iPXSMat, int32_t iLSMat, C4MaterialRe
 	ppReactionMap[(iLSMat+1)*(Num+1) + iPXSMat+1] = pReact;
 }
 
+C4MaterialBatchFunc C4MaterialMap::GetBatchFunc(C4MaterialReaction *pReact)
+{
+	// Only reactions that always stop or kill the PXS on meePXSMove can be deferred;
+	// the others may let it continue its movement through the target material
+	if (!pReact) return NULL;
+	if (pReact->pFunc == &mrfScript)
+		return (pReact->fBatched && (pReact->iExecMask & (1<<meePXSMove))) ? &mbfScript : NULL;
+	if (pReact->fUserDefined) return NULL;
+	if (pReact->pFunc == &mrfPoof) return &mbfPoof;
+	if (pReact->pFunc == &mrfCorrode) return &mbfCorrode;
+	if (pReact->pFunc == &mrfIncinerate) return &mbfIncinerate;
+	if (pReact->pFunc == &mrfInsert) return &mbfInsert;
+	return NULL;
+}
+
 bool C4MaterialMap::SaveEnumeration(C4Group &hGroup)
 {
 	char *mapbuf = new char [1000];
@@ -619,6 +641,7 @@ void C4MaterialMap::Default()
 	Num=0;
 	Map=NULL;
 	ppReactionMap=NULL;
+	pBatchMap=NULL;
 	max_shape_width=max_shape_height=0;
 }
 
@@ -926,6 +949,106 @@ bool C4MaterialMap::mrfScript(C4MaterialReaction *pReaction, int32_t &iX, int32_
 	return false;
 }
 
+// Landscape may have changed since the contact was collected, e.g. by an earlier
+// contact of the same batch. Stale contacts just stop the PXS for this frame.
+static inline bool ContactValid(const C4MaterialContact &rContact)
+{
+	return GBackMat(rContact.iLSPosX, rContact.iLSPosY) == rContact.iLsMat;
+}
+
+void C4MaterialMap::mbfPoof(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount)
+{
+	for (C4MaterialContact *c = pContacts; c < pContacts + iCount; ++c)
+	{
+		if (!ContactValid(*c)) continue;
+		if (!mrfInsertCheck(c->iX, c->iY, c->fXDir, c->fYDir, c->iPxsMat, c->iLsMat, NULL)) continue;
+		::Landscape.ExtractMaterial(c->iLSPosX,c->iLSPosY,false);
+		if (!Random(3)) Smoke(c->iX,c->iY,3);
+		if (!Random(3)) StartSoundEffectAt("Liquids::Pshshsh", c->iX, c->iY);
+		c->fKill = true;
+	}
+}
+
+void C4MaterialMap::mbfCorrode(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount)
+{
+	if (!iCount) return;
+	// all contacts share the material pair
+	int32_t iRate = std::min(::MaterialMap.Map[pContacts->iPxsMat].Corrosive, ::MaterialMap.Map[pContacts->iLsMat].Corrode);
+	for (C4MaterialContact *c = pContacts; c < pContacts + iCount; ++c)
+	{
+		if (!ContactValid(*c)) continue;
+		if (!mrfInsertCheck(c->iX, c->iY, c->fXDir, c->fYDir, c->iPxsMat, c->iLsMat, NULL)) continue;
+		c->fKill = true;
+		if (Random(100) < iRate)
+		{
+			ClearBackPix(c->iLSPosX,c->iLSPosY);
+			::Landscape.CheckInstabilityRange(c->iLSPosX,c->iLSPosY);
+			if (!Random(5))
+			{
+				Smoke(c->iX,c->iY,3+Random(3));
+			}
+			if (!Random(20)) StartSoundEffectAt("Liquids::Corrode", c->iX, c->iY);
+		}
+		else
+			::Landscape.InsertMaterial(c->iPxsMat,&c->iX,&c->iY);
+	}
+}
+
+void C4MaterialMap::mbfIncinerate(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount)
+{
+	for (C4MaterialContact *c = pContacts; c < pContacts + iCount; ++c)
+	{
+		if (!ContactValid(*c)) continue;
+		if (!mrfInsertCheck(c->iX, c->iY, c->fXDir, c->fYDir, c->iPxsMat, c->iLsMat, NULL)) continue;
+		c->fKill = true;
+		if (!::Landscape.Incinerate(c->iX, c->iY, NO_OWNER))
+			::Landscape.InsertMaterial(c->iPxsMat,&c->iX,&c->iY);
+	}
+}
+
+void C4MaterialMap::mbfInsert(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount)
+{
+	for (C4MaterialContact *c = pContacts; c < pContacts + iCount; ++c)
+	{
+		if (!ContactValid(*c)) continue;
+		if (!mrfInsertCheck(c->iX, c->iY, c->fXDir, c->fYDir, c->iPxsMat, c->iLsMat, NULL)) continue;
+		::Landscape.InsertMaterial(c->iPxsMat,&c->iX,&c->iY);
+		c->fKill = true;
+	}
+}
+
+void C4MaterialMap::mbfScript(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount)
+{
+	// do generic checks for user-defined reactions
+	std::vector<C4MaterialContact *> Applied;
+	Applied.reserve(iCount);
+	for (C4MaterialContact *c = pContacts; c < pContacts + iCount; ++c)
+	{
+		if (!ContactValid(*c)) continue;
+		if (!mrfUserCheck(pReaction, c->iX, c->iY, c->iLSPosX, c->iLSPosY, c->fXDir, c->fYDir, c->iPxsMat, c->iLsMat, meePXSMove, NULL)) continue;
+		Applied.push_back(c);
+	}
+	if (Applied.empty() || !pReaction->pScriptFunc) return;
+	// same parameters as for unbatched script reactions, but with arrays for the per-PXS values
+	int32_t iSize = Applied.size();
+	C4ValueArray *pX = new C4ValueArray(iSize), *pY = new C4ValueArray(iSize),
+	             *pLSX = new C4ValueArray(iSize), *pLSY = new C4ValueArray(iSize),
+	             *pXDir = new C4ValueArray(iSize), *pYDir = new C4ValueArray(iSize);
+	for (int32_t i=0; i<iSize; ++i)
+	{
+		C4MaterialContact *c = Applied[i];
+		(*pX)[i] = C4VInt(c->iX); (*pY)[i] = C4VInt(c->iY);
+		(*pLSX)[i] = C4VInt(c->iLSPosX); (*pLSY)[i] = C4VInt(c->iLSPosY);
+		(*pXDir)[i] = C4VInt(fixtoi(c->fXDir, 100)); (*pYDir)[i] = C4VInt(fixtoi(c->fYDir, 100));
+	}
+	C4AulParSet pars(C4VArray(pX), C4VArray(pY), C4VArray(pLSX), C4VArray(pLSY), C4VArray(pXDir), C4VArray(pYDir), C4VInt(pContacts->iPxsMat), C4VInt(pContacts->iLsMat), C4VInt(meePXSMove));
+	// return value: array of kill flags, or a single flag for the whole batch
+	C4Value vResult = pReaction->pScriptFunc->Exec(NULL, &pars, false);
+	C4ValueArray *pResult = vResult.getArray();
+	for (int32_t i=0; i<iSize; ++i)
+		Applied[i]->fKill = pResult ? (i < pResult->GetSize() && !!pResult->_GetItem(i)) : !!vResult;
+}
+
 void C4MaterialMap::UpdateScriptPointers()
 {
 	// update in all materials
@@ -42,6 +42,21 @@ enum MaterialInteractionEvent
 
 typedef bool (*C4MaterialReactionFunc)(struct C4MaterialReaction *pReaction, int32_t &iX, int32_t &iY, int32_t iLSPosX, int32_t iLSPosY, C4Real &fXDir, C4Real &fYDir, int32_t &iPxsMat, int32_t iLsMat, MaterialInteractionEvent evEvent, bool *pfPosChanged);
 
+// A PXS movement contact that is collected during PXS execution and
+// processed later together with all contacts of the same material pair
+struct C4MaterialContact
+{
+	int32_t iX, iY;           // last free PXS position; may be changed by the reaction
+	int32_t iLSPosX, iLSPosY; // landscape pixel that was hit
+	C4Real fXDir, fYDir;      // PXS speed; may be changed by the reaction
+	int32_t iPxsMat, iLsMat;
+	int32_t iTag;             // caller data (PXS index)
+	bool fKill;               // result: PXS is destroyed
+};
+
+// Processes a run of meePXSMove contacts of one (PXS mat, landscape mat) pair
+typedef void (*C4MaterialBatchFunc)(struct C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount);
+
 struct C4MaterialReaction
 {
 	static inline bool NoReaction(struct C4MaterialReaction *pReaction, int32_t &iX, int32_t &iY, int32_t iLSPosX, int32_t iLSPosY, C4Real &fXDir, C4Real &fYDir, int32_t &iPxsMat, int32_t iLsMat, MaterialInteractionEvent evEvent, bool *pfPosChanged) { return false; }
@@ -59,9 +74,10 @@ struct C4MaterialReaction
 	StdCopyStrBuf sConvertMat;// in mat conversion material (string)
 	int32_t iConvertMat;      // in mat conversion material; evaluated in CrossMapMaterials
 	int32_t iCorrosionRate;   // chance of doing a corrosion
+	bool fBatched;            // for reaction func 'script': call once per frame and material pair with arrays
 
-	C4MaterialReaction(C4MaterialReactionFunc pFunc) : pFunc(pFunc), fUserDefined(false), pScriptFunc(NULL), iExecMask(~0u), fReverse(false), fInverseSpec(false), fInsertionCheck(true), iDepth(0), iConvertMat(-1), iCorrosionRate(100) {}
-	C4MaterialReaction() : pFunc(&NoReaction), fUserDefined(true), pScriptFunc(NULL), iExecMask(~0u), fReverse(false), fInverseSpec(false), fInsertionCheck(true), iDepth(0), iConvertMat(-1), iCorrosionRate(100) { }
+	C4MaterialReaction(C4MaterialReactionFunc pFunc) : pFunc(pFunc), fUserDefined(false), pScriptFunc(NULL), iExecMask(~0u), fReverse(false), fInverseSpec(false), fInsertionCheck(true), iDepth(0), iConvertMat(-1), iCorrosionRate(100), fBatched(false) {}
+	C4MaterialReaction() : pFunc(&NoReaction), fUserDefined(true), pScriptFunc(NULL), iExecMask(~0u), fReverse(false), fInverseSpec(false), fInsertionCheck(true), iDepth(0), iConvertMat(-1), iCorrosionRate(100), fBatched(false) { }
 
 	void CompileFunc(StdCompiler *pComp);
 
@@ -170,6 +186,7 @@ public:
 	int32_t Num;
 	C4Material *Map;
 	C4MaterialReaction **ppReactionMap;
+	C4MaterialBatchFunc *pBatchMap; // batch kernels for meePXSMove; same layout as ppReactionMap
 	int32_t max_shape_width,max_shape_height; // maximum size of the largest polygon in any of the used shapes
 
 	C4MaterialReaction DefReactConvert, DefReactPoof, DefReactCorrode, DefReactIncinerate, DefReactInsert;
@@ -182,6 +199,12 @@ public:
 	static bool mrfInsert (C4MaterialReaction *pReaction, int32_t &iX, int32_t &iY, int32_t iLSPosX, int32_t iLSPosY, C4Real &fXDir, C4Real &fYDir, int32_t &iPxsMat, int32_t iLsMat, MaterialInteractionEvent evEvent, bool *pfPosChanged);
 	// user-defined actions
 	static bool mrfScript(C4MaterialReaction *pReaction, int32_t &iX, int32_t &iY, int32_t iLSPosX, int32_t iLSPosY, C4Real &fXDir, C4Real &fYDir, int32_t &iPxsMat, int32_t iLsMat, MaterialInteractionEvent evEvent, bool *pfPosChanged);
+	// batch kernels for PXS movement contacts
+	static void mbfPoof(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount);
+	static void mbfCorrode(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount);
+	static void mbfIncinerate(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount);
+	static void mbfInsert(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount);
+	static void mbfScript(C4MaterialReaction *pReaction, C4MaterialContact *pContacts, int32_t iCount);
 public:
 	void Default();
 	void Clear();
@@ -196,10 +219,16 @@ public:
 		return ppReactionMap[(iLandscapeMat+1)*(Num+1) + iPXSMat+1];
 	}
 	C4MaterialReaction *GetReaction(int32_t iPXSMat, int32_t iLandscapeMat);
+	C4MaterialBatchFunc GetBatchFuncUnsafe(int32_t iPXSMat, int32_t iLandscapeMat)
+	{
+		assert(pBatchMap); assert(Inside<int32_t>(iPXSMat,-1,Num-1)); assert(Inside<int32_t>(iLandscapeMat,-1,Num-1));
+		return pBatchMap[(iLandscapeMat+1)*(Num+1) + iPXSMat+1];
+	}
 	void UpdateScriptPointers(); // set all material script pointers
 	bool CrossMapMaterials(const char* szEarthMaterial);
 protected:
 	void SetMatReaction(int32_t iPXSMat, int32_t iLSMat, C4MaterialReaction *pReact);
+	static C4MaterialBatchFunc GetBatchFunc(C4MaterialReaction *pReact);
 	bool SortEnumeration(int32_t iMat, const char *szMatName);
 };
 
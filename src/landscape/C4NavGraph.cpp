@@ -0,0 +1,343 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Region/portal navigation graph used to speed up the pathfinder */
+
+/* Notes
+
+   The graph is repaired lazily: landscape changes only flag the sectors they
+   touch, and the flagged sectors are rebuilt at the beginning of the next
+   query. Because queries happen in synchronized code and the result only
+   depends on the landscape at query time, this is network safe.
+
+*/
+
+#include <C4Include.h>
+#include <C4NavGraph.h>
+
+#include <C4Rect.h>
+
+#include <queue>
+
+C4NavGraph::C4NavGraph(int32_t iWdt, int32_t iHgt, PointFreeFn fnPointFree)
+	: Wdt(iWdt), Hgt(iHgt), PointFree(fnPointFree), AnyDirty(true), SearchStamp(0)
+{
+	SectorsX = (Wdt + C4NG_SectorSize - 1) / C4NG_SectorSize;
+	SectorsY = (Hgt + C4NG_SectorSize - 1) / C4NG_SectorSize;
+	Sectors.resize(SectorsX * SectorsY);
+	for (Sector &rSector : Sectors)
+	{
+		memset(rSector.Labels, NoRegion, sizeof(rSector.Labels));
+		rSector.Dirty = true;
+	}
+	size_t iNodes = Sectors.size() * C4NG_MaxRegions;
+	Cost.resize(iNodes);
+	Parent.resize(iNodes);
+	ParentEdge.resize(iNodes);
+	Visited.resize(iNodes, 0);
+}
+
+C4NavGraph::~C4NavGraph()
+{
+}
+
+int32_t C4NavGraph::GetRegionCount() const
+{
+	int32_t iCount = 0;
+	for (const Sector &rSector : Sectors) iCount += rSector.Regions.size();
+	return iCount;
+}
+
+void C4NavGraph::Invalidate(const C4Rect &rRect)
+{
+	int32_t iX1 = std::max<int32_t>(rRect.x, 0) / C4NG_SectorSize,
+	        iY1 = std::max<int32_t>(rRect.y, 0) / C4NG_SectorSize,
+	        iX2 = std::min<int32_t>((rRect.x + rRect.Wdt - 1) / C4NG_SectorSize, SectorsX - 1),
+	        iY2 = std::min<int32_t>((rRect.y + rRect.Hgt - 1) / C4NG_SectorSize, SectorsY - 1);
+	for (int32_t iY = iY1; iY <= iY2; ++iY)
+		for (int32_t iX = iX1; iX <= iX2; ++iX)
+		{
+			Sectors[iY * SectorsX + iX].Dirty = true;
+			AnyDirty = true;
+		}
+}
+
+void C4NavGraph::Repair()
+{
+	if (!AnyDirty) return;
+	// Rebuild regions of all changed sectors first...
+	std::vector<bool> EdgesDirty(Sectors.size(), false);
+	for (int32_t i = 0; i < int32_t(Sectors.size()); ++i)
+		if (Sectors[i].Dirty)
+		{
+			BuildRegions(i);
+			int32_t iX = i % SectorsX, iY = i / SectorsX;
+			EdgesDirty[i] = true;
+			if (iX > 0) EdgesDirty[i - 1] = true;
+			if (iX < SectorsX - 1) EdgesDirty[i + 1] = true;
+			if (iY > 0) EdgesDirty[i - SectorsX] = true;
+			if (iY < SectorsY - 1) EdgesDirty[i + SectorsX] = true;
+		}
+	// ...then the portals, which depend on the regions of the neighbours
+	for (int32_t i = 0; i < int32_t(Sectors.size()); ++i)
+		if (EdgesDirty[i])
+			BuildEdges(i);
+	AnyDirty = false;
+	Cache.clear();
+}
+
+bool C4NavGraph::CellFree(int32_t iCellX, int32_t iCellY) const
+{
+	int32_t iX0 = iCellX * C4NG_CellSize, iY0 = iCellY * C4NG_CellSize;
+	for (int32_t iY = iY0; iY < iY0 + C4NG_CellSize; ++iY)
+		for (int32_t iX = iX0; iX < iX0 + C4NG_CellSize; ++iX)
+			if (!PointFree(iX, iY))
+				return false;
+	return true;
+}
+
+void C4NavGraph::BuildRegions(int32_t iSector)
+{
+	Sector &rSector = Sectors[iSector];
+	int32_t iCellX0 = (iSector % SectorsX) * C4NG_SectorCells,
+	        iCellY0 = (iSector / SectorsX) * C4NG_SectorCells;
+	// Passable cells are marked with 0, blocked cells with NoRegion
+	for (int32_t iCY = 0; iCY < C4NG_SectorCells; ++iCY)
+		for (int32_t iCX = 0; iCX < C4NG_SectorCells; ++iCX)
+			rSector.Labels[iCY * C4NG_SectorCells + iCX] = CellFree(iCellX0 + iCX, iCellY0 + iCY) ? 0 : NoRegion;
+	// Flood fill connected cells in scan order, so region numbering is stable
+	uint8_t Unlabeled[C4NG_SectorCells * C4NG_SectorCells];
+	for (int32_t i = 0; i < C4NG_SectorCells * C4NG_SectorCells; ++i)
+		Unlabeled[i] = (rSector.Labels[i] == 0);
+	rSector.Regions.clear();
+	int32_t Stack[C4NG_SectorCells * C4NG_SectorCells];
+	for (int32_t iStart = 0; iStart < C4NG_SectorCells * C4NG_SectorCells; ++iStart)
+	{
+		if (!Unlabeled[iStart]) continue;
+		uint8_t iRegion = rSector.Regions.size();
+		assert(iRegion < C4NG_MaxRegions);
+		int32_t iStackSize = 0, iCount = 0, iSumX = 0, iSumY = 0;
+		Stack[iStackSize++] = iStart; Unlabeled[iStart] = 0;
+		while (iStackSize)
+		{
+			int32_t iCell = Stack[--iStackSize];
+			int32_t iCX = iCell % C4NG_SectorCells, iCY = iCell / C4NG_SectorCells;
+			rSector.Labels[iCell] = iRegion;
+			++iCount; iSumX += iCX; iSumY += iCY;
+			if (iCX > 0 && Unlabeled[iCell - 1]) { Unlabeled[iCell - 1] = 0; Stack[iStackSize++] = iCell - 1; }
+			if (iCX < C4NG_SectorCells - 1 && Unlabeled[iCell + 1]) { Unlabeled[iCell + 1] = 0; Stack[iStackSize++] = iCell + 1; }
+			if (iCY > 0 && Unlabeled[iCell - C4NG_SectorCells]) { Unlabeled[iCell - C4NG_SectorCells] = 0; Stack[iStackSize++] = iCell - C4NG_SectorCells; }
+			if (iCY < C4NG_SectorCells - 1 && Unlabeled[iCell + C4NG_SectorCells]) { Unlabeled[iCell + C4NG_SectorCells] = 0; Stack[iStackSize++] = iCell + C4NG_SectorCells; }
+		}
+		// Anchor on the region cell closest to its center of mass
+		int32_t iBest = iStart, iBestDist = INT_MAX;
+		for (int32_t iCell = iStart; iCell < C4NG_SectorCells * C4NG_SectorCells; ++iCell)
+		{
+			if (rSector.Labels[iCell] != iRegion) continue;
+			int32_t iDX = (iCell % C4NG_SectorCells) * iCount - iSumX, iDY = (iCell / C4NG_SectorCells) * iCount - iSumY;
+			int32_t iDist = iDX * iDX + iDY * iDY;
+			if (iDist < iBestDist) { iBest = iCell; iBestDist = iDist; }
+		}
+		Region NewRegion;
+		NewRegion.X = (iCellX0 + iBest % C4NG_SectorCells) * C4NG_CellSize + C4NG_CellSize / 2;
+		NewRegion.Y = (iCellY0 + iBest / C4NG_SectorCells) * C4NG_CellSize + C4NG_CellSize / 2;
+		rSector.Regions.push_back(NewRegion);
+	}
+	rSector.Dirty = false;
+}
+
+void C4NavGraph::BuildEdges(int32_t iSector)
+{
+	Sector &rSector = Sectors[iSector];
+	for (Region &rRegion : rSector.Regions) rRegion.Edges.clear();
+	int32_t iSX = iSector % SectorsX, iSY = iSector / SectorsX;
+	int32_t iCellX0 = iSX * C4NG_SectorCells, iCellY0 = iSY * C4NG_SectorCells;
+	// Left, right, top, bottom neighbour
+	static const int32_t Dirs[4][2] = { { -1, 0 }, { +1, 0 }, { 0, -1 }, { 0, +1 } };
+	for (const int32_t *Dir : Dirs)
+	{
+		int32_t iNX = iSX + Dir[0], iNY = iSY + Dir[1];
+		if (iNX < 0 || iNY < 0 || iNX >= SectorsX || iNY >= SectorsY) continue;
+		int32_t iNeighbour = iNY * SectorsX + iNX;
+		const Sector &rNeighbour = Sectors[iNeighbour];
+		// Collect contacts along the shared border as (own region, other region, border index)
+		int32_t Contacts[C4NG_SectorCells][3], iContacts = 0;
+		for (int32_t i = 0; i < C4NG_SectorCells; ++i)
+		{
+			int32_t iOwn, iOther;
+			if (Dir[0])
+			{
+				int32_t iOwnX = Dir[0] < 0 ? 0 : C4NG_SectorCells - 1;
+				iOwn = i * C4NG_SectorCells + iOwnX;
+				iOther = i * C4NG_SectorCells + (C4NG_SectorCells - 1 - iOwnX);
+			}
+			else
+			{
+				int32_t iOwnY = Dir[1] < 0 ? 0 : C4NG_SectorCells - 1;
+				iOwn = iOwnY * C4NG_SectorCells + i;
+				iOther = (C4NG_SectorCells - 1 - iOwnY) * C4NG_SectorCells + i;
+			}
+			if (rSector.Labels[iOwn] == NoRegion || rNeighbour.Labels[iOther] == NoRegion) continue;
+			Contacts[iContacts][0] = rSector.Labels[iOwn];
+			Contacts[iContacts][1] = rNeighbour.Labels[iOther];
+			Contacts[iContacts][2] = iOwn;
+			++iContacts;
+		}
+		// One portal per region pair, placed on the middle contact cell
+		for (int32_t i = 0; i < iContacts; ++i)
+		{
+			bool fSeen = false;
+			for (int32_t j = 0; j < i && !fSeen; ++j)
+				fSeen = (Contacts[j][0] == Contacts[i][0] && Contacts[j][1] == Contacts[i][1]);
+			if (fSeen) continue;
+			int32_t Matching[C4NG_SectorCells], iMatching = 0;
+			for (int32_t j = i; j < iContacts; ++j)
+				if (Contacts[j][0] == Contacts[i][0] && Contacts[j][1] == Contacts[i][1])
+					Matching[iMatching++] = Contacts[j][2];
+			int32_t iCell = Matching[iMatching / 2];
+			Region &rRegion = rSector.Regions[Contacts[i][0]];
+			const Region &rOther = rNeighbour.Regions[Contacts[i][1]];
+			Edge NewEdge;
+			NewEdge.Node = iNeighbour * C4NG_MaxRegions + Contacts[i][1];
+			NewEdge.X = (iCellX0 + iCell % C4NG_SectorCells) * C4NG_CellSize + C4NG_CellSize / 2;
+			NewEdge.Y = (iCellY0 + iCell / C4NG_SectorCells) * C4NG_CellSize + C4NG_CellSize / 2;
+			NewEdge.Cost = Distance(rRegion.X, rRegion.Y, NewEdge.X, NewEdge.Y) + Distance(NewEdge.X, NewEdge.Y, rOther.X, rOther.Y) + 1;
+			rRegion.Edges.push_back(NewEdge);
+		}
+	}
+}
+
+int32_t C4NavGraph::GetNode(int32_t iX, int32_t iY) const
+{
+	if (!Inside<int32_t>(iX, 0, Wdt - 1) || !Inside<int32_t>(iY, 0, Hgt - 1)) return -1;
+	// Points close to solid material may lie in a blocked cell: use a passable neighbour cell
+	static const int32_t Offsets[9][2] = { { 0, 0 }, { 0, -1 }, { -1, 0 }, { +1, 0 }, { 0, +1 }, { -1, -1 }, { +1, -1 }, { -1, +1 }, { +1, +1 } };
+	for (const int32_t *Offset : Offsets)
+	{
+		int32_t iCellX = iX / C4NG_CellSize + Offset[0], iCellY = iY / C4NG_CellSize + Offset[1];
+		if (iCellX < 0 || iCellY < 0) continue;
+		int32_t iSX = iCellX / C4NG_SectorCells, iSY = iCellY / C4NG_SectorCells;
+		if (iSX >= SectorsX || iSY >= SectorsY) continue;
+		int32_t iSector = iSY * SectorsX + iSX;
+		uint8_t iRegion = Sectors[iSector].Labels[(iCellY % C4NG_SectorCells) * C4NG_SectorCells + iCellX % C4NG_SectorCells];
+		if (iRegion != NoRegion) return iSector * C4NG_MaxRegions + iRegion;
+	}
+	return -1;
+}
+
+bool C4NavGraph::FindRoute(int32_t iFrom, int32_t iTo, int32_t iMaxExpand, std::vector<Waypoint> &rRoute)
+{
+	// New search: invalidate all previous node data at once
+	if (!++SearchStamp)
+	{
+		std::fill(Visited.begin(), Visited.end(), 0);
+		SearchStamp = 1;
+	}
+	const Region &rTarget = GetRegion(iTo);
+	// Open list ordered by estimated cost, then by node for a deterministic tie break
+	typedef std::pair<int32_t, int32_t> OpenEntry;
+	std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry> > Open;
+	Visited[iFrom] = SearchStamp; Cost[iFrom] = 0; Parent[iFrom] = -1;
+	Open.push(OpenEntry(Distance(GetRegion(iFrom).X, GetRegion(iFrom).Y, rTarget.X, rTarget.Y), iFrom));
+	int32_t iExpanded = 0;
+	while (!Open.empty())
+	{
+		OpenEntry Top = Open.top(); Open.pop();
+		int32_t iNode = Top.second;
+		const Region &rRegion = GetRegion(iNode);
+		// Outdated entry
+		if (Top.first > Cost[iNode] + Distance(rRegion.X, rRegion.Y, rTarget.X, rTarget.Y)) continue;
+		if (iNode == iTo)
+		{
+			// Collect portals from target back to start
+			rRoute.clear();
+			for (; Parent[iNode] >= 0; iNode = Parent[iNode])
+			{
+				const Edge &rEdge = GetRegion(Parent[iNode]).Edges[ParentEdge[iNode]];
+				Waypoint Portal = { rEdge.X, rEdge.Y };
+				rRoute.push_back(Portal);
+			}
+			std::reverse(rRoute.begin(), rRoute.end());
+			return true;
+		}
+		if (++iExpanded > iMaxExpand) return false;
+		for (int32_t i = 0; i < int32_t(rRegion.Edges.size()); ++i)
+		{
+			const Edge &rEdge = rRegion.Edges[i];
+			int32_t iCost = Cost[iNode] + rEdge.Cost;
+			if (Visited[rEdge.Node] == SearchStamp && Cost[rEdge.Node] <= iCost) continue;
+			Visited[rEdge.Node] = SearchStamp;
+			Cost[rEdge.Node] = iCost;
+			Parent[rEdge.Node] = iNode;
+			ParentEdge[rEdge.Node] = i;
+			const Region &rNext = GetRegion(rEdge.Node);
+			Open.push(OpenEntry(iCost + Distance(rNext.X, rNext.Y, rTarget.X, rTarget.Y), rEdge.Node));
+		}
+	}
+	return false;
+}
+
+bool C4NavGraph::LineFree(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2) const
+{
+	int32_t iDX = Abs(iX2 - iX1), iDY = Abs(iY2 - iY1);
+	int32_t iSteps = std::max(iDX, iDY);
+	for (int32_t i = 0; i <= iSteps; ++i)
+	{
+		int32_t iX = iSteps ? iX1 + (iX2 - iX1) * i / iSteps : iX1,
+		        iY = iSteps ? iY1 + (iY2 - iY1) * i / iSteps : iY1;
+		if (!PointFree(iX, iY)) return false;
+	}
+	return true;
+}
+
+bool C4NavGraph::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iMaxExpand, std::vector<Waypoint> &rWaypoints)
+{
+	rWaypoints.clear();
+	Repair();
+	int32_t iFrom = GetNode(iFromX, iFromY), iTo = GetNode(iToX, iToY);
+	if (iFrom < 0 || iTo < 0) return false;
+	// Region route, cached
+	std::pair<int32_t, int32_t> Key(iFrom, iTo);
+	auto Cached = Cache.find(Key);
+	if (Cached == Cache.end())
+	{
+		std::vector<Waypoint> Route;
+		if (!FindRoute(iFrom, iTo, iMaxExpand, Route)) return false;
+		if (Cache.size() >= size_t(C4NG_MaxCache)) Cache.clear();
+		Cached = Cache.insert(std::make_pair(Key, Route)).first;
+	}
+	const std::vector<Waypoint> &rRoute = Cached->second;
+	// Smooth the route: from each waypoint, skip ahead as far as the line of sight reaches
+	Waypoint Target = { iToX, iToY };
+	int32_t iCount = rRoute.size();
+	int32_t iX = iFromX, iY = iFromY;
+	for (int32_t i = 0; i < iCount; )
+	{
+		int32_t iNext = i;
+		while (iNext + 1 <= iCount)
+		{
+			const Waypoint &rCandidate = (iNext + 1 < iCount) ? rRoute[iNext + 1] : Target;
+			if (!LineFree(iX, iY, rCandidate.X, rCandidate.Y)) break;
+			++iNext;
+		}
+		// Target in sight
+		if (iNext >= iCount) break;
+		rWaypoints.push_back(rRoute[iNext]);
+		iX = rRoute[iNext].X; iY = rRoute[iNext].Y;
+		i = iNext + 1;
+	}
+	// Nothing to route around within the graph's resolution: leave this to the ray search
+	return !rWaypoints.empty();
+}
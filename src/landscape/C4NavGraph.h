@@ -0,0 +1,104 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Region/portal navigation graph used to speed up the pathfinder */
+
+#ifndef INC_C4NavGraph
+#define INC_C4NavGraph
+
+#include <functional>
+
+// The landscape is split into sectors of C4NG_SectorCells x C4NG_SectorCells
+// cells of C4NG_CellSize x C4NG_CellSize pixels each. A cell is passable if
+// all of its pixels are free. Inside each sector, connected passable cells
+// form a region; regions touching across a sector border are linked by a
+// portal. Path queries are answered by A* over the regions.
+const int32_t C4NG_CellSize    = 4,
+              C4NG_SectorCells = 8,
+              C4NG_SectorSize  = C4NG_CellSize * C4NG_SectorCells,
+              C4NG_MaxRegions  = C4NG_SectorCells * C4NG_SectorCells / 2,
+              C4NG_MaxExpand   = 4000,  // node expansion limit per pathfinder level
+              C4NG_MaxCache    = 256;   // cached region routes
+
+class C4NavGraph
+{
+public:
+	typedef std::function<bool(int32_t x, int32_t y)> PointFreeFn;
+
+	struct Waypoint
+	{
+		int32_t X, Y;
+	};
+
+	C4NavGraph(int32_t iWdt, int32_t iHgt, PointFreeFn fnPointFree);
+	~C4NavGraph();
+
+	int32_t GetWidth() const { return Wdt; }
+	int32_t GetHeight() const { return Hgt; }
+	int32_t GetRegionCount() const;
+
+	void Invalidate(const C4Rect &rRect); // mark sectors for repair before the next query
+	void Repair(); // rebuild all dirty sectors and the portals around them
+	void ClearCache() { Cache.clear(); }
+	// Finds a route and returns the intermediate waypoints, excluding start and target
+	bool Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iMaxExpand, std::vector<Waypoint> &rWaypoints);
+
+private:
+	static const uint8_t NoRegion = 0xff;
+
+	struct Edge
+	{
+		int32_t Node; // target region node
+		int32_t X, Y; // portal position
+		int32_t Cost;
+	};
+
+	struct Region
+	{
+		int32_t X, Y; // anchor position, center of a passable cell
+		std::vector<Edge> Edges;
+	};
+
+	struct Sector
+	{
+		uint8_t Labels[C4NG_SectorCells * C4NG_SectorCells]; // region per cell
+		std::vector<Region> Regions;
+		bool Dirty;
+	};
+
+	int32_t Wdt, Hgt;
+	int32_t SectorsX, SectorsY;
+	PointFreeFn PointFree;
+	std::vector<Sector> Sectors;
+	bool AnyDirty;
+
+	// A* working data, reused across queries and reset by stamping
+	std::vector<int32_t> Cost, Parent, ParentEdge;
+	std::vector<uint32_t> Visited;
+	uint32_t SearchStamp;
+
+	// Region routes by (start node, target node); cleared on every repair
+	std::map<std::pair<int32_t, int32_t>, std::vector<Waypoint> > Cache;
+
+	bool CellFree(int32_t iCellX, int32_t iCellY) const;
+	void BuildRegions(int32_t iSector);
+	void BuildEdges(int32_t iSector);
+	int32_t GetNode(int32_t iX, int32_t iY) const;
+	const Region &GetRegion(int32_t iNode) const { return Sectors[iNode / C4NG_MaxRegions].Regions[iNode % C4NG_MaxRegions]; }
+	bool FindRoute(int32_t iFrom, int32_t iTo, int32_t iMaxExpand, std::vector<Waypoint> &rRoute);
+	bool LineFree(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2) const;
+};
+
+#endif
@@ -26,10 +26,11 @@
 #include <C4Random.h>
 #include <C4Weather.h>
 #include <C4Record.h>
+#include <C4Profiler.h>
 
 static const C4Real WindDrift_Factor = itofix(1, 800);
 
-void C4PXS::Execute()
+void C4PXS::Execute(int32_t iIndex)
 {
 #ifdef DEBUGREC_PXS
 	if (Config.General.DebugRec)
@@ -96,6 +97,12 @@ void C4PXS::Execute()
 		int32_t inX = iX + Sign(iToX - iX), inY = iY + Sign(iToY - iY);
 		// Contact?
 		inmat = GBackMat(inX, inY);
+		// Batched reaction? Stop here; it's applied after all PXS have moved
+		if (::MaterialMap.GetBatchFuncUnsafe(Mat, inmat))
+		{
+			::PXS.AddContact(iIndex, iX,iY, inX,inY, xdir,ydir, Mat,inmat);
+			return;
+		}
 		C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(Mat, inmat);
 		if (pReact)
 		{
@@ -179,6 +186,7 @@ void C4PXSSystem::Clear()
 		Chunk[cnt]=NULL;
 		iChunkPXS[cnt]=0;
 	}
+	Contacts.clear();
 }
 
 C4PXS* C4PXSSystem::New()
@@ -235,11 +243,60 @@ void C4PXSSystem::Execute()
 				for (unsigned int cnt2=0; cnt2<PXSChunkSize; cnt2++,pxp++)
 					if (pxp->Mat!=MNone)
 					{
-						pxp->Execute();
+						pxp->Execute(cchunk*PXSChunkSize+cnt2);
 						Count++;
 					}
 			}
 		}
+	// Apply the collected material reactions
+	ExecuteContacts();
+}
+
+void C4PXSSystem::AddContact(int32_t iIndex, int32_t iX, int32_t iY, int32_t iLSPosX, int32_t iLSPosY, C4Real fXDir, C4Real fYDir, int32_t iPxsMat, int32_t iLsMat)
+{
+	C4MaterialContact c;
+	c.iX = iX; c.iY = iY;
+	c.iLSPosX = iLSPosX; c.iLSPosY = iLSPosY;
+	c.fXDir = fXDir; c.fYDir = fYDir;
+	c.iPxsMat = iPxsMat; c.iLsMat = iLsMat;
+	c.iTag = iIndex;
+	c.fKill = false;
+	Contacts.push_back(c);
+}
+
+void C4PXSSystem::ExecuteContacts()
+{
+	if (Contacts.empty()) return;
+	C4PROFILE_ZONE("C4PXSSystem::ExecuteContacts");
+	// Group by material pair; the stable sort keeps PXS order within each pair
+	std::stable_sort(Contacts.begin(), Contacts.end(), [](const C4MaterialContact &a, const C4MaterialContact &b)
+	{
+		return a.iPxsMat < b.iPxsMat || (a.iPxsMat == b.iPxsMat && a.iLsMat < b.iLsMat);
+	});
+	// Run the kernel for each pair
+	size_t iStart = 0;
+	while (iStart < Contacts.size())
+	{
+		size_t iEnd = iStart + 1;
+		while (iEnd < Contacts.size() && Contacts[iEnd].iPxsMat == Contacts[iStart].iPxsMat && Contacts[iEnd].iLsMat == Contacts[iStart].iLsMat) ++iEnd;
+		C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(Contacts[iStart].iPxsMat, Contacts[iStart].iLsMat);
+		C4MaterialBatchFunc pBatchFunc = ::MaterialMap.GetBatchFuncUnsafe(Contacts[iStart].iPxsMat, Contacts[iStart].iLsMat);
+		(*pBatchFunc)(pReact, &Contacts[iStart], iEnd - iStart);
+		iStart = iEnd;
+	}
+	// Write back results
+	for (std::vector<C4MaterialContact>::iterator i = Contacts.begin(); i != Contacts.end(); ++i)
+	{
+		C4PXS *pxp = Chunk[i->iTag / PXSChunkSize] + i->iTag % PXSChunkSize;
+		if (i->fKill)
+			{ pxp->Deactivate(); continue; }
+		// Stopped at the contact; keep fractional positions like unbatched reactions
+		if (i->iX != fixtoi(pxp->x)) pxp->x = itofix(i->iX);
+		if (i->iY != fixtoi(pxp->y)) pxp->y = itofix(i->iY);
+		pxp->xdir = i->fXDir; pxp->ydir = i->fYDir;
+		pxp->Mat = i->iPxsMat;
+	}
+	Contacts.clear();
 }
 
 void C4PXSSystem::Draw(C4TargetFacet &cgo)
@@ -30,7 +30,7 @@ protected:
 	int32_t Mat;
 	C4Real x,y,xdir,ydir;
 protected:
-	void Execute();
+	void Execute(int32_t iIndex);
 	void Deactivate();
 };
 
@@ -46,6 +46,7 @@ public:
 protected:
 	C4PXS *Chunk[PXSMaxChunk];
 	size_t iChunkPXS[PXSMaxChunk];
+	std::vector<C4MaterialContact> Contacts; // movement contacts of this frame, processed per material pair
 public:
 	void Delete(C4PXS *pPXS);
 	void Default();
@@ -63,6 +64,10 @@ public:
 	int32_t GetCount(int32_t mat, int32_t x, int32_t y, int32_t wdt, int32_t hgt) const; // count PXS of given material in given area. mat==-1 for all materials.
 protected:
 	C4PXS *New();
+	void AddContact(int32_t iIndex, int32_t iX, int32_t iY, int32_t iLSPosX, int32_t iLSPosY, C4Real fXDir, C4Real fYDir, int32_t iPxsMat, int32_t iLsMat);
+	void ExecuteContacts();
+
+	friend class C4PXS;
 };
 
 extern C4PXSSystem PXS;
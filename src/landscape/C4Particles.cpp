@@ -33,6 +33,7 @@
 #include <C4Random.h>
 #include <C4Landscape.h>
 #include <C4Weather.h>	
+#include <chrono>
 #endif
 
 
@@ -149,7 +150,7 @@ bool C4ParticleDef::Reload()
 #ifndef USE_CONSOLE
 const int C4Particle::DrawingData::vertexCountPerParticle(4);
 
-void C4Particle::DrawingData::SetPosition(float x, float y, float size, float rotation, float stretch)
+void C4Particle::DrawingData::SetPosition(Vertex *vertices, float x, float y, float size, float rotation, float stretch)
 {
 	if (size != originalSize || stretch != currentStretch)
 	{
@@ -186,7 +187,7 @@ void C4Particle::DrawingData::SetPosition(float x, float y, float size, float ro
 	}
 }
 
-void C4Particle::DrawingData::SetPhase(int phase, C4ParticleDef *sourceDef)
+void C4Particle::DrawingData::SetPhase(Vertex *vertices, int phase, C4ParticleDef *sourceDef)
 {
 	this->phase = phase;
 	phase = phase % sourceDef->Length;
@@ -212,6 +213,7 @@ C4ParticleValueProvider & C4ParticleValueProvider::operator= (const C4ParticleVa
 	startValue = other.startValue;
 	endValue = other.endValue;
 	currentValue = other.currentValue;
+	randomSalt = other.randomSalt;
 	rerollInterval = other.rerollInterval;
 	smoothing = other.smoothing;
 	valueFunction = other.valueFunction;
@@ -383,19 +385,69 @@ void C4ParticleValueProvider::Floatify(float denominator)
 	}
 }
 
-void C4ParticleValueProvider::RollRandom()
-{
-	float range = endValue - startValue;
-	float rnd = (float)(rand()) / (float)(RAND_MAX); 
-	currentValue = startValue + rnd * range;
-}
-
 float C4ParticleValueProvider::GetValue(C4Particle *forParticle)
 {
+	// most providers are constant or linear without children; evaluate those without the indirect call
+	if (childrenValueProviders.empty())
+	{
+		if (valueFunction == &C4ParticleValueProvider::Const)
+			return startValue;
+		if (valueFunction == &C4ParticleValueProvider::Linear)
+			return startValue + (endValue - startValue) * forParticle->GetRelativeAge();
+	}
 	UpdateChildren(forParticle);
 	return (this->*valueFunction)(forParticle);
 }
 
+void C4ParticleValueProvider::GetValues(C4ParticleChunk &chunk, size_t begin, size_t end, float *values)
+{
+	assert(childrenValueProviders.empty() && "Children can change the provider for every particle");
+	const size_t count = end - begin;
+	const float *lifetime = &chunk.lifetime[begin], *startingLifetime = &chunk.startingLifetime[begin];
+
+	// the loops are simple enough to be vectorized by the compiler
+	if (valueFunction == &C4ParticleValueProvider::Const)
+	{
+		std::fill(values, values + count, startValue);
+	}
+	else if (valueFunction == &C4ParticleValueProvider::Linear)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			float relativeAge = (startingLifetime[i] != 0.f) ? (1.0f - (lifetime[i] / startingLifetime[i])) : 0.f;
+			values[i] = startValue + (endValue - startValue) * relativeAge;
+		}
+	}
+	else if (valueFunction == &C4ParticleValueProvider::Step)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			float value = currentValue + startValue * (startingLifetime[i] - lifetime[i]) / delay;
+			values[i] = (maxValue != 0.0f && value > maxValue) ? maxValue : value;
+		}
+	}
+	else if (valueFunction == &C4ParticleValueProvider::Speed)
+	{
+		const float *speedX = &chunk.speedX[begin], *speedY = &chunk.speedY[begin];
+		for (size_t i = 0; i < count; ++i)
+			values[i] = startValue + speedFactor * sqrtf((speedX[i] * speedX[i]) + (speedY[i] * speedY[i]));
+	}
+	else if (valueFunction == &C4ParticleValueProvider::Sin || valueFunction == &C4ParticleValueProvider::Gravity)
+	{
+		// without children, these are the same for all particles
+		C4Particle particle(&chunk, begin);
+		std::fill(values, values + count, (this->*valueFunction)(&particle));
+	}
+	else
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			C4Particle particle(&chunk, begin + i);
+			values[i] = (this->*valueFunction)(&particle);
+		}
+	}
+}
+
 float C4ParticleValueProvider::Linear(C4Particle *forParticle)
 {
 	return startValue + (endValue - startValue) * forParticle->GetRelativeAge();
@@ -408,18 +460,21 @@ float C4ParticleValueProvider::Const(C4Particle *forParticle)
 
 float C4ParticleValueProvider::Random(C4Particle *forParticle)
 {
-	if ((rerollInterval != 0 && ((int)forParticle->GetAge() % rerollInterval == 0)) || alreadyRolled == 0)
-	{
-		alreadyRolled = 1;
-		RollRandom();
-	}
-	return currentValue;
+	// a hash of the particle's seed instead of a stored roll, so that particles can share the provider
+	// rerolls start a new hash every rerollInterval frames
+	uint32_t roll = rerollInterval > 0 ? (uint32_t)((int)forParticle->GetAge() / rerollInterval) : 0;
+	uint32_t hash = forParticle->GetRandomSeed() ^ (randomSalt * 0x9e3779b9u) ^ (roll * 0x85ebca6bu);
+	hash ^= hash >> 16; hash *= 0x7feb352du;
+	hash ^= hash >> 15; hash *= 0x846ca68bu;
+	hash ^= hash >> 16;
+	float rnd = (float)(hash >> 8) / (float)(1 << 24);
+	return startValue + rnd * (endValue - startValue);
 }
 
 float C4ParticleValueProvider::Direction(C4Particle *forParticle)
 {
-	float distX = forParticle->currentSpeedX;
-	float distY = forParticle->currentSpeedY;
+	float distX = forParticle->GetSpeedX();
+	float distY = forParticle->GetSpeedY();
 
 	if (distX == 0.f) return distY > 0.f ? M_PI : 0.f;
 	if (distY == 0.f) return distX < 0.f ? 3.0f * M_PI_2 : M_PI_2;
@@ -467,8 +522,8 @@ float C4ParticleValueProvider::Sin(C4Particle *forParticle)
 
 float C4ParticleValueProvider::Speed(C4Particle *forParticle)
 {
-	float distX = forParticle->currentSpeedX;
-	float distY = forParticle->currentSpeedY;
+	float distX = forParticle->GetSpeedX();
+	float distY = forParticle->GetSpeedY();
 	float speed = sqrtf((distX * distX) + (distY * distY));
 
 	return startValue + speedFactor * speed;
@@ -476,7 +531,7 @@ float C4ParticleValueProvider::Speed(C4Particle *forParticle)
 
 float C4ParticleValueProvider::Wind(C4Particle *forParticle)
 {
-	return startValue + (0.01f * speedFactor * ::Weather.GetWind((int)forParticle->positionX, (int)forParticle->positionY));
+	return startValue + (0.01f * speedFactor * ::Weather.GetWind((int)forParticle->GetPositionX(), (int)forParticle->GetPositionY()));
 }
 
 float C4ParticleValueProvider::Gravity(C4Particle *forParticle)
@@ -495,7 +550,11 @@ void C4ParticleValueProvider::SetType(C4ParticleValueProviderID what)
 		valueFunction = &C4ParticleValueProvider::Linear;
 		break;
 	case C4PV_Random:
-		valueFunction = &C4ParticleValueProvider::Random;
+		{
+			static uint32_t nextRandomSalt = 0;
+			valueFunction = &C4ParticleValueProvider::Random;
+			randomSalt = ++nextRandomSalt;
+		}
 		break;
 	case C4PV_Direction:
 		valueFunction = &C4ParticleValueProvider::Direction;
@@ -564,7 +623,6 @@ void C4ParticleValueProvider::Set(const C4ValueArray &fromArray)
 			SetParameterValue(VAL_TYPE_FLOAT, fromArray[2], &C4ParticleValueProvider::endValue);
 			if (arraySize >= 4)
 				SetParameterValue(VAL_TYPE_INT, fromArray[3], 0, &C4ParticleValueProvider::rerollInterval);
-			alreadyRolled = 0;
 		}
 		break;
 	case C4PV_Direction:
@@ -669,6 +727,8 @@ void C4ParticleValueProvider::Set(float to)
 
 C4ParticleProperties::C4ParticleProperties()
 {
+	refCount = 0;
+	isShareable = true;
 	blitMode = 0;
 	attachment = C4ATTACH_None;
 	hasConstantColor = false;
@@ -713,6 +773,10 @@ void C4ParticleProperties::Floatify()
 	phase.Floatify(1.f);
 
 	hasConstantColor = colorR.IsConstant() && colorG.IsConstant() && colorB.IsConstant() && colorAlpha.IsConstant();
+	isShareable = !size.HasChildren() && !stretch.HasChildren() && !forceX.HasChildren() && !forceY.HasChildren()
+	              && !speedDampingX.HasChildren() && !speedDampingY.HasChildren()
+	              && !colorR.HasChildren() && !colorG.HasChildren() && !colorB.HasChildren() && !colorAlpha.HasChildren()
+	              && !rotation.HasChildren() && !phase.HasChildren() && !collisionVertex.HasChildren() && !collisionDensity.HasChildren();
 }
 
 void C4ParticleProperties::Set(C4PropList *dataSource)
@@ -836,31 +900,37 @@ void C4ParticleProperties::SetCollisionFunc(const C4Value &source)
 
 bool C4ParticleProperties::CollisionBounce(C4Particle *forParticle)
 {
-	forParticle->currentSpeedX = -forParticle->currentSpeedX * bouncyness;
-	forParticle->currentSpeedY = -forParticle->currentSpeedY * bouncyness;
+	forParticle->SetSpeed(-forParticle->GetSpeedX() * bouncyness, -forParticle->GetSpeedY() * bouncyness);
 	return true;
 }
 
 bool C4ParticleProperties::CollisionStop(C4Particle *forParticle)
 {
-	forParticle->currentSpeedX = 0.f;
-	forParticle->currentSpeedY = 0.f;
+	forParticle->SetSpeed(0.f, 0.f);
 	return true;
 }
 
-void C4Particle::Init()
+void C4Particle::SetPosition(float x, float y)
 {
-	currentSpeedX = currentSpeedY = 0.f;
-	positionX = positionY = 0.f;
-	lifetime = startingLifetime = 5.f * 38.f;
+	chunk->positionX[index] = x;
+	chunk->positionY[index] = y;
+	C4ParticleProperties &properties = GetProperties();
+	GetDrawingData().SetPosition(GetVertices(), x, y, properties.size.GetValue(this), properties.rotation.GetValue(this));
 }
 
 bool C4Particle::Exec(C4Object *obj, float timeDelta, C4ParticleDef *sourceDef)
 {
+	float &lifetime = chunk->lifetime[index];
+	float &currentSpeedX = chunk->speedX[index], &currentSpeedY = chunk->speedY[index];
+	float &positionX = chunk->positionX[index], &positionY = chunk->positionY[index];
+	C4ParticleProperties &properties = GetProperties();
+	DrawingData &drawingData = GetDrawingData();
+	DrawingData::Vertex *vertices = GetVertices();
+
 	// die of old age? :<
 	lifetime -= timeDelta;
 	// check only if we had a maximum lifetime to begin with (for permanent particles)
-	if (startingLifetime > 0.f)
+	if (chunk->startingLifetime[index] > 0.f)
 	{
 		if (lifetime <= 0.f) return false;
 	}
@@ -905,23 +975,23 @@ bool C4Particle::Exec(C4Object *obj, float timeDelta, C4ParticleDef *sourceDef)
 			positionX += timeDelta * currentSpeedX;
 			positionY += timeDelta * currentSpeedY;
 		}
-		drawingData.SetPosition(positionX, positionY, size, properties.rotation.GetValue(this), properties.stretch.GetValue(this));
+		drawingData.SetPosition(vertices, positionX, positionY, size, properties.rotation.GetValue(this), properties.stretch.GetValue(this));
 
 	}
 	else if(!properties.size.IsConstant() || !properties.rotation.IsConstant() || !properties.stretch.IsConstant())
 	{
-		drawingData.SetPosition(positionX, positionY, properties.size.GetValue(this), properties.rotation.GetValue(this), properties.stretch.GetValue(this));
+		drawingData.SetPosition(vertices, positionX, positionY, properties.size.GetValue(this), properties.rotation.GetValue(this), properties.stretch.GetValue(this));
 	}
 
 	// adjust color
 	if (!properties.hasConstantColor)
 	{
-		drawingData.SetColor(properties.colorR.GetValue(this), properties.colorG.GetValue(this), properties.colorB.GetValue(this), properties.colorAlpha.GetValue(this));
+		DrawingData::SetColor(vertices, properties.colorR.GetValue(this), properties.colorG.GetValue(this), properties.colorB.GetValue(this), properties.colorAlpha.GetValue(this));
 	}
 
 	int currentPhase = (int)(properties.phase.GetValue(this) + 0.5f);
 	if (currentPhase != drawingData.phase)
-		drawingData.SetPhase(currentPhase, sourceDef);
+		drawingData.SetPhase(vertices, currentPhase, sourceDef);
 
 	return true;
 }
@@ -930,39 +1000,188 @@ void C4ParticleChunk::Clear()
 {
 	for (size_t i = 0; i < particleCount; ++i)
 	{
-		delete particles[i];
+		particleProperties[i]->DecRef();
 	}
 	particleCount = 0;
-	particles.clear();
-	vertexCoordinates.clear();
+	ResizeArrays(0);
 
 	ClearBufferObjects();
 }
 
-void C4ParticleChunk::DeleteAndReplaceParticle(size_t indexToReplace, size_t indexFrom)
+void C4ParticleChunk::ResizeArrays(size_t size)
+{
+	lifetime.resize(size);
+	startingLifetime.resize(size);
+	positionX.resize(size);
+	positionY.resize(size);
+	speedX.resize(size);
+	speedY.resize(size);
+	randomSeed.resize(size);
+	particleProperties.resize(size);
+	drawingData.resize(size);
+	vertexCoordinates.resize(size * C4Particle::DrawingData::vertexCountPerParticle);
+}
+
+void C4ParticleChunk::MoveParticle(size_t indexFrom, size_t indexTo)
 {
-	C4Particle *oldParticle = particles[indexToReplace];
+	lifetime[indexTo] = lifetime[indexFrom];
+	startingLifetime[indexTo] = startingLifetime[indexFrom];
+	positionX[indexTo] = positionX[indexFrom];
+	positionY[indexTo] = positionY[indexFrom];
+	speedX[indexTo] = speedX[indexFrom];
+	speedY[indexTo] = speedY[indexFrom];
+	randomSeed[indexTo] = randomSeed[indexFrom];
+	particleProperties[indexTo] = particleProperties[indexFrom];
+	drawingData[indexTo] = drawingData[indexFrom];
+	const int vertexCount = C4Particle::DrawingData::vertexCountPerParticle;
+	std::copy(&vertexCoordinates[indexFrom * vertexCount], &vertexCoordinates[indexFrom * vertexCount] + vertexCount, &vertexCoordinates[indexTo * vertexCount]);
+}
 
-	// try to replace the soon-to-be empty slot in the array
-	if (indexFrom != indexToReplace) // false when "replacing" the last one
+void C4ParticleChunk::ExecRange(C4Object *obj, float timeDelta, size_t begin, size_t end)
+{
+	while (begin < end)
 	{
-		std::copy(&vertexCoordinates[indexFrom * C4Particle::DrawingData::vertexCountPerParticle], &vertexCoordinates[indexFrom * C4Particle::DrawingData::vertexCountPerParticle] + C4Particle::DrawingData::vertexCountPerParticle, &vertexCoordinates[indexToReplace * C4Particle::DrawingData::vertexCountPerParticle]);
-		particles[indexToReplace] = particles[indexFrom];
-		particles[indexToReplace]->drawingData.SetPointer(&vertexCoordinates[indexToReplace * C4Particle::DrawingData::vertexCountPerParticle]);
+		// particles that were created together share their properties
+		C4ParticleProperties *properties = particleProperties[begin];
+		size_t runEnd = begin + 1;
+		while (runEnd < end && particleProperties[runEnd] == properties) ++runEnd;
+
+		if (properties->isShareable)
+		{
+			ExecBatch(obj, timeDelta, begin, runEnd, *properties);
+		}
+		else
+		{
+			for (size_t i = begin; i < runEnd; ++i)
+				particleDead[i] = !C4Particle(this, i).Exec(obj, timeDelta, sourceDefinition);
+		}
+		begin = runEnd;
 	}
+}
+
+void C4ParticleChunk::ExecBatch(C4Object *obj, float timeDelta, size_t begin, size_t end, C4ParticleProperties &properties)
+{
+	// does the same as C4Particle::Exec, one step at a time for all of the particles
+	// the loops over whole arrays can be vectorized by the compiler
+	const size_t batchSize = 256;
+	float valuesA[batchSize], valuesB[batchSize], valuesC[batchSize], valuesD[batchSize], sizes[batchSize];
+	char moving[batchSize], collided[batchSize];
+	const bool constantPosition = properties.size.IsConstant() && properties.rotation.IsConstant() && properties.stretch.IsConstant();
+
+	for (; begin < end; begin += batchSize)
+	{
+		const size_t count = std::min(end - begin, batchSize);
+		float *lifetime = &this->lifetime[begin], *startingLifetime = &this->startingLifetime[begin];
+		float *positionX = &this->positionX[begin], *positionY = &this->positionY[begin];
+		float *speedX = &this->speedX[begin], *speedY = &this->speedY[begin];
+		char *dead = &particleDead[begin];
+
+		// die of old age, if there was a maximum lifetime to begin with
+		// dead particles are calculated along with the others, but removed afterwards
+		for (size_t i = 0; i < count; ++i)
+		{
+			lifetime[i] -= timeDelta;
+			dead[i] = startingLifetime[i] > 0.f && lifetime[i] <= 0.f;
+		}
+
+		// movement
+		properties.forceX.GetValues(*this, begin, begin + count, valuesA);
+		properties.forceY.GetValues(*this, begin, begin + count, valuesB);
+		for (size_t i = 0; i < count; ++i)
+		{
+			speedX[i] += valuesA[i];
+			speedY[i] += valuesB[i];
+			moving[i] = speedX[i] != 0.f || speedY[i] != 0.f;
+			collided[i] = 0;
+		}
+		properties.speedDampingX.GetValues(*this, begin, begin + count, valuesA);
+		properties.speedDampingY.GetValues(*this, begin, begin + count, valuesB);
+		properties.size.GetValues(*this, begin, begin + count, sizes);
+		for (size_t i = 0; i < count; ++i)
+		{
+			speedX[i] *= moving[i] ? valuesA[i] : 1.f;
+			speedY[i] *= moving[i] ? valuesB[i] : 1.f;
+		}
+
+		// collision check
+		if (properties.hasCollisionVertex)
+		{
+			properties.collisionVertex.GetValues(*this, begin, begin + count, valuesA);
+			properties.collisionDensity.GetValues(*this, begin, begin + count, valuesB);
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (!moving[i] || dead[i]) continue;
+				float size_x = (speedX[i] > 0.f ? sizes[i] : -sizes[i]) * 0.5f * valuesA[i];
+				float size_y = (speedY[i] > 0.f ? sizes[i] : -sizes[i]) * 0.5f * valuesA[i];
+				float density = static_cast<float>(GBackDensity(positionX[i] + size_x + timeDelta * speedX[i], positionY[i] + size_y + timeDelta * speedY[i]));
+				if (density + 0.5f >= valuesB[i])
+				{
+					C4Particle particle(this, begin + i);
+					if (properties.collisionCallback != 0 && !(properties.*properties.collisionCallback)(&particle))
+						dead[i] = 1;
+					collided[i] = 1;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			float step = (moving[i] && !collided[i]) ? timeDelta : 0.f;
+			positionX[i] += step * speedX[i];
+			positionY[i] += step * speedY[i];
+		}
+
+		// write the vertices
+		const int vertexCount = C4Particle::DrawingData::vertexCountPerParticle;
+		C4Particle::DrawingData *drawingData = &this->drawingData[begin];
+		C4Particle::DrawingData::Vertex *vertices = &vertexCoordinates[begin * vertexCount];
+		properties.rotation.GetValues(*this, begin, begin + count, valuesA);
+		properties.stretch.GetValues(*this, begin, begin + count, valuesB);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (moving[i] || !constantPosition)
+				drawingData[i].SetPosition(vertices + i * vertexCount, positionX[i], positionY[i], sizes[i], valuesA[i], valuesB[i]);
+		}
+
+		if (!properties.hasConstantColor)
+		{
+			properties.colorR.GetValues(*this, begin, begin + count, valuesA);
+			properties.colorG.GetValues(*this, begin, begin + count, valuesB);
+			properties.colorB.GetValues(*this, begin, begin + count, valuesC);
+			properties.colorAlpha.GetValues(*this, begin, begin + count, valuesD);
+			for (size_t i = 0; i < count; ++i)
+				C4Particle::DrawingData::SetColor(vertices + i * vertexCount, valuesA[i], valuesB[i], valuesC[i], valuesD[i]);
+		}
 
-	delete oldParticle;
+		properties.phase.GetValues(*this, begin, begin + count, valuesA);
+		for (size_t i = 0; i < count; ++i)
+		{
+			int currentPhase = (int)(valuesA[i] + 0.5f);
+			if (currentPhase != drawingData[i].phase)
+				drawingData[i].SetPhase(vertices + i * vertexCount, currentPhase, sourceDefinition);
+		}
+	}
 }
 
-bool C4ParticleChunk::Exec(C4Object *obj, float timeDelta)
+bool C4ParticleChunk::RemoveDeadParticles()
 {
+	// keep the order, so that particles with shared properties stay next to each other
+	size_t remaining = 0;
 	for (size_t i = 0; i < particleCount; ++i)
 	{
-		if (!particles[i]->Exec(obj, timeDelta, sourceDefinition))
+		if (particleDead[i])
 		{
-			DeleteAndReplaceParticle(i, particleCount - 1);
-			--particleCount;
+			particleProperties[i]->DecRef();
+			continue;
 		}
+		if (remaining != i)
+			MoveParticle(i, remaining);
+		++remaining;
+	}
+	if (remaining != particleCount)
+	{
+		particleCount = remaining;
+		ResizeArrays(particleCount);
 	}
 	return particleCount > 0;
 }
@@ -1047,6 +1266,7 @@ void C4ParticleChunk::Draw(C4TargetFacet cgo, C4Object *obj, C4ShaderCall& call,
 		glVertexAttribPointer(call.GetAttribute(C4SSA_Color), 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<GLvoid*>(offsetof(C4Particle::DrawingData::Vertex, r)));
 	}
 
+	++pDraw->DrawCalls;
 	glDrawElements(GL_TRIANGLE_STRIP, static_cast<GLsizei> (5 * particleCount), GL_UNSIGNED_INT, 0);
 
 	// reset buffer data
@@ -1073,58 +1293,45 @@ void C4ParticleChunk::ReserveSpace(uint32_t forAmount)
 {
 	uint32_t newSize = static_cast<uint32_t>(particleCount) + forAmount + 1;
 	::Particles.PreparePrimitiveRestartIndices(newSize);
-	if (particles.capacity() < newSize)
-		particles.reserve(std::max<uint32_t>(newSize, particles.capacity() * 2));
+	if (lifetime.capacity() >= newSize) return;
 
-	// resizing the points vector is relatively costly, hopefully we only do it rarely
-	while (vertexCoordinates.capacity() <= newSize * C4Particle::DrawingData::vertexCountPerParticle)
-	{
-		vertexCoordinates.reserve(std::max<uint32_t>(C4Particle::DrawingData::vertexCountPerParticle * newSize, vertexCoordinates.capacity() * 2));
-
-		// update all existing particles' pointers..
-		for (size_t i = 0; i < particleCount; ++i)
-			particles[i]->drawingData.SetPointer(&vertexCoordinates[i * C4Particle::DrawingData::vertexCountPerParticle]);
-	}
+	// all of the arrays grow together
+	size_t capacity = std::max<size_t>(newSize, lifetime.capacity() * 2);
+	lifetime.reserve(capacity);
+	startingLifetime.reserve(capacity);
+	positionX.reserve(capacity);
+	positionY.reserve(capacity);
+	speedX.reserve(capacity);
+	speedY.reserve(capacity);
+	randomSeed.reserve(capacity);
+	particleProperties.reserve(capacity);
+	drawingData.reserve(capacity);
+	vertexCoordinates.reserve(capacity * C4Particle::DrawingData::vertexCountPerParticle);
 }
 
-C4Particle *C4ParticleChunk::AddNewParticle()
+C4Particle C4ParticleChunk::AddNewParticle(C4ParticleProperties *properties)
 {
 	size_t currentIndex = particleCount++;
+	ResizeArrays(particleCount);
 
-	if (currentIndex < particles.size())
-	{
-		particles[currentIndex] = new C4Particle();
-	}
-	else
-	{
-		particles.push_back(new C4Particle());
-		vertexCoordinates.resize(vertexCoordinates.size() + C4Particle::DrawingData::vertexCountPerParticle);
-	}
-
-	C4Particle *newParticle = particles[currentIndex];
-	newParticle->drawingData.SetPointer(&vertexCoordinates[currentIndex * C4Particle::DrawingData::vertexCountPerParticle], true);
-	return newParticle;
-}
-
-void C4ParticleList::Exec(float timeDelta)
-{
-	if (particleChunks.empty()) return;
-
-	accessMutex.Enter();
-
-	for (std::list<C4ParticleChunk*>::iterator iter = particleChunks.begin(); iter != particleChunks.end();++iter)
-	{
-		C4ParticleChunk *chunk = *iter;
-		chunk->Exec(targetObject, timeDelta);
-	}
+	lifetime[currentIndex] = startingLifetime[currentIndex] = 5.f * 38.f;
+	positionX[currentIndex] = positionY[currentIndex] = 0.f;
+	speedX[currentIndex] = speedY[currentIndex] = 0.f;
+	randomSeed[currentIndex] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+	properties->IncRef();
+	particleProperties[currentIndex] = properties;
+	drawingData[currentIndex] = C4Particle::DrawingData();
+	drawingData[currentIndex].InitVertices(&vertexCoordinates[currentIndex * C4Particle::DrawingData::vertexCountPerParticle]);
 
-	accessMutex.Leave();
+	return C4Particle(this, currentIndex);
 }
 
 void C4ParticleList::Draw(C4TargetFacet cgo, C4Object *obj)
 {
 	if (particleChunks.empty()) return;
 
+	// pending sprites must be drawn before the GL state is changed directly
+	pDraw->FlushBatch();
 	pDraw->DeactivateBlitModulation();
 	pDraw->ResetBlitMode();
 	
@@ -1229,7 +1436,7 @@ void C4ParticleSystem::CalculationThread::Execute()
 	Particles.ExecuteCalculation();
 }
 
-C4ParticleSystem::C4ParticleSystem() : frameCounterAdvancedEvent(false)
+C4ParticleSystem::C4ParticleSystem() : calculationPoolSetting(0), frameCounterAdvancedEvent(false)
 {
 	currentSimulationTime = 0;
 	globalParticles = 0;
@@ -1258,16 +1465,158 @@ void C4ParticleSystem::ExecuteCalculation()
 			timeDelta = (float)(gameTime - currentSimulationTime);
 		currentSimulationTime = gameTime;
 
+		// the global lock is only held while collecting the lists; locking them keeps them alive until they are done
 		particleListAccessMutex.Enter();
 
+		calculation.lists.clear();
 		for (std::list<C4ParticleList>::iterator iter = particleLists.begin(); iter != particleLists.end(); ++iter)
 		{
-			iter->Exec(timeDelta);
+			if (iter->IsEmpty()) continue;
+			iter->Lock();
+			CalculationList list = { &(*iter), 0, false, false };
+			calculation.lists.push_back(list);
 		}
 
 		particleListAccessMutex.Leave();
+
+		if (calculationPoolSetting != Config.General.WorkerThreads)
+		{
+			calculationPoolSetting = Config.General.WorkerThreads;
+			calculationPool.SetThreadCount(calculationPoolSetting);
+		}
+		ExecuteLists(calculation, timeDelta, calculationPool);
 	}
 }
+
+void C4ParticleSystem::ExecuteLists(Calculation &calc, float timeDelta, StdWorkerPool &pool)
+{
+	// big chunks are split so that all threads get a share of them
+	const size_t particlesPerJob = 512;
+	calc.jobs.clear();
+	for (size_t index = 0; index < calc.lists.size(); ++index)
+	{
+		CalculationList &list = calc.lists[index];
+		list.pendingJobs = 0;
+		list.calculated = list.unlocked = false;
+		for (std::list<C4ParticleChunk*>::iterator iter = list.list->particleChunks.begin(); iter != list.list->particleChunks.end(); ++iter)
+		{
+			C4ParticleChunk *chunk = *iter;
+			chunk->PrepareExecRange();
+			for (size_t begin = 0; begin < chunk->particleCount; begin += particlesPerJob)
+			{
+				CalculationJob job = { chunk, list.list->targetObject, begin, std::min(begin + particlesPerJob, chunk->particleCount), timeDelta, index };
+				calc.jobs.push_back(job);
+				++list.pendingJobs;
+			}
+		}
+		if (!list.pendingJobs) FinishList(calc, list);
+	}
+	UnlockCalculatedLists(&calc);
+
+	// the lists are unlocked on this thread, which locked them, while the other threads go on
+	if (!calc.jobs.empty())
+		pool.Run(&ExecuteJobs, &calc, calc.jobs.size(), 1, &UnlockCalculatedLists);
+}
+
+void C4ParticleSystem::ExecuteJobs(void *data, int32_t begin, int32_t end)
+{
+	Calculation *calc = static_cast<Calculation *>(data);
+	for (int32_t i = begin; i < end; ++i)
+	{
+		CalculationJob &job = calc->jobs[i];
+		job.chunk->ExecRange(job.obj, job.timeDelta, job.begin, job.end);
+		CalculationList &list = calc->lists[job.list];
+		bool last;
+		{
+			CStdLock lock(&calc->mutex);
+			last = !--list.pendingJobs;
+		}
+		if (last) FinishList(*calc, list);
+	}
+}
+
+void C4ParticleSystem::FinishList(Calculation &calc, CalculationList &list)
+{
+	// no other job works on the list anymore, and particles only move within their chunk
+	for (std::list<C4ParticleChunk*>::iterator iter = list.list->particleChunks.begin(); iter != list.list->particleChunks.end(); ++iter)
+		(*iter)->RemoveDeadParticles();
+	CStdLock lock(&calc.mutex);
+	list.calculated = true;
+}
+
+void C4ParticleSystem::UnlockCalculatedLists(void *data)
+{
+	Calculation *calc = static_cast<Calculation *>(data);
+	CStdLock lock(&calc->mutex);
+	for (std::vector<CalculationList>::iterator list = calc->lists.begin(); list != calc->lists.end(); ++list)
+		if (list->calculated && !list->unlocked)
+		{
+			list->list->Unlock();
+			list->unlocked = true;
+		}
+}
+
+void C4ParticleSystem::Benchmark(int32_t count)
+{
+	C4ParticleDef *def = definitions.first;
+	if (!def)
+	{
+		Log("Particle benchmark: no particle definitions loaded");
+		return;
+	}
+	// falling particles that fade and grow, with varying lifetimes so that some die during the run
+	// uses its own random numbers so the game is not affected
+	uint32_t seed = 12345;
+	auto random = [&seed](int32_t range) { seed = seed * 1103515245 + 12345; return int32_t((seed >> 8) % range); };
+	C4ValueArray fade(3), grow(3);
+	fade[0] = C4VInt(C4PV_Linear); fade[1] = C4VInt(255); fade[2] = C4VInt(0);
+	grow[0] = C4VInt(C4PV_Linear); grow[1] = C4VInt(4); grow[2] = C4VInt(16);
+	C4ParticleProperties properties;
+	properties.forceY.Set(5.f);
+	properties.colorAlpha.Set(fade);
+	properties.size.Set(grow);
+
+	const int32_t steps = 100;
+	StdWorkerPool serial, pool;
+	pool.SetThreadCount(Config.General.WorkerThreads);
+	double rates[2];
+	for (int32_t run = 0; run < 2; ++run)
+	{
+		// a list of its own, which the calculation thread does not know about
+		C4ParticleList list;
+		C4ParticleChunk *chunk = list.GetFittingParticleChunk(def, 0, C4ATTACH_None, false);
+		// AddNewParticle is used without ReserveSpace, which would prepare the index buffer
+		seed = 12345;
+		C4ParticleProperties *shared = new C4ParticleProperties(properties);
+		shared->Floatify();
+		for (int32_t i = 0; i < count; ++i)
+		{
+			C4Particle particle = chunk->AddNewParticle(shared);
+			particle.SetLifetime((float)(20 + random(100)));
+			particle.SetSpeed((float)(random(200) - 100) / 10.f, (float)(random(200) - 100) / 10.f);
+			particle.GetDrawingData().aspect = def->Aspect;
+			particle.SetPosition((float)random(1000), (float)random(1000));
+			particle.GetDrawingData().SetPhase(particle.GetVertices(), 0, def);
+		}
+
+		Calculation calc;
+		CalculationList calcList = { &list, 0, false, false };
+		calc.lists.push_back(calcList);
+		size_t updates = 0;
+		typedef std::chrono::steady_clock Clock;
+		Clock::time_point start = Clock::now();
+		for (int32_t step = 0; step < steps; ++step)
+		{
+			updates += chunk->particleCount;
+			list.Lock();
+			ExecuteLists(calc, 1.f, run ? pool : serial);
+		}
+		double time = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		rates[run] = time > 0.0 ? updates / time : 0.0;
+	}
+	LogF("Particle benchmark: %d particles, %d steps: %.0f particles/ms on one thread, %.0f particles/ms with %d worker threads",
+	     (int) count, (int) steps, rates[0], rates[1], (int) pool.GetThreadCount());
+}
 #endif
 
 C4ParticleList *C4ParticleSystem::GetNewParticleList(C4Object *forObject)
@@ -1378,34 +1727,35 @@ void C4ParticleSystem::Create(C4ParticleDef *of_def, C4ParticleValueProvider &x,
 	// set up chunk to be able to contain enough particles
 	chunk->ReserveSpace(static_cast<uint32_t>(amount));
 
+	// this will adjust the initial values of the particle properties
+	particleProperties.Floatify();
+	// particles that are created together share their properties, unless they have to be evaluated one by one
+	C4ParticleProperties *sharedProperties = NULL;
+
 	while (amount--)
 	{
-		if (x.IsRandom()) x.RollRandom();
-		if (y.IsRandom()) y.RollRandom();
-		if (speedX.IsRandom()) speedX.RollRandom();
-		if (speedY.IsRandom()) speedY.RollRandom();
-		if (lifetime.IsRandom()) lifetime.RollRandom();
-		
-		// create a particle in the fitting chunk (note that we tell the particle list, we already locked it)
-		C4Particle *particle = chunk->AddNewParticle();
+		C4ParticleProperties *ownProperties = sharedProperties;
+		if (!ownProperties)
+		{
+			ownProperties = new C4ParticleProperties(particleProperties);
+			if (particleProperties.isShareable) sharedProperties = ownProperties;
+		}
 
-		// initialize some more properties
-		particle->properties = particleProperties;
-		// this will adjust the initial values of the (possibly cached) particle properties
-		particle->properties.Floatify();
+		// create a particle in the fitting chunk (note that we tell the particle list, we already locked it)
+		C4Particle particle = chunk->AddNewParticle(ownProperties);
 
 		// setup some more non-property attributes of the particle
-		float lifetime_value = lifetime.GetValue(particle);
+		float lifetime_value = lifetime.GetValue(&particle);
 		if (lifetime_value < 0.0f) lifetime_value = 0.0f; // negative values not allowed (would crash later); using a value of 0 is most likely visible to the scripter
-		particle->lifetime = particle->startingLifetime = lifetime_value;
-
-		particle->currentSpeedX = speedX.GetValue(particle);
-		particle->currentSpeedY = speedY.GetValue(particle);
-		particle->drawingData.aspect = of_def->Aspect;
-		particle->drawingData.SetOffset(drawingOffsetX, drawingOffsetY);
-		particle->SetPosition(x.GetValue(particle) + xoff, y.GetValue(particle) + yoff);
-		particle->drawingData.SetColor(particle->properties.colorR.GetValue(particle), particle->properties.colorG.GetValue(particle), particle->properties.colorB.GetValue(particle), particle->properties.colorAlpha.GetValue(particle));
-		particle->drawingData.SetPhase((int)(particle->properties.phase.GetValue(particle) + 0.5f), of_def);
+		particle.SetLifetime(lifetime_value);
+
+		particle.SetSpeed(speedX.GetValue(&particle), speedY.GetValue(&particle));
+		C4Particle::DrawingData &drawingData = particle.GetDrawingData();
+		drawingData.aspect = of_def->Aspect;
+		drawingData.SetOffset(drawingOffsetX, drawingOffsetY);
+		particle.SetPosition(x.GetValue(&particle) + xoff, y.GetValue(&particle) + yoff);
+		C4Particle::DrawingData::SetColor(particle.GetVertices(), ownProperties->colorR.GetValue(&particle), ownProperties->colorG.GetValue(&particle), ownProperties->colorB.GetValue(&particle), ownProperties->colorAlpha.GetValue(&particle));
+		drawingData.SetPhase(particle.GetVertices(), (int)(ownProperties->phase.GetValue(&particle) + 0.5f), of_def);
 	}
 
 	pxList->Unlock();
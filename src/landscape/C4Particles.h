@@ -16,6 +16,7 @@
 #include <C4FacetEx.h>
 
 #include <StdScheduler.h>
+#include <StdWorkerPool.h>
 
 
 #ifndef INC_C4Particles
@@ -103,8 +104,10 @@ class C4ParticleValueProvider
 private:
 	float startValue, endValue;
 
-	// used by Random
+	// used by Step
 	float currentValue;
+	// used by Random to tell the providers of one particle apart
+	uint32_t randomSalt;
 
 	union
 	{
@@ -116,7 +119,6 @@ private:
 
 	union
 	{
-		int alreadyRolled; // for Random
 		int smoothing; // for KeyFrames
 		float maxValue; // for Step & Sin
 	};
@@ -145,9 +147,9 @@ private:
 
 public:
 	bool IsConstant() const { return isConstant; }
-	bool IsRandom() const { return valueFunction == &C4ParticleValueProvider::Random; }
+	bool HasChildren() const { return !childrenValueProviders.empty(); }
 	C4ParticleValueProvider() :
-		startValue(0.f), endValue(0.f), currentValue(0.f), rerollInterval(0), smoothing(0), keyFrameCount(0), valueFunction(0), isConstant(true), floatValueToChange(0), typeOfValueToChange(VAL_TYPE_FLOAT)
+		startValue(0.f), endValue(0.f), currentValue(0.f), randomSalt(0), rerollInterval(0), smoothing(0), keyFrameCount(0), valueFunction(0), isConstant(true), floatValueToChange(0), typeOfValueToChange(VAL_TYPE_FLOAT)
 	{ }
 	~C4ParticleValueProvider()
 	{
@@ -156,7 +158,6 @@ public:
 	}
 	C4ParticleValueProvider(const C4ParticleValueProvider &other) { *this = other; }
 	C4ParticleValueProvider & operator= (const C4ParticleValueProvider &other);
-	void RollRandom();
 
 	// divides by denominator
 	void Floatify(float denominator);
@@ -165,6 +166,8 @@ public:
 	void Set(const C4ValueArray &fromArray);
 	void Set(float to); // constant
 	float GetValue(C4Particle *forParticle);
+	// the values for the particles [begin, end) of a chunk; only for providers without children
+	void GetValues(C4ParticleChunk &chunk, size_t begin, size_t end, float *values);
 
 private:
 	void UpdatePointerValue(C4Particle *particle, C4ParticleValueProvider *parent);
@@ -185,12 +188,17 @@ private:
 	float Gravity(C4Particle *forParticle);
 };
 
-// the properties are part of every particle and contain certain changeable attributes
+// the properties contain certain changeable attributes of particles
+// particles that are created together share them, unless one of the value providers has children
 class C4ParticleProperties
 {
+private:
+	int32_t refCount; // number of particles using these properties
+
 public:
 	bool hasConstantColor;
 	bool hasCollisionVertex;
+	bool isShareable; // no value provider has children, so the providers are never changed during evaluation
 
 	C4ParticleValueProvider size, stretch;
 	C4ParticleValueProvider forceX, forceY;
@@ -210,7 +218,9 @@ public:
 
 	C4ParticleProperties();
 
-	
+	void IncRef() { ++refCount; }
+	void DecRef() { if (!--refCount) delete this; }
+
 	void Set(C4PropList *dataSource);
 	// divides ints in certain properties by 1000f and in the color properties by 255f
 	void Floatify();
@@ -221,7 +231,7 @@ public:
 	bool CollisionStop(C4Particle *forParticle);
 };
 
-// one single particle
+// one single particle; its data lives in the arrays of its chunk
 class C4Particle
 {
 public:
@@ -243,7 +253,6 @@ public:
 			float b;
 			float alpha;
 		};
-		Vertex *vertices;
 		
 		int phase;
 
@@ -260,24 +269,19 @@ public:
 			offsetY = y;
 		}
 
-		void SetPointer(Vertex *startingVertex, bool initial = false)
+		void InitVertices(Vertex *vertices)
 		{
-			vertices = startingVertex;
+			vertices[0].u = 0.f; vertices[0].v = 1.f;
+			vertices[1].u = 0.f; vertices[1].v = 0.f;
+			vertices[2].u = 1.f; vertices[2].v = 1.f;
+			vertices[3].u = 1.f; vertices[3].v = 0.f;
 
-			if (initial)
-			{
-				vertices[0].u = 0.f; vertices[0].v = 1.f;
-				vertices[1].u = 0.f; vertices[1].v = 0.f;
-				vertices[2].u = 1.f; vertices[2].v = 1.f;
-				vertices[3].u = 1.f; vertices[3].v = 0.f;
+			SetColor(vertices, 1.f, 1.f, 1.f, 1.f);
 
-				SetColor(1.f, 1.f, 1.f, 1.f);
-
-				phase = -1;
-			}
+			phase = -1;
 		}
 
-		void SetColor(float r, float g, float b, float a = 1.0f)
+		static void SetColor(Vertex *vertices, float r, float g, float b, float a = 1.0f)
 		{
 			for (int vertex = 0; vertex < 4; ++vertex)
 			{
@@ -288,45 +292,42 @@ public:
 			}
 		}
 
-		void SetPosition(float x, float y, float size, float rotation = 0.f, float stretch = 1.f);
-		void SetPhase(int phase, C4ParticleDef *sourceDef);
+		void SetPosition(Vertex *vertices, float x, float y, float size, float rotation = 0.f, float stretch = 1.f);
+		void SetPhase(Vertex *vertices, int phase, C4ParticleDef *sourceDef);
 
 		DrawingData() : currentStretch(1.f), originalSize(0.0001f), aspect(1.f), offsetX(0.f), offsetY(0.f)
 		{
 		}
 
-	} drawingData;
-protected:
-	float currentSpeedX, currentSpeedY;
-	float positionX, positionY;
-	float lifetime, startingLifetime;
-
-	C4ParticleProperties properties;
+	};
+private:
+	C4ParticleChunk *chunk;
+	size_t index;
 
 public:
-	float GetAge() const { return startingLifetime - lifetime; }
-	float GetLifetime() const { return lifetime; }
-	float GetRelativeAge() const { return (startingLifetime != 0.f) ? (1.0f - (lifetime / startingLifetime)) : 0.f; }
-
-	void Init();
-	C4Particle() { Init(); }
-
-	void SetPosition(float x, float y)
-	{
-		positionX = x;
-		positionY = y;
-		drawingData.SetPosition(positionX, positionY, properties.size.GetValue(this),  properties.rotation.GetValue(this));
-	}
+	C4Particle(C4ParticleChunk *chunk, size_t index) : chunk(chunk), index(index) { }
+
+	inline float GetAge() const;
+	inline float GetLifetime() const;
+	inline float GetRelativeAge() const;
+	inline float GetSpeedX() const;
+	inline float GetSpeedY() const;
+	inline float GetPositionX() const;
+	inline float GetPositionY() const;
+	inline uint32_t GetRandomSeed() const;
+	inline C4ParticleProperties &GetProperties() const;
+	inline DrawingData &GetDrawingData() const;
+	inline DrawingData::Vertex *GetVertices() const;
+
+	inline void SetLifetime(float to);
+	inline void SetSpeed(float x, float y);
+	void SetPosition(float x, float y);
 
 	bool Exec(C4Object *obj, float timeDelta, C4ParticleDef *sourceDef);
-
-	friend class C4ParticleProperties;
-	friend class C4ParticleValueProvider;
-	friend class C4ParticleChunk;
-	friend class C4ParticleSystem;
 };
 
 // a chunk contains all of the single particles that can be drawn with one draw call (~"have certain similar attributes")
+// the particles are stored as one array per attribute, so that particles with shared properties can be calculated in batches
 class C4ParticleChunk
 {
 private:
@@ -337,17 +338,28 @@ private:
 	// whether the particles are translated according to the object's position
 	uint32_t attachment;
 
-	std::vector<C4Particle*> particles;
-	std::vector<C4Particle::DrawingData::Vertex> vertexCoordinates;
 	size_t particleCount;
+	std::vector<float> lifetime, startingLifetime;
+	std::vector<float> positionX, positionY;
+	std::vector<float> speedX, speedY;
+	std::vector<uint32_t> randomSeed;
+	// particles with the same properties are kept next to each other
+	std::vector<C4ParticleProperties*> particleProperties;
+	std::vector<C4Particle::DrawingData> drawingData;
+	std::vector<C4Particle::DrawingData::Vertex> vertexCoordinates;
+
+	// set by ExecRange for every particle, resolved by RemoveDeadParticles
+	std::vector<char> particleDead;
 
 	// OpenGL optimizations
 	GLuint drawingDataVertexBufferObject;
 	unsigned int drawingDataVertexArraysObject;
 	void ClearBufferObjects();
 
-	// delete the particle at indexTo. If possible, replace it with the particle at indexFrom to keep the particles tighly packed
-	void DeleteAndReplaceParticle(size_t indexToReplace, size_t indexFrom);
+	// calculates particles that share properties without children
+	void ExecBatch(C4Object *obj, float timeDelta, size_t begin, size_t end, C4ParticleProperties &properties);
+	void MoveParticle(size_t indexFrom, size_t indexTo);
+	void ResizeArrays(size_t size);
 
 public:
 	C4ParticleChunk() : sourceDefinition(0), blitMode(0), attachment(C4ATTACH_None), particleCount(0), drawingDataVertexBufferObject(0), drawingDataVertexArraysObject(0)
@@ -363,19 +375,43 @@ public:
 	}
 	// removes all particles
 	void Clear();
-	bool Exec(C4Object *obj, float timeDelta);
+	// ExecRange may run concurrently for disjoint ranges, RemoveDeadParticles afterwards
+	void PrepareExecRange() { particleDead.resize(particleCount); }
+	void ExecRange(C4Object *obj, float timeDelta, size_t begin, size_t end);
+	bool RemoveDeadParticles();
 	void Draw(C4TargetFacet cgo, C4Object *obj, C4ShaderCall& call, int texUnit, const StdProjectionMatrix& modelview);
 	bool IsOfType(C4ParticleDef *def, uint32_t _blitMode, uint32_t attachment) const;
 	bool IsEmpty() const { return !particleCount; }
 
 	// before adding a particle, you should ReserveSpace for it
-	C4Particle *AddNewParticle();
+	C4Particle AddNewParticle(C4ParticleProperties *properties);
 	// sets up internal data structures to be large enough for the passed amount of ADDITIONAL particles
 	void ReserveSpace(uint32_t forAmount);
 
+	friend class C4Particle;
+	friend class C4ParticleValueProvider;
 	friend class C4ParticleList;
+	friend class C4ParticleSystem;
 };
 
+float C4Particle::GetAge() const { return chunk->startingLifetime[index] - chunk->lifetime[index]; }
+float C4Particle::GetLifetime() const { return chunk->lifetime[index]; }
+float C4Particle::GetRelativeAge() const
+{
+	float startingLifetime = chunk->startingLifetime[index];
+	return (startingLifetime != 0.f) ? (1.0f - (chunk->lifetime[index] / startingLifetime)) : 0.f;
+}
+float C4Particle::GetSpeedX() const { return chunk->speedX[index]; }
+float C4Particle::GetSpeedY() const { return chunk->speedY[index]; }
+float C4Particle::GetPositionX() const { return chunk->positionX[index]; }
+float C4Particle::GetPositionY() const { return chunk->positionY[index]; }
+uint32_t C4Particle::GetRandomSeed() const { return chunk->randomSeed[index]; }
+C4ParticleProperties &C4Particle::GetProperties() const { return *chunk->particleProperties[index]; }
+C4Particle::DrawingData &C4Particle::GetDrawingData() const { return chunk->drawingData[index]; }
+C4Particle::DrawingData::Vertex *C4Particle::GetVertices() const { return &chunk->vertexCoordinates[index * DrawingData::vertexCountPerParticle]; }
+void C4Particle::SetLifetime(float to) { chunk->lifetime[index] = chunk->startingLifetime[index] = to; }
+void C4Particle::SetSpeed(float x, float y) { chunk->speedX[index] = x; chunk->speedY[index] = y; }
+
 // this class must not be copied, because deleting the contained CStdCSec twice would be fatal
 // a particle list belongs to a game-world entity (objects or global particles) and contains the chunks associated with that entity
 class C4ParticleList
@@ -409,10 +445,11 @@ public:
 	// deletes all the particles
 	void Clear();
 
-	void Exec(float timeDelta = 1.f);
 	void Draw(C4TargetFacet cgo, C4Object *obj);
+	bool IsEmpty() const { return particleChunks.empty(); }
 	C4ParticleChunk *GetFittingParticleChunk(C4ParticleDef *def, uint32_t blitMode, uint32_t attachment, bool alreadyLocked);
-	C4Particle *AddNewParticle(C4ParticleDef *def, uint32_t blitMode, uint32_t attachment, bool alreadyLocked, int remaining = 0);
+
+	friend class C4ParticleSystem;
 };
 #endif
 
@@ -428,6 +465,7 @@ public:
 	C4ParticleDef *GetDef(const char *name, C4ParticleDef *exclude=0);
 
 	friend class C4ParticleDef;
+	friend class C4ParticleSystem;
 };
 
 // the global particle system interface class
@@ -449,6 +487,33 @@ private:
 	size_t ibo_size;
 	std::list<C4ParticleList> particleLists;
 
+	// a range of particles in one chunk, executed by one of the calculation threads
+	struct CalculationJob
+	{
+		C4ParticleChunk *chunk;
+		C4Object *obj;
+		size_t begin, end;
+		float timeDelta;
+		size_t list; // index into the calculated lists
+	};
+	// a locked list; released by the caller as soon as its jobs are done
+	struct CalculationList
+	{
+		C4ParticleList *list;
+		int32_t pendingJobs; // guarded by the calculation's mutex
+		bool calculated, unlocked;
+	};
+	struct Calculation
+	{
+		std::vector<CalculationList> lists;
+		std::vector<CalculationJob> jobs;
+		CStdCSec mutex;
+	};
+	Calculation calculation;
+	// only used by the calculation thread; must outlive it
+	StdWorkerPool calculationPool;
+	int32_t calculationPoolSetting;
+
 	CStdCSec particleListAccessMutex;
 	CStdEvent frameCounterAdvancedEvent;
 	CalculationThread calculationThread;
@@ -457,6 +522,11 @@ private:
 
 	// calculates the physics in all of the existing particle lists
 	void ExecuteCalculation();
+	// calculates one step of the lists, which the caller has locked; each is unlocked as soon as it is done
+	static void ExecuteLists(Calculation &calc, float timeDelta, StdWorkerPool &pool);
+	static void ExecuteJobs(void *data, int32_t begin, int32_t end);
+	static void FinishList(Calculation &calc, CalculationList &list);
+	static void UnlockCalculatedLists(void *data);
 
 	C4ParticleList *globalParticles;
 #endif
@@ -503,6 +573,9 @@ public:
 	GLuint GetIBO() const { return ibo; }
 	void PreparePrimitiveRestartIndices(uint32_t forSize);
 
+	// logs particles per ms for the serial and the parallel calculation (local only, does not affect the game)
+	void Benchmark(int32_t count);
+
 	// creates a new particle
 	void Create(C4ParticleDef *of_def, C4ParticleValueProvider &x, C4ParticleValueProvider &y, C4ParticleValueProvider &speedX, C4ParticleValueProvider &speedY, C4ParticleValueProvider &lifetime, C4PropList *properties, int amount = 1, C4Object *object=NULL);
 
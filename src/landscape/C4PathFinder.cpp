@@ -41,13 +41,23 @@
    done by C4Command::Transfer on demand and would only cause no-good-entry-point
    move-to's on crawl-zone-entries).
 
+   Optionally, queries are first answered by the region/portal graph in
+   C4NavGraph. Rays are only launched if the graph finds no route, e.g.
+   because the route needs transfer zones or gaps narrower than a graph cell.
+
 */
 
 #include <C4Include.h>
 #include <C4PathFinder.h>
 
+#include <C4Command.h>
 #include <C4FacetEx.h>
 #include <C4GraphicsSystem.h>
+#include <C4Landscape.h>
+#include <C4NavGraph.h>
+#include <C4Random.h>
+
+#include <chrono>
 
 const int32_t C4PF_MaxDepth        = 35,
               C4PF_MaxCrawl        = 800,
@@ -66,7 +76,8 @@ const int32_t C4PF_MaxDepth        = 35,
               C4PF_Crawl_Right     = 2,
               C4PF_Crawl_Bottom    = 3,
               C4PF_Crawl_Left      = 4,
-              C4PF_Draw_Rate       = 10;
+              C4PF_Draw_Rate       = 10,
+              C4PF_RequestsPerFrame = 4;
 
 //------------------------------- C4PathFinderRay ---------------------------------------------
 class C4PathFinderRay
@@ -551,9 +562,23 @@ void C4PathFinder::Default()
 	TransferZones=NULL;
 	TransferZonesEnabled=true;
 	Level=1;
+	NavigationGraphEnabled=false;
+	NavGraph=NULL;
+	NextRequestSeq=1; GrantedRequestSeq=0;
+	RequestsCompleted=RequestLatencySum=0;
 }
 
 void C4PathFinder::Clear()
+{
+	ClearRays();
+	delete NavGraph; NavGraph=NULL;
+	for (Request &rRequest : Requests) rRequest.Command->PathRequest=0;
+	Requests.clear();
+	NextRequestSeq=1; GrantedRequestSeq=0;
+	RequestsCompleted=RequestLatencySum=0;
+}
+
+void C4PathFinder::ClearRays()
 {
 	C4PathFinderRay *pRay,*pNext;
 	for (pRay=FirstRay; pRay; pRay=pNext) { pNext=pRay->Next; delete pRay; }
@@ -572,11 +597,23 @@ void C4PathFinder::EnableTransferZones(bool fEnabled)
 	TransferZonesEnabled = fEnabled;
 }
 
+void C4PathFinder::EnableNavigationGraph(bool fEnabled)
+{
+	NavigationGraphEnabled = fEnabled;
+	// Rebuilt on demand for the current landscape
+	delete NavGraph; NavGraph=NULL;
+}
+
 void C4PathFinder::SetLevel(int iLevel)
 {
 	Level = Clamp(iLevel, 1, 10);
 }
 
+void C4PathFinder::Invalidate(const C4Rect &rRect)
+{
+	if (NavGraph) NavGraph->Invalidate(rRect);
+}
+
 void C4PathFinder::Draw(C4TargetFacet &cgo)
 {
 	if (TransferZones) TransferZones->Draw(cgo);
@@ -622,7 +659,7 @@ bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iT
 {
 
 	// Prepare
-	Clear();
+	ClearRays();
 
 	// Parameter safety
 	if (!fnSetWaypoint) return false;
@@ -631,6 +668,18 @@ bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iT
 	// Start & target coordinates must be free
 	if (!PointFree(iFromX,iFromY) || !PointFree(iToX,iToY)) return false;
 
+	// Navigation graph
+	if (NavigationGraphEnabled)
+		if (FindByGraph(iFromX,iFromY,iToX,iToY))
+			return true;
+
+	return FindByRays(iFromX,iFromY,iToX,iToY);
+
+}
+
+bool C4PathFinder::FindByRays(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY)
+{
+
 	// Add the first two rays
 	if (!AddRay(iFromX,iFromY,iToX,iToY,0,C4PF_Direction_Left,NULL)) return false;
 	if (!AddRay(iFromX,iFromY,iToX,iToY,0,C4PF_Direction_Right,NULL)) return false;
@@ -643,6 +692,143 @@ bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iT
 
 }
 
+bool C4PathFinder::FindByGraph(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY)
+{
+	// (Re)create for the current landscape
+	if (NavGraph && (NavGraph->GetWidth() != GBackWdt || NavGraph->GetHeight() != GBackHgt))
+		{ delete NavGraph; NavGraph=NULL; }
+	if (!NavGraph) NavGraph = new C4NavGraph(GBackWdt, GBackHgt, PointFree);
+	// Query
+	std::vector<C4NavGraph::Waypoint> Waypoints;
+	if (!NavGraph->Find(iFromX,iFromY,iToX,iToY,C4NG_MaxExpand*Level,Waypoints))
+		return false;
+	// Set waypoints last to first, like C4PathFinderRay::SetCompletePath
+	for (auto it = Waypoints.rbegin(); it != Waypoints.rend(); ++it)
+		SetWaypoint(it->X,it->Y,nullptr);
+	return true;
+}
+
+bool C4PathFinder::RequestGranted(C4Command *pCommand)
+{
+	if (!pCommand->PathRequest)
+	{
+		Request NewRequest = { NextRequestSeq++, pCommand, ::Game.FrameCounter };
+		Requests.push_back(NewRequest);
+		pCommand->PathRequest = NewRequest.Seq;
+		return false;
+	}
+	return pCommand->PathRequest <= GrantedRequestSeq;
+}
+
+void C4PathFinder::CompleteRequest(C4Command *pCommand)
+{
+	for (auto it = Requests.begin(); it != Requests.end(); ++it)
+		if (it->Command == pCommand)
+		{
+			++RequestsCompleted;
+			RequestLatencySum += ::Game.FrameCounter - it->Frame;
+			Requests.erase(it);
+			break;
+		}
+	pCommand->PathRequest = 0;
+}
+
+void C4PathFinder::CancelRequest(C4Command *pCommand)
+{
+	for (auto it = Requests.begin(); it != Requests.end(); ++it)
+		if (it->Command == pCommand)
+		{
+			Requests.erase(it);
+			break;
+		}
+	pCommand->PathRequest = 0;
+}
+
+void C4PathFinder::RestoreRequest(C4Command *pCommand)
+{
+	// Keep the saved order
+	Request NewRequest = { pCommand->PathRequest, pCommand, ::Game.FrameCounter };
+	auto it = Requests.begin();
+	while (it != Requests.end() && it->Seq < NewRequest.Seq) ++it;
+	Requests.insert(it, NewRequest);
+	NextRequestSeq = std::max(NextRequestSeq, NewRequest.Seq + 1);
+}
+
+void C4PathFinder::GrantRequests()
+{
+	// Grant the oldest requests; new requests of this frame have to wait for the next one
+	if (Requests.empty()) return;
+	GrantedRequestSeq = Requests[std::min<size_t>(C4PF_RequestsPerFrame, Requests.size()) - 1].Seq;
+}
+
+void C4PathFinder::ExpireRequests()
+{
+	// Granted requests that were not used (e.g. because the command was not executed) go to the back
+	while (!Requests.empty() && Requests.front().Seq <= GrantedRequestSeq)
+	{
+		Request Unused = Requests.front();
+		Requests.pop_front();
+		Unused.Seq = Unused.Command->PathRequest = NextRequestSeq++;
+		Requests.push_back(Unused);
+	}
+	// Nothing is granted between frames, so savegames need not store it
+	GrantedRequestSeq = 0;
+}
+
+void C4PathFinder::Benchmark(int32_t iQueries)
+{
+	if (!PointFree || iQueries <= 0) return;
+	// Pick random free start and target points. SafeRandom is not synchronized, so this does not affect the game.
+	std::vector<int32_t> Points;
+	for (int32_t i = 0; i < iQueries * 100 && int32_t(Points.size()) < iQueries * 4; ++i)
+	{
+		int32_t iX = SafeRandom(GBackWdt), iY = SafeRandom(GBackHgt);
+		if (PointFree(iX,iY)) { Points.push_back(iX); Points.push_back(iY); }
+	}
+	iQueries = Points.size() / 4;
+	if (!iQueries) return;
+	typedef std::chrono::steady_clock Clock;
+	auto fnNoWaypoint = [](int32_t, int32_t, C4Object *) { return true; };
+	SetWaypointFn fnOldSetWaypoint = SetWaypoint;
+	SetWaypoint = fnNoWaypoint;
+	// Ray search
+	int32_t iRayFound = 0;
+	Clock::time_point tStart = Clock::now();
+	for (int32_t i = 0; i < iQueries; ++i)
+	{
+		ClearRays();
+		if (FindByRays(Points[4*i],Points[4*i+1],Points[4*i+2],Points[4*i+3])) ++iRayFound;
+	}
+	ClearRays();
+	Clock::duration tRays = Clock::now() - tStart;
+	// Navigation graph: build, then query with empty and with warm route cache
+	C4NavGraph Graph(GBackWdt, GBackHgt, PointFree);
+	tStart = Clock::now();
+	Graph.Repair();
+	Clock::duration tBuild = Clock::now() - tStart;
+	std::vector<C4NavGraph::Waypoint> Waypoints;
+	int32_t iGraphFound = 0;
+	Clock::duration tGraph[2];
+	for (int32_t iPass = 0; iPass < 2; ++iPass)
+	{
+		iGraphFound = 0;
+		tStart = Clock::now();
+		for (int32_t i = 0; i < iQueries; ++i)
+			if (Graph.Find(Points[4*i],Points[4*i+1],Points[4*i+2],Points[4*i+3],C4NG_MaxExpand*Level,Waypoints)) ++iGraphFound;
+		tGraph[iPass] = Clock::now() - tStart;
+	}
+	SetWaypoint = fnOldSetWaypoint;
+	// Report average microseconds per query
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+	LogF("Pathfinder benchmark: %d queries on %dx%d landscape", (int) iQueries, (int) GBackWdt, (int) GBackHgt);
+	LogF("  rays:  %d found, %d us/query", (int) iRayFound, (int) (duration_cast<microseconds>(tRays).count() / iQueries));
+	LogF("  graph: %d regions built in %d us", (int) Graph.GetRegionCount(), (int) duration_cast<microseconds>(tBuild).count());
+	LogF("  graph: %d found, %d us/query (cold), %d us/query (cached)", (int) iGraphFound,
+	     (int) (duration_cast<microseconds>(tGraph[0]).count() / iQueries), (int) (duration_cast<microseconds>(tGraph[1]).count() / iQueries));
+	LogF("  requests: %d queued, %d completed, %d frames average latency", (int) GetRequestQueueLength(), (int) RequestsCompleted, (int) GetAverageRequestLatency());
+}
+
 bool C4PathFinder::AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iDepth, int32_t iDirection, C4PathFinderRay *pFrom, C4TransferZone *pUseZone)
 {
 	// Max depth
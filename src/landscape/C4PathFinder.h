@@ -20,10 +20,13 @@
 #ifndef INC_C4PathFinder
 #define INC_C4PathFinder
 
+#include <deque>
 #include <functional>
 
+class C4Command;
 class C4Object;
 class C4PathFinderRay;
+class C4NavGraph;
 class C4PathFinder
 {
 	friend class C4PathFinderRay;
@@ -40,9 +43,34 @@ public:
 	void Init(PointFreeFn fnPointFree, C4TransferZones* pTransferZones=NULL);
 	bool Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, SetWaypointFn fnSetWaypoint);
 	void EnableTransferZones(bool fEnabled);
+	void EnableNavigationGraph(bool fEnabled);
 	void SetLevel(int iLevel);
+	void Invalidate(const C4Rect &rRect); // landscape solidity changed in the given area
+	void Benchmark(int32_t iQueries); // log query times of ray search and navigation graph
+
+	// Deferred path searches for C4Command::MoveTo. A fixed number of queued
+	// requests is granted per frame in submission order, so the result is the
+	// same on all clients regardless of their speed.
+	bool RequestGranted(C4Command *pCommand); // queues the command if it isn't yet
+	void CompleteRequest(C4Command *pCommand);
+	void CancelRequest(C4Command *pCommand);
+	void RestoreRequest(C4Command *pCommand); // re-queue after loading a savegame
+	void GrantRequests(); // called before object execution
+	void ExpireRequests(); // called after object execution
+	int32_t GetRequestQueueLength() const { return Requests.size(); }
+	int32_t GetAverageRequestLatency() const { return RequestsCompleted ? RequestLatencySum / RequestsCompleted : 0; } // in frames
 
 private:
+	struct Request
+	{
+		int32_t Seq;
+		C4Command *Command;
+		int32_t Frame; // submission frame; statistics only
+	};
+
+	void ClearRays();
+	bool FindByRays(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY);
+	bool FindByGraph(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY);
 	void Run();
 	bool AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iDepth, int32_t iDirection, C4PathFinderRay *pFrom, C4TransferZone *pUseZone=NULL);
 	bool SplitRay(C4PathFinderRay *pRay, int32_t iAtX, int32_t iAtY);
@@ -55,6 +83,11 @@ private:
 	C4TransferZones *TransferZones;
 	bool TransferZonesEnabled;
 	int Level;
+	bool NavigationGraphEnabled;
+	C4NavGraph *NavGraph; // created on first query
+	std::deque<Request> Requests; // ordered by Seq
+	int32_t NextRequestSeq, GrantedRequestSeq;
+	int32_t RequestsCompleted, RequestLatencySum;
 };
 
 
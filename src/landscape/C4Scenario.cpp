@@ -201,6 +201,7 @@ void C4SGame::Default()
 	Goals.Clear();
 	Rules.Clear();
 	FoWEnabled = true;
+	NavigationGraph = false;
 }
 
 void C4SGame::CompileFunc(StdCompiler *pComp, bool fSection)
@@ -216,6 +217,7 @@ void C4SGame::CompileFunc(StdCompiler *pComp, bool fSection)
 	pComp->Value(mkNamingAdapt(Goals,                                             "Goals",       C4IDList()));
 	pComp->Value(mkNamingAdapt(Rules,                                             "Rules",       C4IDList()));
 	pComp->Value(mkNamingAdapt(FoWEnabled,                                        "FoWEnabled",  true));
+	pComp->Value(mkNamingAdapt(NavigationGraph,                                   "NavigationGraph", false));
 }
 
 void C4SPlrStart::Default()
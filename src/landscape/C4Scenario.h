@@ -120,6 +120,7 @@ public:
 	C4IDList Rules;
 
 	bool FoWEnabled;
+	bool NavigationGraph; // pathfinder uses the region/portal graph before falling back to ray search
 
 	C4SRealism Realism;
 
@@ -364,7 +364,7 @@ int32_t C4TextureMap::LoadTextures(C4Group &hGroup, C4Group* OverloadFile)
 		if (WildcardMatch("*" C4CFN_MaterialShapeFiles, texname)) continue;
 		// create surface
 		ctex = new C4Surface();
-		if (ctex->Read(hGroup, GetExtension(texname), C4SF_MipMap))
+		if (ctex->Read(hGroup, GetExtension(texname), C4SF_MipMap | C4SF_Pixels))
 		{
 			SReplaceChar(texname,'.',0);
 			if (AddTexture(texname,ctex)) texnum++;
@@ -0,0 +1,447 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* 8 bit surface stored in tiles; uniform tiles share one buffer per color */
+
+#include "C4Include.h"
+#include <C4TiledSurface8.h>
+
+#include <Bitmap256.h>
+#include <CStdFile.h>
+#include <CSurface8.h>
+#include <StdColors.h>
+
+uint64_t C4TiledSurface8::PlaneClock = 0;
+
+C4TiledSurface8::C4TiledSurface8()
+{
+	Wdt=Hgt=0;
+	ClipX=ClipY=ClipX2=ClipY2=0;
+	TilesX=TilesY=0;
+	pPal=NULL;
+	for (int i=0; i<256; ++i) Uniform[i]=NULL;
+	fPlanes=false;
+	memset(PlaneClasses, 0, sizeof(PlaneClasses));
+	PlanePitch=0;
+}
+
+C4TiledSurface8::~C4TiledSurface8()
+{
+	Clear();
+}
+
+void C4TiledSurface8::Clear()
+{
+	for (std::vector<BYTE *>::iterator i = Tiles.begin(); i != Tiles.end(); ++i)
+		if (!IsShared(*i)) delete [] *i;
+	Tiles.clear();
+	for (int i=0; i<256; ++i)
+		{ delete [] Uniform[i]; Uniform[i]=NULL; }
+	delete pPal; pPal=NULL;
+	Wdt=Hgt=TilesX=TilesY=0;
+	// the plane classes stay for the next Create
+	for (int i=0; i<C4TS_PlaneCount; ++i) Planes[i].clear();
+	PlaneVersions.clear();
+	PlanePitch=0;
+}
+
+bool C4TiledSurface8::Create(int iWdt, int iHgt)
+{
+	Clear();
+	// check size
+	if (iWdt<=0 || iHgt<=0) return false;
+	Wdt=iWdt; Hgt=iHgt;
+	// create pal
+	pPal = new CStdPalette;
+	memset(pPal->Colors, 0, sizeof(pPal->Colors));
+	// all tiles start out shared
+	TilesX = (Wdt + C4TS_TileMask) >> C4TS_TileShift;
+	TilesY = (Hgt + C4TS_TileMask) >> C4TS_TileShift;
+	Tiles.assign(TilesX * TilesY, GetUniform(0));
+	NoClip();
+	if (fPlanes) UpdatePlanes();
+	return true;
+}
+
+bool C4TiledSurface8::Create(const CSurface8 &rFrom)
+{
+	if (!Create(rFrom.Wdt, rFrom.Hgt)) return false;
+	if (rFrom.pPal) *pPal = *rFrom.pPal;
+	for (int y=0; y<Hgt; ++y)
+		for (int x=0; x<Wdt; ++x)
+			_SetPix(x, y, rFrom._GetPix(x, y));
+	Compact();
+	return true;
+}
+
+bool C4TiledSurface8::Create(const C4TiledSurface8 &rFrom)
+{
+	if (!Create(rFrom.Wdt, rFrom.Hgt)) return false;
+	*pPal = *rFrom.pPal;
+	for (size_t i=0; i<Tiles.size(); ++i)
+	{
+		const BYTE *pFrom = rFrom.Tiles[i];
+		if (rFrom.IsShared(pFrom))
+			Tiles[i] = GetUniform(*pFrom);
+		else
+		{
+			Tiles[i] = new BYTE[C4TS_TilePixels];
+			memcpy(Tiles[i], pFrom, C4TS_TilePixels);
+		}
+	}
+	if (fPlanes) UpdatePlanes();
+	return true;
+}
+
+BYTE *C4TiledSurface8::GetUniform(BYTE byCol)
+{
+	if (!Uniform[byCol])
+	{
+		Uniform[byCol] = new BYTE[C4TS_TilePixels];
+		memset(Uniform[byCol], byCol, C4TS_TilePixels);
+	}
+	return Uniform[byCol];
+}
+
+void C4TiledSurface8::Unshare(BYTE *&pTile)
+{
+	BYTE *pOwn = new BYTE[C4TS_TilePixels];
+	memcpy(pOwn, pTile, C4TS_TilePixels);
+	pTile = pOwn;
+}
+
+void C4TiledSurface8::Compact()
+{
+	for (int ty=0; ty<TilesY; ++ty)
+		for (int tx=0; tx<TilesX; ++tx)
+		{
+			BYTE *&pTile = Tiles[ty * TilesX + tx];
+			if (IsShared(pTile)) continue;
+			// only the part inside the surface counts
+			int iWdt = std::min(Wdt - (tx << C4TS_TileShift), C4TS_TileSize);
+			int iHgt = std::min(Hgt - (ty << C4TS_TileShift), C4TS_TileSize);
+			BYTE byCol = *pTile;
+			bool fUniform = true;
+			for (int y=0; y<iHgt && fUniform; ++y)
+			{
+				const BYTE *pRow = pTile + (y << C4TS_TileShift);
+				for (int x=0; x<iWdt; ++x)
+					if (pRow[x] != byCol) { fUniform = false; break; }
+			}
+			if (!fUniform) continue;
+			delete [] pTile;
+			pTile = GetUniform(byCol);
+		}
+}
+
+int C4TiledSurface8::GetOwnTileCount() const
+{
+	int iCount = 0;
+	for (std::vector<BYTE *>::const_iterator i = Tiles.begin(); i != Tiles.end(); ++i)
+		if (!IsShared(*i)) ++iCount;
+	return iCount;
+}
+
+size_t C4TiledSurface8::GetMemoryUsage() const
+{
+	size_t iSize = Tiles.size() * sizeof(BYTE *) + size_t(GetOwnTileCount()) * C4TS_TilePixels;
+	for (int i=0; i<256; ++i)
+		if (Uniform[i]) iSize += C4TS_TilePixels;
+	return iSize;
+}
+
+void C4TiledSurface8::NoClip()
+{
+	ClipX=0; ClipY=0; ClipX2=Wdt-1; ClipY2=Hgt-1;
+}
+
+void C4TiledSurface8::Clip(int iX, int iY, int iX2, int iY2)
+{
+	ClipX=Clamp(iX,0,Wdt-1); ClipY=Clamp(iY,0,Hgt-1);
+	ClipX2=Clamp(iX2,0,Wdt-1); ClipY2=Clamp(iY2,0,Hgt-1);
+}
+
+void C4TiledSurface8::FillSpan(int iX1, int iX2, int iY, BYTE byCol)
+{
+	// clip
+	if (iY<ClipY || iY>ClipY2) return;
+	iX1 = std::max(iX1, ClipX); iX2 = std::min(iX2, ClipX2+1);
+	if (fPlanes && iX1 < iX2) SetPlaneSpan(iX1, iX2, iY, PlaneClasses[byCol]);
+	// fill per tile
+	while (iX1 < iX2)
+	{
+		int iLen = std::min(C4TS_TileSize - (iX1 & C4TS_TileMask), iX2 - iX1);
+		BYTE *&pTile = Tiles[(iY >> C4TS_TileShift) * TilesX + (iX1 >> C4TS_TileShift)];
+		if (pTile != Uniform[byCol])
+		{
+			if (IsShared(pTile)) Unshare(pTile);
+			memset(pTile + ((iY & C4TS_TileMask) << C4TS_TileShift) + (iX1 & C4TS_TileMask), byCol, iLen);
+		}
+		iX1 += iLen;
+	}
+}
+
+void C4TiledSurface8::ConvertSpan(int iX1, int iX2, int iY, const BYTE *pTable)
+{
+	// clip
+	if (iY<ClipY || iY>ClipY2) return;
+	iX1 = std::max(iX1, ClipX); iX2 = std::min(iX2, ClipX2+1);
+	// convert per tile
+	while (iX1 < iX2)
+	{
+		int iLen = std::min(C4TS_TileSize - (iX1 & C4TS_TileMask), iX2 - iX1);
+		BYTE *&pTile = Tiles[(iY >> C4TS_TileShift) * TilesX + (iX1 >> C4TS_TileShift)];
+		// shared tiles only need a copy if their color changes
+		if (!IsShared(pTile) || pTable[*pTile] != *pTile)
+		{
+			if (IsShared(pTile)) Unshare(pTile);
+			BYTE *pPix = pTile + ((iY & C4TS_TileMask) << C4TS_TileShift) + (iX1 & C4TS_TileMask);
+			for (int i = 0; i < iLen; ++i) pPix[i] = pTable[pPix[i]];
+			if (fPlanes) UpdatePlaneSpan(iX1, iX1 + iLen, iY);
+		}
+		iX1 += iLen;
+	}
+}
+
+void C4TiledSurface8::HLine(int iX, int iX2, int iY, int iCol)
+{
+	FillSpan(iX, iX2+1, iY, iCol);
+}
+
+void C4TiledSurface8::Box(int iX, int iY, int iX2, int iY2, int iCol)
+{
+	// clip
+	iX = std::max(iX, ClipX); iY = std::max(iY, ClipY);
+	iX2 = std::min(iX2, ClipX2); iY2 = std::min(iY2, ClipY2);
+	if (iX > iX2 || iY > iY2) return;
+	for (int ty=iY >> C4TS_TileShift; ty<=iY2 >> C4TS_TileShift; ++ty)
+		for (int tx=iX >> C4TS_TileShift; tx<=iX2 >> C4TS_TileShift; ++tx)
+		{
+			int iTX = tx << C4TS_TileShift, iTY = ty << C4TS_TileShift;
+			int x1 = std::max(iX, iTX), x2 = std::min(iX2+1, std::min(iTX+C4TS_TileSize, Wdt));
+			int y1 = std::max(iY, iTY), y2 = std::min(iY2+1, std::min(iTY+C4TS_TileSize, Hgt));
+			BYTE *&pTile = Tiles[ty * TilesX + tx];
+			// whole tile covered: share the uniform tile
+			if (x2-x1 == std::min(C4TS_TileSize, Wdt-iTX) && y2-y1 == std::min(C4TS_TileSize, Hgt-iTY))
+			{
+				if (!IsShared(pTile)) delete [] pTile;
+				pTile = GetUniform(iCol);
+				if (fPlanes)
+					for (int y=y1; y<y2; ++y) SetPlaneSpan(x1, x2, y, PlaneClasses[BYTE(iCol)]);
+				continue;
+			}
+			for (int y=y1; y<y2; ++y) FillSpan(x1, x2, y, iCol);
+		}
+}
+
+void C4TiledSurface8::Circle(int x, int y, int r, BYTE col)
+{
+	for (int ycnt=-r; ycnt<r; ycnt++)
+	{
+		int lwdt = (int) sqrt(float(r*r-ycnt*ycnt));
+		FillSpan(x - lwdt, x + lwdt, y + ycnt, col);
+	}
+}
+
+void C4TiledSurface8::ClearBox8Only(int iX, int iY, int iWdt, int iHgt)
+{
+	// assume clip already
+	int iClipX=ClipX, iClipY=ClipY, iClipX2=ClipX2, iClipY2=ClipY2;
+	NoClip();
+	Box(iX, iY, iX+iWdt-1, iY+iHgt-1, 0);
+	ClipX=iClipX; ClipY=iClipY; ClipX2=iClipX2; ClipY2=iClipY2;
+}
+
+void C4TiledSurface8::SetPlaneClasses(const BYTE *pClasses)
+{
+	fPlanes = !!pClasses;
+	if (!fPlanes)
+	{
+		for (int i=0; i<C4TS_PlaneCount; ++i) std::vector<uint64_t>().swap(Planes[i]);
+		std::vector<uint64_t>().swap(PlaneVersions);
+		return;
+	}
+	memcpy(PlaneClasses, pClasses, sizeof(PlaneClasses));
+	UpdatePlanes();
+}
+
+void C4TiledSurface8::UpdatePlanes()
+{
+	PlanePitch = (Wdt + 63) >> 6;
+	for (int i=0; i<C4TS_PlaneCount; ++i) Planes[i].assign(size_t(PlanePitch) * Hgt, 0);
+	PlaneVersions.assign(Tiles.size(), ++PlaneClock);
+	for (int y=0; y<Hgt; ++y) UpdatePlaneSpan(0, Wdt, y);
+}
+
+void C4TiledSurface8::UpdatePlaneSpan(int iX1, int iX2, int iY)
+{
+	for (int x=iX1; x<iX2; ++x) SetPlaneBits(x, iY, PlaneClasses[_GetPix(x, iY)]);
+}
+
+void C4TiledSurface8::SetPlaneSpan(int iX1, int iX2, int iY, BYTE byClasses)
+{
+	uint64_t *pVersions = &PlaneVersions[(iY >> C4TS_TileShift) * TilesX];
+	for (int tx = iX1 >> C4TS_TileShift; tx <= (iX2 - 1) >> C4TS_TileShift; ++tx) pVersions[tx] = ++PlaneClock;
+	for (int i=0; i<C4TS_PlaneCount; ++i)
+	{
+		uint64_t *pRow = &Planes[i][size_t(iY) * PlanePitch];
+		bool fSet = !!(byClasses & (1 << i));
+		for (int x=iX1; x<iX2; )
+		{
+			// bits x to x+iLen-1 of one word
+			int iBit = x & 63, iLen = std::min(64 - iBit, iX2 - x);
+			uint64_t iMask = (iLen == 64 ? ~uint64_t(0) : ((uint64_t(1) << iLen) - 1)) << iBit;
+			if (fSet) pRow[x >> 6] |= iMask; else pRow[x >> 6] &= ~iMask;
+			x += iLen;
+		}
+	}
+}
+
+namespace
+{
+	// index of the lowest and highest set bit; w must not be 0
+	inline int LowestBit(uint64_t w)
+	{
+#ifdef _MSC_VER
+		unsigned long i; _BitScanForward64(&i, w); return i;
+#else
+		return __builtin_ctzll(w);
+#endif
+	}
+	inline int HighestBit(uint64_t w)
+	{
+#ifdef _MSC_VER
+		unsigned long i; _BitScanReverse64(&i, w); return i;
+#else
+		return 63 - __builtin_clzll(w);
+#endif
+	}
+}
+
+int C4TiledSurface8::GetPlaneRun(int iPlane, int iX, int iY, int iDX, int iDY, int iMax) const
+{
+	if (iMax <= 0) return 0;
+	const uint64_t *pPlane = &Planes[iPlane][0];
+	int iRun = 0;
+	if (iDX > 0)
+	{
+		// skip clear words, then find the first set bit
+		const uint64_t *pRow = pPlane + size_t(iY) * PlanePitch;
+		while (iRun < iMax)
+		{
+			int x = iX + iRun;
+			uint64_t w = pRow[x >> 6] >> (x & 63);
+			if (w) return std::min(iMax, iRun + LowestBit(w));
+			iRun += 64 - (x & 63);
+		}
+	}
+	else if (iDX < 0)
+	{
+		const uint64_t *pRow = pPlane + size_t(iY) * PlanePitch;
+		while (iRun < iMax)
+		{
+			int x = iX - iRun;
+			uint64_t w = pRow[x >> 6] & (~uint64_t(0) >> (63 - (x & 63)));
+			if (w) return std::min(iMax, x - HighestBit(w) - ((x >> 6) << 6) + iRun);
+			iRun += (x & 63) + 1;
+		}
+	}
+	else
+	{
+		// columns can only be walked bit by bit, but without any tile lookups
+		const uint64_t *pColumn = pPlane + (iX >> 6);
+		uint64_t iBit = uint64_t(1) << (iX & 63);
+		for (int y = iY; iRun < iMax; ++iRun, y += iDY)
+			if (pColumn[size_t(y) * PlanePitch] & iBit) return iRun;
+	}
+	return iMax;
+}
+
+uint32_t C4TiledSurface8::GetPlaneHash(int iX, int iY, int iX2, int iY2) const
+{
+	uint64_t iHash = 14695981039346656037ull;
+	if (iX >= iX2 || iY >= iY2) return uint32_t(iHash);
+	int iWord1 = iX >> 6, iWord2 = (iX2 - 1) >> 6;
+	uint64_t iMask1 = ~uint64_t(0) << (iX & 63), iMask2 = ~uint64_t(0) >> (63 - ((iX2 - 1) & 63));
+	for (int i = 0; i < C4TS_PlaneCount; ++i)
+		for (int y = iY; y < iY2; ++y)
+		{
+			const uint64_t *pRow = &Planes[i][size_t(y) * PlanePitch];
+			for (int w = iWord1; w <= iWord2; ++w)
+			{
+				uint64_t iBits = pRow[w];
+				if (w == iWord1) iBits &= iMask1;
+				if (w == iWord2) iBits &= iMask2;
+				iHash = (iHash ^ iBits) * 1099511628211ull;
+				iHash ^= iHash >> 29;
+			}
+		}
+	return uint32_t(iHash ^ (iHash >> 32));
+}
+
+uint64_t C4TiledSurface8::GetPlaneVersion(int iX, int iY, int iX2, int iY2) const
+{
+	// Every update stamps its tile with a clock value larger than all before,
+	// so the latest stamp in the rect changes whenever any of its tiles did.
+	uint64_t iVersion = 0;
+	if (iX >= iX2 || iY >= iY2) return iVersion;
+	for (int ty = iY >> C4TS_TileShift; ty <= (iY2 - 1) >> C4TS_TileShift; ++ty)
+		for (int tx = iX >> C4TS_TileShift; tx <= (iX2 - 1) >> C4TS_TileShift; ++tx)
+			iVersion = std::max(iVersion, PlaneVersions[ty * TilesX + tx]);
+	return iVersion;
+}
+
+void C4TiledSurface8::CopyTo(BYTE *pBuf) const
+{
+	for (int y=0; y<Hgt; ++y)
+		for (int tx=0; tx<TilesX; ++tx)
+		{
+			int iWdt = std::min(Wdt - (tx << C4TS_TileShift), C4TS_TileSize);
+			const BYTE *pRow = Tiles[(y >> C4TS_TileShift) * TilesX + tx] + ((y & C4TS_TileMask) << C4TS_TileShift);
+			memcpy(pBuf + y * Wdt + (tx << C4TS_TileShift), pRow, iWdt);
+		}
+}
+
+bool C4TiledSurface8::Save(const char *szFilename, CStdPalette *bpPalette) const
+{
+	C4BMP256Info BitmapInfo;
+	BitmapInfo.Set(Wdt,Hgt, bpPalette ? bpPalette : pPal);
+
+	// Create file & write info
+	CStdFile hFile;
+
+	if ( !hFile.Create(szFilename)
+	     || !hFile.Write(&BitmapInfo,sizeof(BitmapInfo)) )
+		{ return false; }
+
+	// Write lines
+	std::vector<BYTE> Line(DWordAligned(Wdt), 0);
+	for (int cnt=Hgt-1; cnt>=0; cnt--)
+	{
+		for (int tx=0; tx<TilesX; ++tx)
+		{
+			int iWdt = std::min(Wdt - (tx << C4TS_TileShift), C4TS_TileSize);
+			memcpy(&Line[tx << C4TS_TileShift], Tiles[(cnt >> C4TS_TileShift) * TilesX + tx] + ((cnt & C4TS_TileMask) << C4TS_TileShift), iWdt);
+		}
+		if (!hFile.Write(&Line[0],Line.size()))
+			{ return false; }
+	}
+
+	// Close file
+	hFile.Close();
+
+	// Success
+	return true;
+}
@@ -0,0 +1,139 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* 8 bit surface stored in tiles; uniform tiles share one buffer per color */
+
+#ifndef INC_C4TiledSurface8
+#define INC_C4TiledSurface8
+
+#include <vector>
+
+// Tiles are C4TS_TileSize x C4TS_TileSize pixels. Every tile points either
+// to its own buffer or to a shared buffer filled with a single color, so
+// reading never needs to check which kind of tile it is. Writing to a
+// shared tile copies it first.
+const int C4TS_TileShift  = 6,
+          C4TS_TileSize   = 1 << C4TS_TileShift,
+          C4TS_TileMask   = C4TS_TileSize - 1,
+          C4TS_TilePixels = C4TS_TileSize * C4TS_TileSize;
+
+// Optionally, the surface keeps bit planes with one bit per pixel, packed
+// into 64 bit words per row. A class table says which colors are set in
+// which plane, and all writes keep the planes up to date. This allows
+// scanning for e.g. solid pixels a word at a time.
+const int C4TS_PlaneCount = 2;
+
+class C4TiledSurface8
+{
+public:
+	C4TiledSurface8();
+	~C4TiledSurface8();
+public:
+	int Wdt,Hgt; // size of surface
+	int ClipX,ClipY,ClipX2,ClipY2;
+	CStdPalette *pPal; // pal for this surface; owned
+	void SetPix(int iX, int iY, BYTE byCol)
+	{
+		// clip
+		if ((iX<ClipX) || (iX>ClipX2) || (iY<ClipY) || (iY>ClipY2)) return;
+		_SetPix(iX, iY, byCol);
+	}
+	void _SetPix(int iX, int iY, BYTE byCol)
+	{
+		// no bounds checks
+		BYTE *&pTile = Tiles[(iY >> C4TS_TileShift) * TilesX + (iX >> C4TS_TileShift)];
+		int iOffset = ((iY & C4TS_TileMask) << C4TS_TileShift) + (iX & C4TS_TileMask);
+		if (pTile[iOffset] == byCol) return;
+		if (IsShared(pTile)) Unshare(pTile);
+		pTile[iOffset] = byCol;
+		if (fPlanes) SetPlaneBits(iX, iY, PlaneClasses[byCol]);
+	}
+	BYTE GetPix(int iX, int iY) const // get pixel
+	{
+		if (iX<0 || iY<0 || iX>=Wdt || iY>=Hgt) return 0;
+		return _GetPix(iX, iY);
+	}
+	inline BYTE _GetPix(int iX, int iY) const // get pixel (bounds not checked)
+	{
+		return Tiles[(iY >> C4TS_TileShift) * TilesX + (iX >> C4TS_TileShift)][((iY & C4TS_TileMask) << C4TS_TileShift) + (iX & C4TS_TileMask)];
+	}
+	// Row spans: pixels iX1 to iX2-1 in row iY. Writes are clipped.
+	void FillSpan(int iX1, int iX2, int iY, BYTE byCol);
+	void ConvertSpan(int iX1, int iX2, int iY, const BYTE *pTable); // replace each pixel c by pTable[c]
+	const BYTE *GetSpan(int iX, int iY, int &riLen) const // read pointer to up to riLen contiguous pixels; no bounds checks
+	{
+		riLen = std::min(C4TS_TileSize - (iX & C4TS_TileMask), Wdt - iX);
+		return Tiles[(iY >> C4TS_TileShift) * TilesX + (iX >> C4TS_TileShift)] + ((iY & C4TS_TileMask) << C4TS_TileShift) + (iX & C4TS_TileMask);
+	}
+	bool Create(int iWdt, int iHgt); // create surface filled with color 0
+	bool Create(const CSurface8 &rFrom); // create as copy of flat surface, including palette
+	bool Create(const C4TiledSurface8 &rFrom); // create as copy, including palette
+	void Clear();
+	void HLine(int iX, int iX2, int iY, int iCol);
+	void Box(int iX, int iY, int iX2, int iY2, int iCol);
+	void Circle(int x, int y, int r, BYTE col);
+	void ClearBox8Only(int iX, int iY, int iWdt, int iHgt); // clear box; assume clip already
+	void Clip(int iX, int iY, int iX2, int iY2);
+	void NoClip();
+	void GetSurfaceSize(int &irX, int &irY) const { irX=Wdt; irY=Hgt; }
+	void CopyTo(BYTE *pBuf) const; // copy all pixels into a Wdt*Hgt buffer
+	bool Save(const char *szFilename, CStdPalette *bpPalette = NULL) const;
+
+	// Bit planes: bit i of pClasses[c] puts color c into plane i. NULL removes the planes.
+	void SetPlaneClasses(const BYTE *pClasses);
+	bool HasPlanes() const { return fPlanes; }
+	// Number of pixels from iX/iY on in direction iDX/iDY (one of them +-1, the other 0)
+	// that are not set in the plane, up to iMax. iMax must not reach beyond the surface.
+	int GetPlaneRun(int iPlane, int iX, int iY, int iDX, int iDY, int iMax) const;
+	// Hash of the bits of all planes in the rect from iX/iY to iX2-1/iY2-1, which must lie within the surface
+	uint32_t GetPlaneHash(int iX, int iY, int iX2, int iY2) const;
+	// Changes whenever plane bits in the rect may have changed. Like the hash, it
+	// may be read from several threads while nobody draws.
+	uint64_t GetPlaneVersion(int iX, int iY, int iX2, int iY2) const;
+
+	void Compact(); // give up own buffers of tiles that are uniform again
+	int GetTileCount() const { return Tiles.size(); }
+	int GetOwnTileCount() const; // tiles that aren't shared
+	size_t GetMemoryUsage() const; // bytes of pixel data, including shared buffers
+protected:
+	int TilesX, TilesY;
+	std::vector<BYTE *> Tiles;
+	BYTE *Uniform[256]; // shared buffers per color; created on demand
+
+	bool IsShared(const BYTE *pTile) const { return pTile == Uniform[*pTile]; }
+	BYTE *GetUniform(BYTE byCol);
+	void Unshare(BYTE *&pTile); // replace shared tile by own copy
+
+	bool fPlanes;
+	BYTE PlaneClasses[256];
+	int PlanePitch; // words per row
+	std::vector<uint64_t> Planes[C4TS_PlaneCount];
+	std::vector<uint64_t> PlaneVersions; // per tile, PlaneClock at the last plane update
+	static uint64_t PlaneClock; // counts plane updates of all surfaces; never reset
+
+	void SetPlaneBits(int iX, int iY, BYTE byClasses)
+	{
+		PlaneVersions[(iY >> C4TS_TileShift) * TilesX + (iX >> C4TS_TileShift)] = ++PlaneClock;
+		size_t iWord = size_t(iY) * PlanePitch + (iX >> 6);
+		uint64_t iBit = uint64_t(1) << (iX & 63);
+		for (int i = 0; i < C4TS_PlaneCount; ++i)
+			if (byClasses & (1 << i)) Planes[i][iWord] |= iBit; else Planes[i][iWord] &= ~iBit;
+	}
+	void SetPlaneSpan(int iX1, int iX2, int iY, BYTE byClasses); // pixels iX1 to iX2-1
+	void UpdatePlaneSpan(int iX1, int iX2, int iY); // from the pixels
+	void UpdatePlanes();
+};
+
+#endif
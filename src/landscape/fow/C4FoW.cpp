@@ -15,8 +15,10 @@
 
 #include "C4Include.h"
 #include "C4FoW.h"
+#include "C4Game.h"
 
 #include <float.h>
+#include <chrono>
 
 
 C4FoW::C4FoW()
@@ -205,12 +207,116 @@ void C4FoW::Invalidate(C4Rect r)
 void C4FoW::Update(C4Rect r, C4Player *pPlr)
 {
 #ifndef USE_CONSOLE
+	// Only lights with dirty beams in reach of the rectangle need tracing
+	UpdateLights.clear();
 	for (C4FoWLight *pLight = pLights; pLight; pLight = pLight->getNext())
 		if (pLight->IsVisibleForPlayer(pPlr))
-			pLight->Update(r);
+			if (pLight->PrepareUpdate(r))
+				UpdateLights.push_back(pLight);
+	UpdatePrepared(r, ::Game.WorkerPool);
 #endif
 }
 
+#ifndef USE_CONSOLE
+void C4FoW::UpdatePrepared(C4Rect r, StdWorkerPool &Pool)
+{
+	// Sections only change their own beams and read the landscape,
+	// so all of them can be traced at the same time.
+	UpdateSections.clear();
+	for (size_t i = 0; i < UpdateLights.size(); ++i)
+		UpdateSections.insert(UpdateSections.end(), UpdateLights[i]->sections.begin(), UpdateLights[i]->sections.end());
+	if (UpdateSections.empty()) return;
+	UpdateRect = r;
+	Pool.Run(&UpdateSectionsPart, this, UpdateSections.size());
+	for (size_t i = 0; i < UpdateLights.size(); ++i)
+		UpdateLights[i]->FinishUpdate();
+}
+
+void C4FoW::UpdateSectionsPart(void *pData, int32_t iBegin, int32_t iEnd)
+{
+	C4FoW *pFoW = static_cast<C4FoW *>(pData);
+	for (int32_t i = iBegin; i < iEnd; ++i)
+		pFoW->UpdateSections[i]->Update(pFoW->UpdateRect);
+}
+
+void C4FoW::Benchmark(int32_t iLights)
+{
+	if (!GBackWdt || !GBackHgt)
+	{
+		Log("FoW benchmark: no landscape");
+		return;
+	}
+	// free-standing lights that are not part of the light list, placed by random numbers of our own
+	uint32_t seed = 12345;
+	auto random = [&seed](int32_t range) { seed = seed * 1103515245 + 12345; return int32_t((seed >> 8) % range); };
+	std::vector<C4FoWLight *> lights;
+	for (int32_t i = 0; i < iLights; ++i)
+		lights.push_back(new C4FoWLight(random(GBackWdt), random(GBackHgt), 100 + random(200), 80));
+	C4Rect All(0, 0, GBackWdt, GBackHgt);
+	typedef std::chrono::steady_clock Clock;
+
+	// Tracing all beams from scratch, on one thread and on the worker threads
+	StdWorkerPool serial;
+	double traceTimes[2];
+	for (int32_t run = 0; run < 2; ++run)
+	{
+		UpdateLights.clear();
+		for (size_t i = 0; i < lights.size(); ++i)
+		{
+			for (size_t j = 0; j < lights[i]->sections.size(); ++j)
+				lights[i]->sections[j]->Prune(0);
+			lights[i]->fDirty = true;
+			if (lights[i]->PrepareUpdate(All))
+				UpdateLights.push_back(lights[i]);
+		}
+		Clock::time_point start = Clock::now();
+		UpdatePrepared(All, run ? ::Game.WorkerPool : serial);
+		traceTimes[run] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// Small landscape changes: invalidating and updating every light, or only the ones in reach
+	const int32_t steps = 100;
+	double changeTimes[2];
+	for (int32_t run = 0; run < 2; ++run)
+	{
+		seed = 54321;
+		Clock::time_point start = Clock::now();
+		for (int32_t step = 0; step < steps; ++step)
+		{
+			C4Rect Change(random(GBackWdt), random(GBackHgt), 10, 10);
+			UpdateLights.clear();
+			for (size_t i = 0; i < lights.size(); ++i)
+			{
+				if (run)
+				{
+					lights[i]->Invalidate(Change);
+					if (lights[i]->PrepareUpdate(All))
+						UpdateLights.push_back(lights[i]);
+				}
+				else
+				{
+					for (size_t j = 0; j < lights[i]->sections.size(); ++j)
+						lights[i]->sections[j]->Invalidate(Change);
+					UpdateLights.push_back(lights[i]);
+				}
+			}
+			UpdatePrepared(All, serial);
+		}
+		changeTimes[run] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	LogF("FoW benchmark: %d lights, tracing all beams: %.1f ms on one thread, %.1f ms with %d worker threads",
+	     (int) iLights, traceTimes[0], traceTimes[1], (int) ::Game.WorkerPool.GetThreadCount());
+	LogF("FoW benchmark: %d small landscape changes: %.2f ms per change updating all lights, %.2f ms updating lights in reach",
+	     (int) steps, changeTimes[0] / steps, changeTimes[1] / steps);
+
+	UpdateLights.clear();
+	UpdateSections.clear();
+	for (size_t i = 0; i < lights.size(); ++i)
+		delete lights[i];
+}
+#endif
+
 void C4FoW::Render(C4FoWRegion *pRegion, const C4TargetFacet *pOnScreen, C4Player *pPlr, const StdProjectionMatrix& projectionMatrix)
 {
 #ifndef USE_CONSOLE
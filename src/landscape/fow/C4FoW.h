@@ -24,6 +24,8 @@
 #include "C4FoWAmbient.h"
 #include "C4Shader.h"
 
+#include <vector>
+
 /** Simple transformation class which allows translation and scales in x and y.
  * This is typically used to initialize shader uniforms to transform fragment
  * coordinates to some texture coordinates (e.g. landscape coordinates or
@@ -128,11 +130,25 @@ public:
 
 	void Render(class C4FoWRegion *pRegion, const C4TargetFacet *pOnScreen, C4Player *pPlr, const StdProjectionMatrix& projectionMatrix);
 
+#ifndef USE_CONSOLE
+	/** Measures light updates for the given number of lights spread over the landscape (local only, does not affect the game) */
+	void Benchmark(int32_t iLights);
+#endif
+
 private:
 #ifndef USE_CONSOLE
 	// Shader for updating the frame buffer
 	C4Shader FramebufShader;
 	C4Shader RenderShader;
+
+	// Lights that need an update and their sections, which are updated in parallel
+	std::vector<C4FoWLight *> UpdateLights;
+	std::vector<C4FoWLightSection *> UpdateSections;
+	C4Rect UpdateRect;
+
+	/** Updates the sections of all lights in UpdateLights, which must have been prepared */
+	void UpdatePrepared(C4Rect r, StdWorkerPool &Pool);
+	static void UpdateSectionsPart(void *pData, int32_t iBegin, int32_t iEnd);
 #endif
 };
 
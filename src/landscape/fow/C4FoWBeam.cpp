@@ -86,71 +86,56 @@ bool C4FoWBeam::MergeLeft(int32_t x, int32_t y)
 	return true;
 }
 
-bool C4FoWBeam::EliminateRight(int32_t x, int32_t y)
+bool C4FoWBeam::EliminateRight(int32_t x, int32_t y, const C4FoWBeam &rMerge)
 {
 	// Called on the beams left of the one getting eliminated
-	C4FoWBeam *pElim = pNext, *pMerge = pNext->pNext;
-	assert(!!pElim); assert(!!pMerge);
-	assert(!isDirty()); assert(!pMerge->isDirty());
+	assert(!isDirty()); assert(!rMerge.isDirty());
 
 	// Calc errors, add those accumulated on both merged beams
 	int32_t iErr = getDoubleTriangleSurface(
 		getLeftEndX(), getLeftEndY(),
-		pMerge->getRightEndX(), pMerge->getRightEndY(),
+		rMerge.getRightEndX(), rMerge.getRightEndY(),
 		x, y);
-	iErr += pMerge->iError;
+	iErr += rMerge.iError;
 	if (iError + iErr > C4FoWMergeThreshold)
 		return false;
 
 	// Do elimination
-	iRightX = pMerge->iRightX;
-	iRightY = pMerge->iRightY;
-	iRightEndY = pMerge->iRightEndY;
-	pNext = pMerge->pNext;
+	iRightX = rMerge.iRightX;
+	iRightY = rMerge.iRightY;
+	iRightEndY = rMerge.iRightEndY;
 	iError += iErr;
-	delete pElim;
-	delete pMerge;
 	return true;
 }
 
-C4FoWBeam *C4FoWBeam::Split(int32_t x, int32_t y)
+C4FoWBeam C4FoWBeam::Split(int32_t x, int32_t y)
 {
 	// Make sure to never create negative-surface beams
 	assert(isDirty()); assert(isInside(x, y));
 
-	// Allocate a new beam. Ugh, expensive.
-	C4FoWBeam *pBeam = new C4FoWBeam(x, y, iRightX, iRightY);
-	pBeam->Dirty(iLeftEndY);
+	C4FoWBeam beam(x, y, iRightX, iRightY);
+	beam.Dirty(iLeftEndY);
 
 	// Move to make space
 	iRightX = x;
 	iRightY = y;
-
-	// Relink
-	pBeam->pNext = pNext;
-	pNext = pBeam;
-	return pBeam;
+	return beam;
 }
 
-void C4FoWBeam::MergeDirty()
+void C4FoWBeam::MergeDirty(const C4FoWBeam &rWith)
 {
 	// As a rule, dirty beams following each other should
 	// always be merged, so splits can be reverted once
 	// the landscape changes.
-	C4FoWBeam *pWith = pNext;
-	assert(isDirty()); assert(!!pWith); assert(pWith->isDirty());
+	assert(isDirty()); assert(rWith.isDirty());
 
 	// Figure out how far the new dirty beams reaches. Note that
 	// we might lose information about the landscape here.
-	Dirty(std::min(getLeftEndY(), pWith->getLeftEndY()));
+	Dirty(std::min(getLeftEndY(), rWith.getLeftEndY()));
 
 	// Set right
-	iRightX = pWith->iRightX;
-	iRightY = pWith->iRightY;
-
-	// Relink & delete
-	pNext = pWith->getNext();
-	delete pWith;
+	iRightX = rWith.iRightX;
+	iRightY = rWith.iRightY;
 }
 
 void C4FoWBeam::Clean(int32_t y)
@@ -40,8 +40,7 @@ public:
 		: iLeftX(iLeftX), iLeftY(iLeftY), iRightX(iRightX), iRightY(iRightY),
 		  iLeftEndY(0), iRightEndY(0),
 		  iError(0),
-		  fDirty(true),
-		  pNext(NULL)
+		  fDirty(true)
 	{ }
 
 private:
@@ -50,13 +49,10 @@ private:
 	int32_t iLeftEndY, iRightEndY; // where it hit solid material.
 	int32_t iError; // How much error this beam has
 	bool fDirty; // landscape changed since it was followed?
-	C4FoWBeam *pNext;
 
 public:
 	bool isDirty() const { return fDirty; }
 	bool isClean() const { return !fDirty; }
-	C4FoWBeam *getNext() const { return pNext; }
-	void setNext(C4FoWBeam *next) { pNext=next; }
 
 	// Get a point on the beam boundary.
 	inline int32_t getLeftX(int32_t y) const { return iLeftX * y / iLeftY; }
@@ -105,18 +101,19 @@ public:
 	*/
 	bool MergeLeft(int32_t x, int32_t y);
 	
-	/** Split this beam into two: this beam and the returned one. The given point x,y is the position at
-	    which the two resulting beams are connected with their left/right endpoints.
+	/** Split this beam into two: this beam and the returned one, which goes right after it. The given point x,y
+	    is the position at which the two resulting beams are connected with their left/right endpoints.
 	    It is asserted that the given point is inside the previous beam. (So the beam can only made smaller) */
-	C4FoWBeam *Split(int32_t x, int32_t y);
+	C4FoWBeam Split(int32_t x, int32_t y);
 	/** Makes this beam span from its left delimiter point to the right delimiter point of the next but one beam,
-	    removing the two beams in between in the process.
+	    which is given as rMerge. The caller removes the two beams in between afterwards.
 	    In other words, removes the next beam and merges this beam with the next but one beam.
 	    Returns false and does not do the action in case the error threshold would be reached.
 	    */
-	bool EliminateRight(int32_t x, int32_t y);
+	bool EliminateRight(int32_t x, int32_t y, const C4FoWBeam &rMerge);
 	
-	void MergeDirty();
+	/** Merges the following dirty beam into this one. The caller removes it afterwards. */
+	void MergeDirty(const C4FoWBeam &rWith);
 	
 	/** Set a new end point, making the beam "clean". */
 	void Clean(int32_t y);
@@ -196,6 +196,7 @@ void C4FoWDrawLightTextureStrategy::End(C4ShaderCall& call)
 	glBlendEquationSeparate(GL_FUNC_ADD, GL_MAX);
 
 	// Render 1st pass
+	++pDraw->DrawCalls;
 	glDrawElements(GL_TRIANGLES, triangulator.GetNIndices(), GL_UNSIGNED_INT, 0);
 
 	// Prepare state for 2nd pass
@@ -215,6 +216,7 @@ void C4FoWDrawLightTextureStrategy::End(C4ShaderCall& call)
 	}
 	
 	// Render 2nd pass
+	++pDraw->DrawCalls;
 	glDrawElements(GL_TRIANGLES, triangulator.GetNIndices(), GL_UNSIGNED_INT, 0);
 
 	// Prepare state for 3rd pass (color pass)
@@ -237,6 +239,7 @@ void C4FoWDrawLightTextureStrategy::End(C4ShaderCall& call)
 	}
 	
 	// Render 3rd pass
+	++pDraw->DrawCalls;
 	glDrawElements(GL_TRIANGLES, triangulator.GetNIndices(), GL_UNSIGNED_INT, 0);
 
 	// Reset GL state
@@ -400,6 +403,7 @@ void C4FoWDrawWireframeStrategy::End(C4ShaderCall& call)
 	const float y_offset[] = { 0.0f, 0.0f };
 	call.SetUniform2fv(C4FoWRSU_VertexOffset, 1, y_offset);
 
+	++pDraw->DrawCalls;
 	glDrawElements(GL_TRIANGLES, triangulator.GetNIndices(), GL_UNSIGNED_INT, 0);
 
 	// Reset GL state
@@ -35,6 +35,24 @@ C4FoWLight::C4FoWLight(C4Object *pObj)
 	  colorV(1.0), colorL(1.0),
 	  pNext(NULL),
 	  pObj(pObj),
+	  fDirty(true),
+	  sections(4)
+{
+	sections[0] = new C4FoWLightSection(this,0);
+	sections[1] = new C4FoWLightSection(this,90);
+	sections[2] = new C4FoWLightSection(this,180);
+	sections[3] = new C4FoWLightSection(this,270);
+}
+
+C4FoWLight::C4FoWLight(int32_t iX, int32_t iY, int32_t iReach, int32_t iFadeout)
+	: iX(iX), iY(iY),
+	  iReach(iReach),
+	  iFadeout(iFadeout),
+	  iSize(20), gBright(0.5), colorR(1.0), colorG(1.0), colorB(1.0),
+	  colorV(1.0), colorL(1.0),
+	  pNext(NULL),
+	  pObj(NULL),
+	  fDirty(true),
 	  sections(4)
 {
 	sections[0] = new C4FoWLightSection(this,0);
@@ -49,10 +67,21 @@ C4FoWLight::~C4FoWLight()
 		delete sections[i];
 }
 
+bool C4FoWLight::IsInReach(C4Rect r) const
+{
+	// Bounding square of all beams. One pixel of slack, as beams end on the first solid pixel.
+	int32_t iR = getTotalReach() + 1;
+	C4Rect Reach(iX - iR, iY - iR, 2 * iR + 1, 2 * iR + 1);
+	return Reach.Overlap(r);
+}
+
 void C4FoWLight::Invalidate(C4Rect r)
 {
+	// Landscape changes out of reach can't affect any beam
+	if (!IsInReach(r)) return;
 	for(size_t i = 0; i < sections.size(); ++i )
 		sections[i]->Invalidate(r);
+	fDirty = true;
 }
 
 void C4FoWLight::SetReach(int32_t iReach2, int32_t iFadeout2)
@@ -75,6 +104,7 @@ void C4FoWLight::SetReach(int32_t iReach2, int32_t iFadeout2)
 		iReach = iReach2;
 		for(size_t i = 0; i < sections.size(); ++i )
 			sections[i]->Dirty(iReach);
+		fDirty = true;
 	}
 }
 
@@ -96,25 +126,46 @@ void C4FoWLight::SetColor(uint32_t iValue)
 
 void C4FoWLight::Update(C4Rect Rec)
 {
-	// Update position from object.
-	int32_t iNX = fixtoi(pObj->fix_x), iNY = fixtoi(pObj->fix_y);
-	// position may be affected by LightOffset property
-	C4ValueArray *light_offset = pObj->GetPropertyArray(P_LightOffset);
-	if (light_offset)
-	{
-		iNX += light_offset->GetItem(0).getInt();
-		iNY += light_offset->GetItem(1).getInt();
-	}
-	// Clear if we moved in any way
-	if (iNX != iX || iNY != iY)
+	if (!PrepareUpdate(Rec)) return;
+	for(size_t i = 0; i < sections.size(); ++i )
+		sections[i]->Update(Rec);
+	FinishUpdate();
+}
+
+bool C4FoWLight::PrepareUpdate(C4Rect Rec)
+{
+	// Update position from object. Free-standing lights stay where they are.
+	if (pObj)
 	{
-		for(size_t i = 0; i < sections.size(); ++i )
-			sections[i]->Prune(0);
-		iX = iNX; iY = iNY;
+		int32_t iNX = fixtoi(pObj->fix_x), iNY = fixtoi(pObj->fix_y);
+		// position may be affected by LightOffset property
+		C4ValueArray *light_offset = pObj->GetPropertyArray(P_LightOffset);
+		if (light_offset)
+		{
+			iNX += light_offset->GetItem(0).getInt();
+			iNY += light_offset->GetItem(1).getInt();
+		}
+		// Clear if we moved in any way
+		if (iNX != iX || iNY != iY)
+		{
+			for(size_t i = 0; i < sections.size(); ++i )
+				sections[i]->Prune(0);
+			iX = iNX; iY = iNY;
+			fDirty = true;
+		}
 	}
 
+	// Nothing left to trace, or nothing to trace within the rectangle?
+	return fDirty && IsInReach(Rec);
+}
+
+void C4FoWLight::FinishUpdate()
+{
+	// Beams outside of the updated rectangle might still be dirty
+	fDirty = false;
 	for(size_t i = 0; i < sections.size(); ++i )
-		sections[i]->Update(Rec);
+		if (sections[i]->HasDirtyBeams())
+			fDirty = true;
 }
 
 void C4FoWLight::Render(C4FoWRegion *region, const C4TargetFacet *onScreen, C4ShaderCall& call)
@@ -125,7 +176,7 @@ void C4FoWLight::Render(C4FoWRegion *region, const C4TargetFacet *onScreen, C4Sh
 	
 	for(size_t i = 0; i < sections.size(); ++i )
 	{
-		TriangleList sectionTriangles = sections[i]->CalculateTriangles(region);
+		sections[i]->CalculateTriangles(region, sectionTriangles);
 
 		// if the triangles of one section are clipped completely, the neighbouring triangles
 		// must be marked as clipped
@@ -133,7 +184,7 @@ void C4FoWLight::Render(C4FoWRegion *region, const C4TargetFacet *onScreen, C4Sh
 		if(!sectionTriangles.empty()) sectionTriangles.begin()->clipLeft |= clip;
 
 		clip = sectionTriangles.empty();
-		triangles.splice(triangles.end(), sectionTriangles);
+		triangles.insert(triangles.end(), sectionTriangles.begin(), sectionTriangles.end());
 	}
 
 	CalculateFanMaxed(triangles);
@@ -36,6 +36,7 @@ class C4FoWLight
 	friend class C4FoW;
 public:
 	C4FoWLight(C4Object *pObj);
+	C4FoWLight(int32_t iX, int32_t iY, int32_t iReach, int32_t iFadeout); // free-standing light, used for benchmarks
 	~C4FoWLight();
 
 private:
@@ -51,8 +52,10 @@ private:
 	float colorL; // color lightness. 1.0 is maximum.
 	C4FoWLight *pNext;
 	C4Object *pObj; // Associated object
+	bool fDirty; // any section might have dirty beams left
 
 	std::vector<C4FoWLightSection*> sections;
+	std::vector<class C4FoWBeamTriangle> sectionTriangles; // scratch buffer for Render
 
 public:
 	int32_t getX() const { return iX; }
@@ -82,13 +85,18 @@ public:
 	void Invalidate(C4Rect r);
 	/** Update all light beams within the given rectangle for this light */
 	void Update(C4Rect r);
+	/** Follows the associated object and returns whether any section needs an update within the given rectangle.
+	    Must be called on the main thread; the sections can then be updated independently of each other. */
+	bool PrepareUpdate(C4Rect r);
+	/** Called after all sections were updated */
+	void FinishUpdate();
 	/** Render this light*/
 	void Render(class C4FoWRegion *pRegion, const C4TargetFacet *pOnScreen, C4ShaderCall& call);
 
 	bool IsVisibleForPlayer(C4Player *player) const; // check if attached to an object that is not hostile to the given player
 
 private:
-	typedef std::list<class C4FoWBeamTriangle> TriangleList;
+	typedef std::vector<class C4FoWBeamTriangle> TriangleList;
 
 	/** Calculate "normal" fan points - where the normal hasn't maxed out yet */
 	void CalculateFanMaxed(TriangleList &triangles) const;
@@ -108,6 +116,8 @@ private:
 	/** Returns the (squared) distance from this light source to the given point. Squared simply because we only need this
 	    for comparison of distances. So we don't bother to sqrt it */
 	float GetSquaredDistanceTo(int32_t x, int32_t y) const { return (x - getX()) * (x - getX()) + (y - getY()) * (y - getY()); }
+	/** Returns whether the given rectangle might be within reach of the light */
+	bool IsInReach(C4Rect r) const;
 
 	/* Draw strategy instances. We keep them around once created, so they can
 	 * reuse a VBO between individual renderings. */
@@ -54,12 +54,11 @@ C4FoWLightSection::C4FoWLightSection(C4FoWLight *pLight, int r) : pLight(pLight)
 			break;
 	}
 	// Beam list
-	pBeams = new C4FoWBeam(-1, +1, +1, +1);
+	beams.push_back(C4FoWBeam(-1, +1, +1, +1));
 }
 
 C4FoWLightSection::~C4FoWLightSection()
 {
-	ClearBeams();
 }
 
 inline void C4FoWLightSection::LightBallExtremePoint(float x, float y, float dir, float &lightX, float &lightY) const
@@ -86,47 +85,43 @@ template <class T> T C4FoWLightSection::rtransDY(T dx, T dy) const { return T(rc
 template <class T> T C4FoWLightSection::rtransX(T x, T y) const { return rtransDX(x-T(pLight->getX()),y-T(pLight->getY())); }
 template <class T> T C4FoWLightSection::rtransY(T x, T y) const { return rtransDY(x-T(pLight->getX()),y-T(pLight->getY())); }
 
-void C4FoWLightSection::ClearBeams()
-{
-	while (C4FoWBeam *beam = pBeams)
-	{
-		pBeams = beam->getNext();
-		delete beam;
-	}
-}
-
 void C4FoWLightSection::Prune(int32_t reach)
 {
 	if (reach == 0)
 	{
-		ClearBeams();
-		pBeams = new C4FoWBeam(-1, 1, 1, 1);
+		beams.assign(1, C4FoWBeam(-1, 1, 1, 1));
 		return;
 	}
-	// TODO PeterW: Merge active pBeams that we have pruned to same length
-	for (C4FoWBeam *beam = pBeams; beam; beam = beam->getNext())
+	// TODO PeterW: Merge active beams that we have pruned to same length
+	for (std::vector<C4FoWBeam>::iterator beam = beams.begin(); beam != beams.end(); ++beam)
 		beam->Prune(reach);
 }
 
 void C4FoWLightSection::Dirty(int32_t reach)
 {
-	for (C4FoWBeam *beam = pBeams; beam; beam = beam->getNext())
+	for (std::vector<C4FoWBeam>::iterator beam = beams.begin(); beam != beams.end(); ++beam)
 		if (beam->getLeftEndY() >= reach || beam->getRightEndY() >= reach)
 			beam->Dirty(std::min(beam->getLeftEndY(), beam->getRightEndY()));
 }
 
-C4FoWBeam *C4FoWLightSection::FindBeamLeftOf(int32_t x, int32_t y) const
+bool C4FoWLightSection::HasDirtyBeams() const
+{
+	for (std::vector<C4FoWBeam>::const_iterator beam = beams.begin(); beam != beams.end(); ++beam)
+		if (beam->isDirty())
+			return true;
+	return false;
+}
+
+int32_t C4FoWLightSection::FindBeamLeftOf(int32_t x, int32_t y) const
 {
 	// Trivial
 	y = std::max(y, 0);
-	if (!pBeams || !pBeams->isRight(x, y))
-		return NULL;
+	if (beams.empty() || !beams[0].isRight(x, y))
+		return -1;
 	// Go through list
-	// Note: In case this turns out expensive, one might think about implementing
-	// a skip-list. But I highly doubt it.
-	C4FoWBeam *beam = pBeams;
-	while (beam->getNext() && beam->getNext()->isRight(x, y))
-		beam = beam->getNext();
+	int32_t beam = 0;
+	while (beam + 1 < int32_t(beams.size()) && beams[beam + 1].isRight(x, y))
+		beam++;
 	return beam;
 }
 
@@ -140,9 +135,9 @@ void C4FoWLightSection::Update(C4Rect RectIn)
 	if (!::Game.iTick255) {
 		LogSilentF("Full beam list:");
 		StdStrBuf beamsString;
-		for(C4FoWBeam *beam = pBeams; beam; beam = beam->getNext()) {
-			beamsString.ApendBeamChar(' ');
-			beamsString.ApendBeam(beam->getDesc());
+		for(size_t i = 0; i < beams.size(); i++) {
+			beamsString.AppendChar(' ');
+			beamsString.Append(beams[i].getDesc());
 		}
 		LogSilent(beamsString.getData());
 	}
@@ -166,41 +161,41 @@ void C4FoWLightSection::Update(C4Rect RectIn)
 	        ry = RectRightMostY(Rect),
 	        rx = RectRightMostX(Rect);
 
-	C4FoWBeam *startBeam = FindBeamLeftOf(lx, ly);
+	int32_t startBeam = FindBeamLeftOf(lx, ly);
 
 	// Skip clean beams
-	while (C4FoWBeam *nextBeam = startBeam ? startBeam->getNext() : pBeams) {
-		if (nextBeam->isDirty()) break;
-		startBeam = nextBeam;
+	while (startBeam + 1 < int32_t(beams.size())) {
+		if (beams[startBeam + 1].isDirty()) break;
+		startBeam++;
 	}
 	// Find end beam, determine at which position we have to start scanning
-	C4FoWBeam *beam = startBeam ? startBeam->getNext() : pBeams;
+	int32_t beam = startBeam + 1;
 #ifdef LIGHT_DEBUG
-	if (beam)
-		LogSilentF("Start beam is %s", beam->getDesc().getData());
+	if (beam < int32_t(beams.size()))
+		LogSilentF("Start beam is %s", beams[beam].getDesc().getData());
 #endif
-	C4FoWBeam *endBeam = NULL;
+	int32_t endBeam = -1;
 	int32_t startY = Rect.GetBottom();
-	while (beam && !beam->isLeft(rx, ry)) {
-		if (beam->isDirty() && beam->getLeftEndY() <= Rect.y + Rect.Hgt) {
+	while (beam < int32_t(beams.size()) && !beams[beam].isLeft(rx, ry)) {
+		if (beams[beam].isDirty() && beams[beam].getLeftEndY() <= Rect.y + Rect.Hgt) {
 			endBeam = beam;
-			startY = std::min(startY, beam->getLeftEndY());
+			startY = std::min(startY, beams[beam].getLeftEndY());
 		}
-		beam = beam->getNext();
+		beam++;
 	}
 
 	// Can skip scan completely?
-	if (!endBeam)
+	if (endBeam < 0)
 		return;
 
 	// Update right end coordinates
 #ifdef LIGHT_DEBUG
-	LogSilentF("End beam is %s", endBeam->getDesc().getData());
+	LogSilentF("End beam is %s", beams[endBeam].getDesc().getData());
 #endif
 
-	if (endBeam->isRight(rx, ry)) {
-		rx = endBeam->getRightEndX() + 1;
-		ry = endBeam->getRightEndY();
+	if (beams[endBeam].isRight(rx, ry)) {
+		rx = beams[endBeam].getRightEndX() + 1;
+		ry = beams[endBeam].getRightEndY();
 	}
 
 	// Bottom of scan - either bound by rectangle or by light's reach
@@ -217,31 +212,32 @@ void C4FoWLightSection::Update(C4Rect RectIn)
 			ignoreX = int(sqrt(pLight->getSize() * pLight->getSize() - y * y));
 		}
 
-		// Scan all pBeams
-		C4FoWBeam *lastBeam = startBeam;
+		// Scan all beams. Splits and merges only insert and remove beams right
+		// of lastBeam, so the indices up to there stay valid.
+		int32_t lastBeam = startBeam;
 		int32_t dirty = 0;
-		for(C4FoWBeam *beam = startBeam ? startBeam->getNext() : pBeams; beam; lastBeam = beam, beam = beam->getNext())
+		for(int32_t beam = startBeam + 1; beam < int32_t(beams.size()); lastBeam = beam, beam++)
 		{
-			assert(lastBeam ? lastBeam->getNext() == beam : beam == pBeams);
+			assert(lastBeam == beam - 1);
 
 			// Clean (enough)?
-			if (!beam->isDirty() || y < beam->getLeftEndY())
+			if (!beams[beam].isDirty() || y < beams[beam].getLeftEndY())
 				continue;
 
 			// Out left?
-			if (beam->isRight(lx, ly))
+			if (beams[beam].isRight(lx, ly))
 				continue;
 			// Out right?
-			if (beam->isLeft(rx, ry))
+			if (beams[beam].isLeft(rx, ry))
 				break;
 
 			// We have an active beam that we're about to scan
 			dirty++;
-			beam->Dirty(y+1);
+			beams[beam].Dirty(y+1);
 
 			// Do a scan
-			int32_t xl = std::max(beam->getLeftX(y), Bounds.x),
-			        xr = std::min(beam->getRightX(y), Bounds.x+Bounds.Wdt-1);
+			int32_t xl = std::max(beams[beam].getLeftX(y), Bounds.x),
+			        xr = std::min(beams[beam].getRightX(y), Bounds.x+Bounds.Wdt-1);
 			for(int32_t x = xl; x <= xr; x++)
 			{
 				// Ignore material up to a certain distance (see above)
@@ -261,31 +257,33 @@ void C4FoWLightSection::Update(C4Rect RectIn)
 
 				// Split points
 				int32_t x1 = x - 1, x2 = x + 1;
-				bool splitLeft = !beam->isLeft(x1, y);
-				bool splitRight = !beam->isRight(x2, y);
+				bool splitLeft = !beams[beam].isLeft(x1, y);
+				bool splitRight = !beams[beam].isRight(x2, y);
+				bool hasNext = beam + 1 < int32_t(beams.size());
 
 				// Double merge?
-				if (!splitLeft && !splitRight && lastBeam && beam->getNext())
+				if (!splitLeft && !splitRight && lastBeam >= 0 && hasNext)
 				{
-					if(lastBeam->EliminateRight(x,y))
+					if(beams[lastBeam].EliminateRight(x, y, beams[beam + 1]))
 					{
+						beams.erase(beams.begin() + beam, beams.begin() + beam + 2);
 						beam = lastBeam;
 						break; // no typo. fSplitRight => x == xr
 					}
 				}
 
 				// Merge possible?
-				if (!splitLeft && splitRight && lastBeam)
-					if (lastBeam->MergeRight(x2, y))
+				if (!splitLeft && splitRight && lastBeam >= 0)
+					if (beams[lastBeam].MergeRight(x2, y))
 					{
-						beam->SetLeft(x2, y);
-						assert(beam->isDirty());
+						beams[beam].SetLeft(x2, y);
+						assert(beams[beam].isDirty());
 						continue;
 					}
-				if (splitLeft && !splitRight && beam->getNext())
-					if (beam->getNext()->MergeLeft(x1, y))
+				if (splitLeft && !splitRight && hasNext)
+					if (beams[beam + 1].MergeLeft(x1, y))
 					{
-						beam->SetRight(x1, y);
+						beams[beam].SetRight(x1, y);
 						break; // no typo. fSplitRight => x == xr
 					}
 
@@ -293,25 +291,27 @@ void C4FoWLightSection::Update(C4Rect RectIn)
 				if (splitLeft)
 				{
 					lastBeam = beam;
-					beam = lastBeam->Split(x1, y);
-					assert(lastBeam->getNext() == beam);
+					C4FoWBeam splitBeam = beams[lastBeam].Split(x1, y);
+					beam = lastBeam + 1;
+					beams.insert(beams.begin() + beam, splitBeam);
 				}
 
 				// Split out right
 				if(splitRight)
 				{
 					lastBeam = beam;
-					beam = lastBeam->Split(x2, y);
-					assert(lastBeam->getNext() == beam);
+					C4FoWBeam splitBeam = beams[lastBeam].Split(x2, y);
+					beam = lastBeam + 1;
+					beams.insert(beams.begin() + beam, splitBeam);
 
 					// Deactivate left/middle beam
-					lastBeam->Clean(y);
-					assert(beam->isDirty());
+					beams[lastBeam].Clean(y);
+					assert(beams[beam].isDirty());
 				}
 				else
 				{
 					// Deactivate beam
-					beam->Clean(y);
+					beams[beam].Clean(y);
 					break;
 				}
 			}
@@ -325,17 +325,17 @@ void C4FoWLightSection::Update(C4Rect RectIn)
 	// At end of light's reach? Mark all pBeams that got scanned all the way to the end as clean.
 	// There's no need to scan them anymore.
 	if (y >= pLight->getReach()) {
-		for (C4FoWBeam *beam = startBeam ? startBeam->getNext() : pBeams; beam; beam = beam->getNext())
-			if (beam->isDirty() && beam->getLeftEndY() > pLight->getReach())
-				beam->Clean(pLight->getReach());
+		for (size_t i = startBeam + 1; i < beams.size(); i++)
+			if (beams[i].isDirty() && beams[i].getLeftEndY() > pLight->getReach())
+				beams[i].Clean(pLight->getReach());
 	}
 
 #ifdef LIGHT_DEBUG
 	LogSilentF("Updated beam list:");
-	for(C4FoWBeam *beam = startBeam ? startBeam->getNext() : pBeams; beam; beam = beam->getNext()) {
-		if (beam->isLeft(iRX, iRY))
+	for(size_t i = startBeam + 1; i < beams.size(); i++) {
+		if (beams[i].isLeft(rx, ry))
 			break;
-		LogSilent(beam->getDesc().getData());
+		LogSilent(beams[i].getDesc().getData());
 	}
 #endif
 }
@@ -358,36 +358,34 @@ void C4FoWLightSection::Invalidate(C4Rect r)
 	        lx = RectLeftMostX(r),
 	        ry = RectRightMostY(r),
 	        rx = RectRightMostX(r);
-	C4FoWBeam *lastBeam = FindBeamLeftOf(lx, ly);
-	C4FoWBeam *beam = lastBeam ? lastBeam->getNext() : pBeams;
 
-	// Scan over beams
-	while (beam && !beam->isLeft(rx, ry))
+	// Scan over beams. Beams merged into the last kept one are dropped, and
+	// the others moved to the left, so the array only gets compacted once.
+	size_t first = FindBeamLeftOf(lx, ly) + 1;
+	size_t beam = first, lastBeam = first;
+	for (; beam < beams.size() && !beams[beam].isLeft(rx, ry); beam++)
 	{
+		C4FoWBeam current = beams[beam];
+
 		// Dirty beam?
-		if (beam->getLeftEndY() > r.y || beam->getRightEndY() > r.y)
-			beam->Dirty(r.y);
+		if (current.getLeftEndY() > r.y || current.getRightEndY() > r.y)
+			current.Dirty(r.y);
 
 		// Merge with last beam?
-		if (lastBeam && lastBeam->isDirty() && beam->isDirty())
-		{
-			lastBeam->MergeDirty();
-			beam = lastBeam->getNext();
-		}
-		else		// Advance otherwise
-		{
-			lastBeam = beam;
-			beam = beam->getNext();
-		}
+		if (lastBeam > 0 && beams[lastBeam - 1].isDirty() && current.isDirty())
+			beams[lastBeam - 1].MergeDirty(current);
+		else		// Keep otherwise
+			beams[lastBeam++] = current;
 	}
 
-	// Final check for merging dirty pBeams on the right end
-	if (lastBeam && beam && lastBeam->isDirty() && beam->isDirty())
-		lastBeam->MergeDirty();
+	// Final check for merging dirty beams on the right end
+	if (lastBeam > 0 && beam < beams.size() && beams[lastBeam - 1].isDirty() && beams[beam].isDirty())
+		beams[lastBeam - 1].MergeDirty(beams[beam++]);
 
+	beams.erase(beams.begin() + lastBeam, beams.begin() + beam);
 }
 
-int32_t C4FoWLightSection::FindBeamsClipped(const C4Rect &rect, C4FoWBeam *&firstBeam, C4FoWBeam *&endBeam) const
+int32_t C4FoWLightSection::FindBeamsClipped(const C4Rect &rect, int32_t &firstBeam, int32_t &endBeam) const
 {
 	if(rect.y + rect.Hgt < 0) return 0;
 
@@ -396,20 +394,15 @@ int32_t C4FoWLightSection::FindBeamsClipped(const C4Rect &rect, C4FoWBeam *&firs
 	        ry = RectRightMostY(rect),
 	        rx = RectRightMostX(rect);
 
-	C4FoWBeam *pPrev = FindBeamLeftOf(lx, ly);
-	firstBeam = pPrev ? pPrev->getNext() : pBeams;
+	firstBeam = FindBeamLeftOf(lx, ly) + 1;
 
-	// Find end beam - determine the number of pBeams we actually need to draw
-	C4FoWBeam *beam = firstBeam;
-	int32_t beamCount = 0;
-	while (beam && !beam->isLeft(rx, ry))
-	{
-		beam = beam->getNext();
-		beamCount++;
-	}
+	// Find end beam - determine the number of beams we actually need to draw
+	int32_t beam = firstBeam;
+	while (beam < int32_t(beams.size()) && !beams[beam].isLeft(rx, ry))
+		beam++;
 	endBeam = beam;
 
-	return beamCount;
+	return endBeam - firstBeam;
 }
 
 
@@ -438,22 +431,22 @@ static inline bool find_cross(float x1, float y1, float x2, float y2,
 	return true;
 }
 
-std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *region) const
+void C4FoWLightSection::CalculateTriangles(C4FoWRegion *region, std::vector<C4FoWBeamTriangle> &result) const
 {
-	C4FoWBeam *startBeam = NULL, *endBeam = NULL;
+	int32_t startBeam = 0, endBeam = 0;
 	int32_t beamCount = FindBeamsClipped(rtransRect(region->getRegion()), startBeam, endBeam);
-	std::list<C4FoWBeamTriangle> result;
+	result.clear();
 	float crossX=0.0f, crossY=0.0f;
 
 	// no beams inside the rectangle? Good, nothing to render 
-	if(!beamCount) return result;
+	if(!beamCount) return;
 
-	bool isStartClipped = startBeam != pBeams;
-	bool isEndClipped = !!endBeam;
+	bool isStartClipped = startBeam != 0;
+	bool isEndClipped = endBeam != int32_t(beams.size());
 
-	C4FoWBeam *beam = startBeam;
-	for (int32_t i = 0; i < beamCount; i++, beam = beam->getNext())
+	for (int32_t i = 0; i < beamCount; i++)
 	{
+		const C4FoWBeam *beam = &beams[startBeam + i];
 		C4FoWBeamTriangle tri;
 		tri.fanLX = beam->getLeftEndXf();
 		tri.fanLY = float(beam->getLeftEndY());
@@ -470,7 +463,7 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 			result.push_back(tri);
 	}
 
-	if(result.empty()) return result;
+	if(result.empty()) return;
 
 	// Phase 1: Project lower point so it lies on a line with outer left/right
 	// light lines.
@@ -483,10 +476,9 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 		// algorithm robust against light size depending on distance. Sadly
 		// makes the whole algorithm O(n^2)...
 		float bestLevel = FLT_MAX;
-		for (std::list<C4FoWBeamTriangle>::iterator it = result.begin(), nextIt; it != --result.end(); ++it)
+		for (size_t it = 0; it + 1 < result.size(); ++it)
 		{
-			nextIt = it; ++nextIt;
-			float level = std::min(it->fanRY, nextIt->fanLY);
+			float level = std::min(result[it].fanRY, result[it + 1].fanLY);
 			if (level <= scanLevel || level >= bestLevel)
 				continue;
 			bestLevel = level;
@@ -499,10 +491,10 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 		// most of the time, but can't be too careful. Especially note that
 		// we will make extra loops after removing rays, so we can check the
 		// new neighbouring relation for consistency.
-		for(std::list<C4FoWBeamTriangle>::iterator it = result.begin(), nextIt; it != --result.end(); it = nextIt)
+		for(size_t it = 0, nextIt; it + 1 < result.size(); it = nextIt)
 		{
-			nextIt = it; ++nextIt;
-			C4FoWBeamTriangle tri = *it, nextTri = *nextIt;
+			nextIt = it + 1;
+			C4FoWBeamTriangle tri = result[it], nextTri = result[nextIt];
 
 			// Skip ray pairs that do not match the current level (see above)
 			float level = std::min(tri.fanRY, nextTri.fanLY);
@@ -512,13 +504,13 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 			// Debugging
             //#define FAN_STEP_DEBUG
 #ifdef FAN_STEP_DEBUG
-			LogSilentF("Fan step %d (i=%d)", step, std::distance(result.begin(),it));
-			for (std::list<C4FoWBeamTriangle>::iterator it2 = result.begin(); it2 != result.end(); it2++) {
+			LogSilentF("Fan step %d (i=%d)", step, int(it));
+			for (size_t it2 = 0; it2 < result.size(); it2++) {
 				const char *marker = "";
 				if (it2 == it) marker = " (it)";
 				if (it2 == nextIt) marker = " (nextIt)";
-				LogSilentF(" %.010f %.010f%s", it2->fanLX, it2->fanLY, marker);
-				LogSilentF(" %.010f %.010f%s", it2->fanRX, it2->fanRY, marker);
+				LogSilentF(" %.010f %.010f%s", result[it2].fanLX, result[it2].fanLY, marker);
+				LogSilentF(" %.010f %.010f%s", result[it2].fanRX, result[it2].fanRY, marker);
 			}
 #endif
 
@@ -542,7 +534,7 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 					assert(tri.fanRY <= tri.fanLY);
 					tri.fanLX = tri.fanRX;
 					tri.fanLY = tri.fanRY;
-					*it = tri;
+					result[it] = tri;
 				}
 
 				// The threshold decides at what point we are going to eliminate
@@ -584,12 +576,13 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 				if (b >= threshold)
 				{
 					// Can't eliminate it?
-					if (it == result.begin())
+					if (it == 0)
 						continue;
 
 					// Remove the beam.
-					it = nextIt = result.erase(it);
-					tri = *--it;
+					result.erase(result.begin() + it);
+					nextIt = it--;
+					tri = result[it];
 					// Now decide how to proceed: If the new previous ray (it)
 					// is farther away, we have to repeat this whole check
 					// because this one (nextIt) might shadow it as well.
@@ -631,7 +624,7 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 					// This shouldn't change the case we are in (uh, I think)
 					assert(tri.fanRY > nextTri.fanLY);
 					// Write back
-					*it = tri;
+					result[it] = tri;
 					continue;
 				}
 
@@ -645,7 +638,7 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 					assert(nextTri.fanLY <= nextTri.fanRY);
 					nextTri.fanRX = nextTri.fanLX;
 					nextTri.fanRY = nextTri.fanLY;
-					*nextIt = nextTri;
+					result[nextIt] = nextTri;
 				}
 				float fanRXp = nextTri.fanRX;
 				float threshold = 0.0f;
@@ -664,10 +657,10 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 				assert(f); (void) f;
 				if (b <= threshold)
 				{
-					if (nextIt == --result.end())
+					if (nextIt == result.size() - 1)
 						continue;
-					nextIt = result.erase(nextIt);
-					nextTri = *nextIt;
+					result.erase(result.begin() + nextIt);
+					nextTri = result[nextIt];
 					if (nextTri.fanLY > tri.fanRY)
 					{
 						nextIt = it;
@@ -685,7 +678,7 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 					nextTri.fanLX = crossX;
 					nextTri.fanLY = crossY;
 					assert(tri.fanRY < nextTri.fanLY);
-					*nextIt = nextTri;
+					result[nextIt] = nextTri;
 					continue;
 				}
 
@@ -730,7 +723,7 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 			newTriangle.fanRX = crossX;
 			newTriangle.fanRY = crossY;
 
-			nextIt = result.insert(nextIt, newTriangle);
+			result.insert(result.begin() + nextIt, newTriangle);
 
 			// Jump over surface. Note that our right beam might get
 			// eliminated later on, causing us to back-track into this
@@ -739,19 +732,19 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 			// further to the left, which is exactly how it should work.
 			++nextIt;
 
-		} // end for(std::list<C4FoWBeamTriangle>::iterator it = result.begin(), nextIt = it; it != --result.end(); ++it) loop
+		} // end for(size_t it = 0, nextIt; it + 1 < result.size(); it = nextIt) loop
 	} // end for (int step = 0; step < 100000; step++) loop
 
 #ifdef FAN_STEP_DEBUG
 	LogSilentF("Fan output");
-	for (std::list<C4FoWBeamTriangle>::iterator it2 = result.begin(); it2 != result.end(); it2++) {
-		LogSilentF(" %.010f %.010f", it2->fanLX, it2->fanLY);
-		LogSilentF(" %.010f %.010f", it2->fanRX, it2->fanRY);
+	for (size_t it2 = 0; it2 < result.size(); it2++) {
+		LogSilentF(" %.010f %.010f", result[it2].fanLX, result[it2].fanLY);
+		LogSilentF(" %.010f %.010f", result[it2].fanRX, result[it2].fanRY);
 	}
 #endif
 
 	// Phase 2: Calculate fade points
-	for (std::list<C4FoWBeamTriangle>::iterator it = result.begin(); it != result.end(); ++it)
+	for (std::vector<C4FoWBeamTriangle>::iterator it = result.begin(); it != result.end(); ++it)
 	{
 		C4FoWBeamTriangle &tri = *it;
 
@@ -790,13 +783,11 @@ std::list<C4FoWBeamTriangle> C4FoWLightSection::CalculateTriangles(C4FoWRegion *
 	}
 
 	transTriangles(result);
-	
-	return result;
 }
 
-void C4FoWLightSection::transTriangles(std::list<C4FoWBeamTriangle> &triangles) const
+void C4FoWLightSection::transTriangles(std::vector<C4FoWBeamTriangle> &triangles) const
 {
-	for (std::list<C4FoWBeamTriangle>::iterator it = triangles.begin(); it != triangles.end(); ++it)
+	for (std::vector<C4FoWBeamTriangle>::iterator it = triangles.begin(); it != triangles.end(); ++it)
 	{
 		C4FoWBeamTriangle &tri = *it;
 		float x,y;
@@ -832,26 +823,16 @@ void C4FoWLightSection::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(rd, "rd"));
 	if (pComp->isDecompiler())
 	{
-		for (C4FoWBeam *beam = pBeams; beam; beam = beam->getNext())
-			pComp->Value(mkNamingAdapt(*beam, "Beam"));
+		for (size_t i = 0; i < beams.size(); ++i)
+			pComp->Value(mkNamingAdapt(beams[i], "Beam"));
 	}
 	else
 	{
-		ClearBeams();
 		int32_t beam_count = 0;
 		pComp->Value(mkNamingCountAdapt<int32_t>(beam_count, "Beam"));
-		C4FoWBeam *last_beam = NULL;
+		beams.assign(beam_count, C4FoWBeam(0, 0, 0, 0));
 		for (int32_t i = 0; i < beam_count; ++i)
-		{
-			std::unique_ptr<C4FoWBeam> beam(new C4FoWBeam(0, 0, 0, 0));
-			pComp->Value(mkNamingAdapt(*beam, "Beam"));
-			C4FoWBeam *new_beam = beam.release();
-			if (!last_beam)
-				pBeams = new_beam;
-			else
-				last_beam->setNext(new_beam);
-			last_beam = new_beam;
-		}
+			pComp->Value(mkNamingAdapt(beams[i], "Beam"));
 	}
 }
 
@@ -19,11 +19,11 @@
 #ifndef USE_CONSOLE
 
 #include "C4Rect.h"
-#include <list>
+#include "C4FoWBeam.h"
+#include <vector>
 
 class C4FoWLight;
 class C4FoWRegion;
-class C4FoWBeam;
 class C4FoWBeamTriangle;
 
 /** The light section manages the beams for one light for one direction of 90.
@@ -48,18 +48,21 @@ private:
 	int a, b, c, d;
 	int ra, rb, rc, rd;
 
-	/* This section's beams */
-	C4FoWBeam *pBeams;
+	/* This section's beams, from left to right */
+	std::vector<C4FoWBeam> beams;
 	
 public:
 	
 	/** Recalculate of all light beams within the given rectangle because the landscape changed. */
 	void Invalidate(C4Rect r);
-	/** Update all light beams within the given rectangle */
+	/** Update all light beams within the given rectangle. Only touches this section, so the
+	    sections of all lights can be updated in parallel. */
 	void Update(C4Rect r);
+	/** Whether some beams still need to be followed by Update */
+	bool HasDirtyBeams() const;
 
-
-	std::list<C4FoWBeamTriangle> CalculateTriangles(C4FoWRegion *region) const;
+	/** Replaces the contents of result by the triangles to render */
+	void CalculateTriangles(C4FoWRegion *region, std::vector<C4FoWBeamTriangle> &result) const;
 
 	/** Shorten all light beams to the given reach.
 	    Called when the size of the light has decreased to the given value */
@@ -70,9 +73,6 @@ public:
 
 private:
 
-	/** Remove all beams. pBeams is NULL after that. */
-	void ClearBeams();
-
 	// Beam coordinate to landscape coordinate. Beam coordinates are relative to the light source.
 	template <class T> T transDX(T dx, T dy) const;
 	template <class T> T transDY(T dx, T dy) const;
@@ -86,7 +86,7 @@ private:
 	template <class T> T rtransY(T x, T y) const;
 
 	/** Convert triangles to landscape coordinates */
-	void transTriangles(std::list<C4FoWBeamTriangle> &triangles) const;
+	void transTriangles(std::vector<C4FoWBeamTriangle> &triangles) const;
 
 	/** Returns a rectangle in beam coordinates */
 	C4Rect rtransRect(C4Rect r) const {
@@ -122,13 +122,13 @@ private:
 	inline void LightBallLeftMostPoint(float x, float y, float &lightX, float &lightY) const;
 
 
-	/** Find right-most beam left of point */
-	C4FoWBeam *FindBeamLeftOf(int32_t x, int32_t y) const;
+	/** Find the index of the right-most beam left of point, or -1 if there is none */
+	int32_t FindBeamLeftOf(int32_t x, int32_t y) const;
 
-	/** Find beams that go through the given rectangle. Returns the number of beams that are in the rectangle and makes
-	    firstBeam point to the first and endBeam point to the beam after the last of these. Thus, endBeam is NULL if 
-		no beams were clipped at the end. */
-	int32_t FindBeamsClipped(const C4Rect &rect, C4FoWBeam *&firstBeam, C4FoWBeam *&endBeam) const;
+	/** Find beams that go through the given rectangle. Returns the number of beams that are in the rectangle and sets
+	    firstBeam to the index of the first and endBeam to the index of the beam after the last of these. Thus, endBeam
+		is the number of beams if no beams were clipped at the end. */
+	int32_t FindBeamsClipped(const C4Rect &rect, int32_t &firstBeam, int32_t &endBeam) const;
 
 public:
 	// Serialization for debugging purposes
@@ -319,6 +319,7 @@ bool C4FoWRegion::Render(const C4TargetFacet *pOnScreen)
 			glVertexAttribPointer(pShader->GetAttribute(C4FoWFSA_TexCoord), 2, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<const uint8_t*>(0));
 		}
 
+		++pDraw->DrawCalls;
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
 		glBindVertexArray(0);
@@ -32,6 +32,7 @@
 #include <C4Components.h>
 #include <C4Window.h>
 #include <C4Shader.h>
+#include <StdScheduler.h>
 
 #ifdef HAVE_SYS_FILE_H
 #include <sys/file.h>
@@ -41,13 +42,156 @@
 #include <share.h>
 #endif
 
+#ifdef _WIN32
+#include <io.h>
+#endif
+
 FILE *C4LogFile=NULL;
+FILE *C4LogJSONFile=NULL;
 FILE *C4ShaderLogFile = NULL;
 time_t C4LogStartTime;
 StdStrBuf sLogFileName;
 
 StdStrBuf sFatalError;
 
+// Writes the log file and the console on a background thread. The main thread
+// only appends finished lines to the queue; the writer takes the whole queue
+// at once and writes it with one flush per file, so heavy logging doesn't stall
+// the game on file or terminal I/O.
+class C4LogWriter : public StdThread
+{
+public:
+	C4LogWriter() : WakeEvent(false), DrainedEvent(false), iQueued(0), iWritten(0) { }
+
+	void Add(const char *szText, const char *szJSON, bool fConsole);
+	void Flush(); // wait until everything added so far has been written
+	void Drain(); // write everything queued; writer thread, or any thread if the writer isn't running
+	void Wake() { WakeEvent.Set(); }
+	void WriteOnCrash(); // write the queue without locking; only for crash handlers
+
+protected:
+	virtual void Execute();
+
+private:
+	// queued text for log file, JSON log file and console
+	std::string File, JSON, Console;
+	CStdCSec QueueLock;
+	CStdEvent WakeEvent, DrainedEvent;
+	uint32_t iQueued, iWritten; // number of Add calls queued and written
+};
+
+// Never destroyed: the application closes the log from its destructor, which
+// may run after the statics of this file are gone
+static C4LogWriter &LogWriter = *new C4LogWriter;
+// Flush when this many bytes are queued, so a log flood can't eat all memory
+static const size_t C4LogWriter_MaxQueue = 4 * 1024 * 1024;
+
+void C4LogWriter::Add(const char *szText, const char *szJSON, bool fConsole)
+{
+	bool fFull;
+	{
+		CStdLock Lock(&QueueLock);
+		if (C4LogFile) File.append(szText);
+		if (C4LogJSONFile && szJSON) JSON.append(szJSON);
+		if (fConsole) Console.append(szText);
+		++iQueued;
+		fFull = File.size() + Console.size() + JSON.size() > C4LogWriter_MaxQueue;
+	}
+	if (!IsStarted())
+		Drain();
+	else if (fFull)
+		Flush();
+	else
+		WakeEvent.Set();
+}
+
+void C4LogWriter::Flush()
+{
+	if (!IsStarted()) { Drain(); return; }
+	uint32_t iTarget;
+	{ CStdLock Lock(&QueueLock); iTarget = iQueued; }
+	for (;;)
+	{
+		{ CStdLock Lock(&QueueLock); if (int32_t(iWritten - iTarget) >= 0) return; }
+		WakeEvent.Set();
+		DrainedEvent.WaitFor(100);
+	}
+}
+
+void C4LogWriter::Drain()
+{
+	std::string WriteFile, WriteJSON, WriteConsole;
+	uint32_t iBatch;
+	{
+		CStdLock Lock(&QueueLock);
+		WriteFile.swap(File); WriteJSON.swap(JSON); WriteConsole.swap(Console);
+		iBatch = iQueued;
+	}
+	if (!WriteFile.empty() && C4LogFile)
+	{
+		fwrite(WriteFile.c_str(), 1, WriteFile.size(), C4LogFile);
+		fflush(C4LogFile);
+	}
+	if (!WriteJSON.empty() && C4LogJSONFile)
+	{
+		fwrite(WriteJSON.c_str(), 1, WriteJSON.size(), C4LogJSONFile);
+		fflush(C4LogJSONFile);
+	}
+	if (!WriteConsole.empty())
+	{
+		fwrite(WriteConsole.c_str(), 1, WriteConsole.size(), stdout);
+		fflush(stdout);
+	}
+	{ CStdLock Lock(&QueueLock); iWritten = iBatch; }
+	DrainedEvent.Set();
+}
+
+// unbuffered write for crash handlers, which must not enter stdio
+static void WriteFD(int fd, const std::string &rsText)
+{
+	const char *pData = rsText.c_str();
+	size_t iLeft = rsText.size();
+	while (iLeft)
+	{
+#ifdef _WIN32
+		int iWritten = _write(fd, pData, unsigned(iLeft));
+#else
+		ssize_t iWritten = write(fd, pData, iLeft);
+#endif
+		if (iWritten <= 0) return;
+		pData += iWritten; iLeft -= iWritten;
+	}
+}
+
+void C4LogWriter::WriteOnCrash()
+{
+	// no locking and no allocation: the main thread may have crashed inside Add
+	// Drain flushes after every write, so the stdio buffers hold nothing older
+	if (C4LogFile) WriteFD(fileno(C4LogFile), File);
+	if (C4LogJSONFile) WriteFD(fileno(C4LogJSONFile), JSON);
+	WriteFD(fileno(stdout), Console);
+}
+
+void C4LogWriter::Execute()
+{
+	WakeEvent.WaitFor(100);
+	Drain();
+}
+
+// Rate limiting: identical consecutive messages beyond Config.General.LogRepeatLimit are counted instead of written
+static StdCopyStrBuf &LastLogMessage = *new StdCopyStrBuf; // never destroyed, like LogWriter
+static int32_t iLastLogMessageRepeats = 0, iLastLogMessageSkipped = 0;
+static bool fLastLogMessageConsole = false;
+static const char *szLastLogMessageSubsystem = NULL;
+static bool LogLine(const char *szMessage, bool fConsole, const char *szSubsystem);
+
+static void LogSkippedRepeats()
+{
+	if (iLastLogMessageSkipped)
+		LogLine(FormatString("(previous message repeated %d more times)", (int) iLastLogMessageSkipped).getData(), fLastLogMessageConsole, szLastLogMessageSubsystem);
+	iLastLogMessageSkipped = 0;
+}
+
 bool OpenLog()
 {
 	// open
@@ -68,6 +212,15 @@ bool OpenLog()
 		// try different name
 		sLogFileName.Format(C4CFN_LogEx, iLog++);
 	}
+	// structured log next to the text log
+	if (Config.General.LogJSON)
+	{
+		StdStrBuf sJSONFileName(sLogFileName);
+		sJSONFileName.Append(".jsonl");
+		C4LogJSONFile = fopen(Config.AtUserDataPath(sJSONFileName.getData()), "wb");
+	}
+	// start writer
+	if (Config.General.LogAsync) LogWriter.Start();
 	// save start time
 	time(&C4LogStartTime);
 	return true;
@@ -99,13 +252,39 @@ bool OpenExtraLogs()
 
 bool CloseLog()
 {
+	// the count of a suppressed repetition would be lost otherwise
+	LogSkippedRepeats();
+	LastLogMessage.Clear();
+	iLastLogMessageRepeats = 0;
+	// write everything before closing
+	if (LogWriter.IsStarted())
+	{
+		LogWriter.SignalStop();
+		LogWriter.Wake();
+		LogWriter.Stop();
+	}
+	LogWriter.Drain();
 	// close
-	if (C4ShaderLogFile) fclose(C4ShaderLogFile); C4ShaderLogFile = NULL;
-	if (C4LogFile) fclose(C4LogFile); C4LogFile = NULL;
+	if (C4ShaderLogFile) fclose(C4ShaderLogFile);
+	C4ShaderLogFile = NULL;
+	if (C4LogJSONFile) fclose(C4LogJSONFile);
+	C4LogJSONFile = NULL;
+	if (C4LogFile) fclose(C4LogFile);
+	C4LogFile = NULL;
 	// ok
 	return true;
 }
 
+void FlushLog()
+{
+	LogWriter.Flush();
+}
+
+void FlushLogOnCrash()
+{
+	LogWriter.WriteOnCrash();
+}
+
 int GetLogFD()
 {
 	if (C4LogFile)
@@ -114,17 +293,35 @@ int GetLogFD()
 		return -1;
 }
 
-bool LogSilent(const char *szMessage, bool fConsole)
+static void AppendJSONString(std::string &rsOut, const char *szText)
 {
-	if (!Application.AssertMainThread()) return false;
-	// security
-	if (!szMessage) return false;
+	rsOut += '"';
+	for (; *szText; ++szText)
+	{
+		unsigned char c = *szText;
+		if (c == '"' || c == '\\') { rsOut += '\\'; rsOut += c; }
+		else if (c < 0x20) { char szEsc[8]; sprintf(szEsc, "\\u%04x", c); rsOut += szEsc; }
+		else rsOut += c;
+	}
+	rsOut += '"';
+}
 
-	// add timestamp
+static bool LogLine(const char *szMessage, bool fConsole, const char *szSubsystem)
+{
+	// timestamp; formatted only once per second
+	static time_t LastTime = 0;
+	static char szTimestamp[11 + 1] = "";
 	time_t timenow; time(&timenow);
+	if (timenow != LastTime)
+	{
+		LastTime = timenow;
+		strftime(szTimestamp, 11 + 1, "[%H:%M:%S] ", localtime(&timenow));
+	}
+
 	StdStrBuf TimeMessage;
 	TimeMessage.SetLength(11 + SLen(szMessage) + 1);
-	strftime(TimeMessage.getMData(), 11 + 1, "[%H:%M:%S] ", localtime(&timenow));
+	memcpy(TimeMessage.getMData(), szTimestamp, 11);
+	std::string JSON;
 
 	// output until all data is written
 	const char *pSrc = szMessage;
@@ -146,13 +343,6 @@ bool LogSilent(const char *szMessage, bool fConsole)
 		}
 		*pDest++='\n'; *pDest = '\0';
 
-		// Save into log file
-		if (C4LogFile)
-		{
-			fputs(TimeMessage.getData(),C4LogFile);
-			fflush(C4LogFile);
-		}
-
 		// Save into record log file, if available
 		if(Control.GetRecord())
 		{
@@ -162,29 +352,67 @@ bool LogSilent(const char *szMessage, bool fConsole)
 			#endif
 		}
 
-
-		// Write to console
-		if (fConsole)
+		// Structured log line
+		if (C4LogJSONFile)
 		{
+			*--pDest = '\0';
+			char szTime[8 + 1];
+			SCopy(szTimestamp + 1, szTime, 8);
+			JSON.assign("{\"time\":");
+			AppendJSONString(JSON, szTime);
+			JSON.append(FormatString(",\"frame\":%d,\"subsystem\":", (int) Game.FrameCounter).getData());
+			AppendJSONString(JSON, szSubsystem);
+			JSON.append(",\"message\":");
+			AppendJSONString(JSON, TimeMessage.getData() + 11);
+			JSON.append("}\n");
+			*pDest = '\n';
+		}
+
 #if defined(_WIN32)
-			// debug: output to VC console
-			OutputDebugString(TimeMessage.GetWideChar());
+		// debug: output to VC console
+		if (fConsole) OutputDebugString(TimeMessage.GetWideChar());
 #endif
-#if !defined(_WIN32) || defined(USE_CONSOLE)
-			fputs(TimeMessage.getData(),stdout);
-			fflush(stdout);
+#if defined(_WIN32) && !defined(USE_CONSOLE)
+		fConsole = false;
 #endif
-		}
-
+		// Save into log file and write to console
+		LogWriter.Add(TimeMessage.getData(), C4LogJSONFile ? JSON.c_str() : NULL, fConsole);
 	}
 	while (*pSrc);
 
 	return true;
 }
 
+static bool LogSilent(const char *szMessage, bool fConsole, const char *szSubsystem)
+{
+	if (!Application.AssertMainThread()) return false;
+	// security
+	if (!szMessage) return false;
+
+	// rate limiting of repeated messages
+	if (Config.General.LogRepeatLimit > 0 && LastLogMessage == szMessage)
+	{
+		if (++iLastLogMessageRepeats > Config.General.LogRepeatLimit)
+		{
+			++iLastLogMessageSkipped;
+			return true;
+		}
+	}
+	else
+	{
+		LogSkippedRepeats();
+		LastLogMessage.Copy(szMessage);
+		iLastLogMessageRepeats = 0;
+		fLastLogMessageConsole = fConsole;
+		szLastLogMessageSubsystem = szSubsystem;
+	}
+
+	return LogLine(szMessage, fConsole, szSubsystem);
+}
+
 bool LogSilent(const char *szMessage)
 {
-	return LogSilent(szMessage, false);
+	return LogSilent(szMessage, false, "silent");
 }
 
 int iDisableLog = 0;
@@ -216,7 +444,7 @@ bool Log(const char *szMessage)
 	}
 
 	// log
-	LogSilent(szMessage, true);
+	LogSilent(szMessage, true, "log");
 
 	// Notify message board
 	if (fNotifyMsgBoard) ::GraphicsSystem.MessageBoard->LogNotify();
@@ -272,7 +500,7 @@ bool DebugLog(const char *strMessage)
 	if (Game.DebugMode)
 		return Log(strMessage);
 	else
-		return LogSilent(strMessage);
+		return LogSilent(strMessage, false, "debug");
 }
 
 bool DebugLogF(const char *strMessage ...)
@@ -285,6 +513,7 @@ bool DebugLogF(const char *strMessage ...)
 
 size_t GetLogPos()
 {
+	FlushLog();
 	// get current log position
 	return FileSize(sLogFileName.getData());
 }
@@ -0,0 +1,159 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Frame profiler with nested zones, exported as Chrome trace events */
+
+#include "C4Include.h"
+#include "C4Profiler.h"
+
+#include <algorithm>
+
+C4Profiler Profiler;
+bool C4Profiler::Enabled = false;
+
+C4Profiler::C4Profiler()
+{
+	StartTime = std::chrono::steady_clock::now();
+	for (int i = 0; i < C4Profiler_MaxFrames; ++i) Frames[i].Number = -1;
+	CurrentFrame = 0;
+	Depth = 0;
+	DroppedZones = 0;
+	pStream = NULL;
+	fStreamFirst = true;
+}
+
+void C4Profiler::Enable(bool fEnable)
+{
+	if (fEnable && !Enabled)
+	{
+		// frames of an earlier recording still belong into the stream
+		if (pStream) StreamFrames();
+		// start with an empty recording
+		DroppedZones = 0;
+		for (int i = 0; i < C4Profiler_MaxFrames; ++i)
+		{
+			Frames[i].Number = -1;
+			Frames[i].Zones.clear();
+		}
+	}
+	Enabled = fEnable;
+}
+
+void C4Profiler::NewFrame(int32_t iFrame)
+{
+	if (!Enabled) return;
+	CurrentFrame = (CurrentFrame + 1) % C4Profiler_MaxFrames;
+	// the oldest frame leaves the ring
+	if (pStream && Frames[CurrentFrame].Number >= 0) WriteFrame(pStream, Frames[CurrentFrame], fStreamFirst);
+	// keeps the capacity, so recording doesn't allocate once all frames were used
+	Frames[CurrentFrame].Zones.clear();
+	Frames[CurrentFrame].Number = iFrame;
+}
+
+void C4Profiler::WriteFrame(FILE *pFile, const Frame &rFrame, bool &rfFirst)
+{
+	for (std::vector<Zone>::const_iterator z = rFrame.Zones.begin(); z != rFrame.Zones.end(); ++z)
+	{
+		if (z->End < 0) continue; // still running
+		// complete events; times in microseconds
+		fprintf(pFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%d}}",
+		        rfFirst ? "" : ",\n", z->Name, z->Begin / 1000.0, (z->End - z->Begin) / 1000.0, (int) rFrame.Number);
+		rfFirst = false;
+	}
+}
+
+bool C4Profiler::SaveTrace(const char *szFilename) const
+{
+	FILE *pFile = fopen(szFilename, "wb");
+	if (!pFile) return false;
+	fputs("{\"traceEvents\":[\n", pFile);
+	bool fFirst = true;
+	// oldest frame first
+	for (int i = 1; i <= C4Profiler_MaxFrames; ++i)
+	{
+		const Frame &rFrame = Frames[(CurrentFrame + i) % C4Profiler_MaxFrames];
+		if (rFrame.Number >= 0) WriteFrame(pFile, rFrame, fFirst);
+	}
+	fputs("\n],\"displayTimeUnit\":\"ns\"}\n", pFile);
+	fclose(pFile);
+	if (DroppedZones) LogF("Profiler: %u zones were not recorded because their frame was full", (unsigned int) DroppedZones);
+	return true;
+}
+
+bool C4Profiler::StartStream(const char *szFilename)
+{
+	StopStream();
+	pStream = fopen(szFilename, "wb");
+	if (!pStream) return false;
+	fputs("{\"traceEvents\":[\n", pStream);
+	fStreamFirst = true;
+	return true;
+}
+
+void C4Profiler::StreamFrames()
+{
+	// oldest frame first
+	for (int i = 1; i <= C4Profiler_MaxFrames; ++i)
+	{
+		Frame &rFrame = Frames[(CurrentFrame + i) % C4Profiler_MaxFrames];
+		if (rFrame.Number >= 0) WriteFrame(pStream, rFrame, fStreamFirst);
+		rFrame.Number = -1;
+		rFrame.Zones.clear();
+	}
+}
+
+bool C4Profiler::StopStream()
+{
+	if (!pStream) return false;
+	StreamFrames();
+	fputs("\n],\"displayTimeUnit\":\"ns\"}\n", pStream);
+	fclose(pStream);
+	pStream = NULL;
+	if (DroppedZones) LogF("Profiler: %u zones were not recorded because their frame was full", (unsigned int) DroppedZones);
+	return true;
+}
+
+void C4Profiler::LogSlowestFrames(int32_t iCount) const
+{
+	// frame time is the time covered by its top level zones
+	std::vector<std::pair<int64_t, int32_t> > Times;
+	for (int i = 0; i < C4Profiler_MaxFrames; ++i)
+	{
+		if (Frames[i].Number < 0) continue;
+		int64_t iTime = 0;
+		for (std::vector<Zone>::const_iterator z = Frames[i].Zones.begin(); z != Frames[i].Zones.end(); ++z)
+			if (!z->Depth && z->End >= 0) iTime += z->End - z->Begin;
+		Times.push_back(std::make_pair(iTime, i));
+	}
+	std::sort(Times.rbegin(), Times.rend());
+	for (int32_t i = 0; i < iCount && i < int32_t(Times.size()); ++i)
+	{
+		const Frame &rFrame = Frames[Times[i].second];
+		LogF("Frame %d: %.3f ms", (int) rFrame.Number, Times[i].first / 1e6);
+		// most expensive zones of that frame, summed by name
+		std::vector<std::pair<int64_t, const char *> > Zones;
+		for (std::vector<Zone>::const_iterator z = rFrame.Zones.begin(); z != rFrame.Zones.end(); ++z)
+		{
+			if (z->End < 0) continue;
+			std::vector<std::pair<int64_t, const char *> >::iterator j;
+			for (j = Zones.begin(); j != Zones.end(); ++j)
+				if (j->second == z->Name) { j->first += z->End - z->Begin; break; }
+			if (j == Zones.end()) Zones.push_back(std::make_pair(z->End - z->Begin, z->Name));
+		}
+		std::sort(Zones.rbegin(), Zones.rend());
+		for (size_t j = 0; j < Zones.size() && j < 5; ++j)
+			LogF("  %s: %.3f ms", Zones[j].second, Zones[j].first / 1e6);
+	}
+}
@@ -0,0 +1,107 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Frame profiler with nested zones, exported as Chrome trace events */
+
+#ifndef INC_C4Profiler
+#define INC_C4Profiler
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Records begin and end of named zones for the last C4Profiler_MaxFrames
+// frames, at most C4Profiler_MaxZones per frame. Zones nest by scope. Only
+// the main thread records; the zone names must be static strings. When
+// disabled, a zone costs one branch. With a stream open, frames are written
+// out as they leave the ring, so the whole recording ends up in the file.
+class C4Profiler
+{
+public:
+	static const int C4Profiler_MaxFrames = 600;
+	static const int C4Profiler_MaxZones = 4096;
+
+	C4Profiler();
+
+	static bool Enabled; // tested inline by zones
+
+	void Enable(bool fEnable);
+	void NewFrame(int32_t iFrame); // called at the start of each game frame
+	bool SaveTrace(const char *szFilename) const; // write recorded frames as Chrome trace JSON (chrome://tracing)
+	bool StartStream(const char *szFilename); // write every frame that leaves the ring to this file
+	bool StopStream(); // write the remaining frames and close the stream
+	void LogSlowestFrames(int32_t iCount) const;
+
+	int32_t Begin(const char *szName, int32_t &riFrame)
+	{
+		std::vector<Zone> &Zones = Frames[CurrentFrame].Zones;
+		if (Zones.size() >= size_t(C4Profiler_MaxZones)) { ++DroppedZones; return -1; }
+		Zone z = { szName, Now(), -1, Depth++ };
+		riFrame = CurrentFrame;
+		Zones.push_back(z);
+		return Zones.size() - 1;
+	}
+	void End(int32_t iFrame, int32_t iZone)
+	{
+		--Depth;
+		// the zone may belong to an older frame; it is gone if its frame was reused
+		std::vector<Zone> &Zones = Frames[iFrame].Zones;
+		if (iZone < int32_t(Zones.size()) && Zones[iZone].End < 0) Zones[iZone].End = Now();
+	}
+
+private:
+	struct Zone
+	{
+		const char *Name;
+		int64_t Begin, End; // nanoseconds since profiler start
+		int32_t Depth;
+	};
+	struct Frame
+	{
+		int32_t Number; // game frame; -1 for unused
+		std::vector<Zone> Zones;
+	};
+
+	int64_t Now() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - StartTime).count(); }
+	static void WriteFrame(FILE *pFile, const Frame &rFrame, bool &rfFirst);
+	void StreamFrames(); // write all recorded frames to the stream and forget them
+
+	std::chrono::steady_clock::time_point StartTime;
+	Frame Frames[C4Profiler_MaxFrames];
+	int32_t CurrentFrame; // index into Frames
+	int32_t Depth;
+	uint32_t DroppedZones; // zones not recorded because their frame was full
+	FILE *pStream;
+	bool fStreamFirst; // no event written to the stream yet
+};
+
+extern C4Profiler Profiler;
+
+// Scoped zone
+class C4ProfilerZone
+{
+public:
+	C4ProfilerZone(const char *szName) : iZone(C4Profiler::Enabled ? Profiler.Begin(szName, iFrame) : -1) { }
+	~C4ProfilerZone() { if (iZone >= 0) Profiler.End(iFrame, iZone); }
+private:
+	int32_t iFrame, iZone;
+};
+
+#define C4PROFILE_CONCAT2(a, b) a##b
+#define C4PROFILE_CONCAT(a, b) C4PROFILE_CONCAT2(a, b)
+// profile the rest of the current scope
+#define C4PROFILE_ZONE(szName) C4ProfilerZone C4PROFILE_CONCAT(ProfilerZone, __LINE__)(szName)
+
+#endif // INC_C4Profiler
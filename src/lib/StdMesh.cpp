@@ -285,49 +285,83 @@ namespace
 	}
 }
 
-StdMeshTransformation StdMeshTrack::GetTransformAt(float time, float length) const
+StdMeshTransformation StdMeshTrack::GetTransformAt(float time, float length, unsigned int& cursor) const
 {
-	std::map<float, StdMeshKeyFrame>::const_iterator iter = Frames.lower_bound(time);
+	assert(!Frames.empty());
+	const unsigned int count = FrameTimes.size();
+
+	// Find the first keyframe at or after time, like lower_bound would. Try
+	// the one found last time and its successor before searching the track.
+	unsigned int iter = cursor;
+	if (iter > count || (iter < count && FrameTimes[iter] < time) || (iter > 0 && FrameTimes[iter - 1] >= time))
+	{
+		++iter;
+		if (iter > count || (iter < count && FrameTimes[iter] < time) || FrameTimes[iter - 1] >= time)
+			iter = std::lower_bound(FrameTimes.begin(), FrameTimes.end(), time) - FrameTimes.begin();
+	}
+	cursor = iter;
 
 	// We are at or before the first keyframe. This short typically not
 	// happen, since all animations have a keyframe 0. Simply return the
 	// first keyframe.
-	if (iter == Frames.begin())
-		return iter->second.Transformation;
+	if (iter == 0)
+		return Frames[0].Transformation;
 
-	std::map<float, StdMeshKeyFrame>::const_iterator prev_iter = iter;
-	--prev_iter;
+	const unsigned int prev_iter = iter - 1;
 
 	float iter_pos;
-	if (iter == Frames.end())
+	if (iter == count)
 	{
 		// We are beyond the last keyframe.
 		// Interpolate between the last and the first keyframe.
 		// See also bug #1406.
-		iter = Frames.begin();
+		iter = 0;
 		iter_pos = length;
 	}
 	else
 	{
-		iter_pos = iter->first;
+		iter_pos = FrameTimes[iter];
 	}
 
+	const float prev_pos = FrameTimes[prev_iter];
+
 	// No two keyframes with the same position:
-	assert(iter_pos > prev_iter->first);
+	assert(iter_pos > prev_pos);
 
 	// Requested position is between the two selected keyframes:
-	assert(time >= prev_iter->first);
+	assert(time >= prev_pos);
 	assert(iter_pos >= time);
 
-	float dt = iter_pos - prev_iter->first;
-	float weight1 = (time - prev_iter->first) / dt;
+	float dt = iter_pos - prev_pos;
+	float weight1 = (time - prev_pos) / dt;
 	float weight2 = (iter_pos - time) / dt;
 	(void)weight2; // used in assertion only
 
 	assert(weight1 >= 0 && weight2 >= 0 && weight1 <= 1 && weight2 <= 1);
 	assert(fabs(weight1 + weight2 - 1) < 1e-6);
 
-	return StdMeshTransformation::Nlerp(prev_iter->second.Transformation, iter->second.Transformation, weight1);
+	return StdMeshTransformation::Nlerp(Frames[prev_iter].Transformation, Frames[iter].Transformation, weight1);
+}
+
+StdMeshKeyFrame& StdMeshTrack::InsertFrame(float time)
+{
+	// Loaders usually add keyframes in order
+	if (FrameTimes.empty() || FrameTimes.back() < time)
+	{
+		FrameTimes.push_back(time);
+		Frames.push_back(StdMeshKeyFrame());
+		return Frames.back();
+	}
+
+	// Otherwise keep the arrays sorted, and return the existing keyframe for the same time
+	std::vector<float>::iterator iter = std::lower_bound(FrameTimes.begin(), FrameTimes.end(), time);
+	const unsigned int index = iter - FrameTimes.begin();
+	if (*iter != time)
+	{
+		FrameTimes.insert(iter, time);
+		Frames.insert(Frames.begin() + index, StdMeshKeyFrame());
+	}
+	return Frames[index];
 }
 
 StdMeshAnimation::StdMeshAnimation(const StdMeshAnimation& other):
@@ -368,6 +402,7 @@ StdMeshAnimation& StdMeshAnimation::operator=(const StdMeshAnimation& other)
 
 StdMeshSkeleton::StdMeshSkeleton()
 {
+	ClearPoseCache();
 }
 
 StdMeshSkeleton::~StdMeshSkeleton()
@@ -411,6 +446,31 @@ std::vector<const StdMeshAnimation*> StdMeshSkeleton::GetAnimations() const
 	return result;
 }
 
+const std::vector<StdMeshMatrix>* StdMeshSkeleton::GetCachedPose(const StdMeshAnimation* animation, float position) const
+{
+	for (unsigned int i = 0; i < PoseCacheSize; ++i)
+		if (PoseCache[i].Animation == animation && PoseCache[i].Position == position)
+			return &PoseCache[i].BoneTransforms;
+	return NULL;
+}
+
+void StdMeshSkeleton::CachePose(const StdMeshAnimation* animation, float position, const std::vector<StdMeshMatrix>& bone_transforms) const
+{
+	CachedPose& pose = PoseCache[PoseCacheNext];
+	PoseCacheNext = (PoseCacheNext + 1) % PoseCacheSize;
+	pose.Animation = animation;
+	pose.Position = position;
+	pose.BoneTransforms.assign(bone_transforms.begin(), bone_transforms.end());
+}
+
+void StdMeshSkeleton::ClearPoseCache()
+{
+	// Animations might get removed, and others allocated at the same address
+	for (unsigned int i = 0; i < PoseCacheSize; ++i)
+		PoseCache[i].Animation = NULL;
+	PoseCacheNext = 0;
+}
+
 void StdMeshSkeleton::MirrorAnimation(const StdMeshAnimation& animation)
 {
 	StdCopyStrBuf name(animation.Name);
@@ -447,12 +507,12 @@ void StdMeshSkeleton::MirrorAnimation(const StdMeshAnimation& animation)
 
 				// Mirror all the keyframes of both tracks
 				if (new_anim.Tracks[i] != NULL)
-					for (std::map<float, StdMeshKeyFrame>::iterator iter = new_anim.Tracks[i]->Frames.begin(); iter != new_anim.Tracks[i]->Frames.end(); ++iter)
-						MirrorKeyFrame(iter->second, own_trans, StdMeshTransformation::Inverse(other_own_trans));
+					for (std::vector<StdMeshKeyFrame>::iterator iter = new_anim.Tracks[i]->Frames.begin(); iter != new_anim.Tracks[i]->Frames.end(); ++iter)
+						MirrorKeyFrame(*iter, own_trans, StdMeshTransformation::Inverse(other_own_trans));
 
 				if (new_anim.Tracks[other_bone->Index] != NULL)
-					for (std::map<float, StdMeshKeyFrame>::iterator iter = new_anim.Tracks[other_bone->Index]->Frames.begin(); iter != new_anim.Tracks[other_bone->Index]->Frames.end(); ++iter)
-						MirrorKeyFrame(iter->second, other_own_trans, StdMeshTransformation::Inverse(own_trans));
+					for (std::vector<StdMeshKeyFrame>::iterator iter = new_anim.Tracks[other_bone->Index]->Frames.begin(); iter != new_anim.Tracks[other_bone->Index]->Frames.end(); ++iter)
+						MirrorKeyFrame(*iter, other_own_trans, StdMeshTransformation::Inverse(own_trans));
 			}
 		}
 		else if (bone.Name.Compare_(".N", bone.Name.getLength() - 2) != 0)
@@ -462,8 +522,8 @@ void StdMeshSkeleton::MirrorAnimation(const StdMeshAnimation& animation)
 				StdMeshTransformation own_trans = bone.Transformation;
 				if (bone.GetParent()) own_trans = bone.GetParent()->InverseTransformation * bone.Transformation;
 
-				for (std::map<float, StdMeshKeyFrame>::iterator iter = new_anim.Tracks[i]->Frames.begin(); iter != new_anim.Tracks[i]->Frames.end(); ++iter)
-					MirrorKeyFrame(iter->second, own_trans, StdMeshTransformation::Inverse(own_trans));
+				for (std::vector<StdMeshKeyFrame>::iterator iter = new_anim.Tracks[i]->Frames.begin(); iter != new_anim.Tracks[i]->Frames.end(); ++iter)
+					MirrorKeyFrame(*iter, own_trans, StdMeshTransformation::Inverse(own_trans));
 			}
 		}
 	}
@@ -850,7 +910,9 @@ bool StdMeshInstance::AnimationNode::GetBoneTransform(unsigned int bone, StdMesh
 	case LeafNode:
 		track = Leaf.Animation->Tracks[bone];
 		if (!track) return false;
-		transformation = track->GetTransformAt(fixtof(Leaf.Position->Value), Leaf.Animation->Length);
+		if (FrameCursors.size() != Leaf.Animation->Tracks.size())
+			FrameCursors.assign(Leaf.Animation->Tracks.size(), 0);
+		transformation = track->GetTransformAt(fixtof(Leaf.Position->Value), Leaf.Animation->Length, FrameCursors[bone]);
 		return true;
 	case CustomNode:
 		if(bone == Custom.BoneIndex)
@@ -1084,7 +1146,6 @@ void StdMeshInstance::AttachedMesh::MapBonesOfChildToParent(const StdMeshSkeleto
 
 StdMeshInstance::StdMeshInstance(const StdMesh& mesh, float completion):
 		Mesh(&mesh), Completion(completion),
-		BoneTransforms(Mesh->GetSkeleton().GetNumBones(), StdMeshMatrix::Identity()),
 		SubMeshInstances(Mesh->GetNumSubMeshes()), AttachParent(NULL),
 		BoneTransformsDirty(false)
 #ifndef USE_CONSOLE
@@ -1485,45 +1546,73 @@ bool StdMeshInstance::UpdateBoneTransforms()
 {
 	bool was_dirty = BoneTransformsDirty;
 
+	// Instances that are never drawn, such as all instances on a dedicated
+	// server, never need their bone matrices.
+	if (BoneTransforms.empty())
+		BoneTransforms.assign(Mesh->GetSkeleton().GetNumBones(), StdMeshMatrix::Identity());
+
 	// Nothing changed since last time
 	if (BoneTransformsDirty)
 	{
-		// Compute transformation matrix for each bone.
-		for (unsigned int i = 0; i < BoneTransforms.size(); ++i)
+		// Instances that play nothing but a single animation share their
+		// pose with other instances at the same animation position.
+		const StdMeshAnimation* animation = NULL;
+		float position = 0.0f;
+		const std::vector<StdMeshMatrix>* pose = NULL;
+		if (AnimationStack.size() == 1 && AnimationStack[0]->GetType() == AnimationNode::LeafNode)
 		{
-			StdMeshTransformation Transformation;
-
-			const StdMeshBone& bone = Mesh->GetSkeleton().GetBone(i);
-			const StdMeshBone* parent = bone.GetParent();
-			assert(!parent || parent->Index < i);
+			animation = AnimationStack[0]->GetAnimation();
+			position = fixtof(AnimationStack[0]->GetPosition());
+			pose = Mesh->GetSkeleton().GetCachedPose(animation, position);
+		}
 
-			bool have_transform = false;
-			for (unsigned int j = 0; j < AnimationStack.size(); ++j)
+		if (pose)
+		{
+			assert(pose->size() == BoneTransforms.size());
+			BoneTransforms = *pose;
+		}
+		else
+		{
+			// Compute transformation matrix for each bone.
+			for (unsigned int i = 0; i < BoneTransforms.size(); ++i)
 			{
-				if (have_transform)
+				StdMeshTransformation Transformation;
+
+				const StdMeshBone& bone = Mesh->GetSkeleton().GetBone(i);
+				const StdMeshBone* parent = bone.GetParent();
+				assert(!parent || parent->Index < i);
+
+				bool have_transform = false;
+				for (unsigned int j = 0; j < AnimationStack.size(); ++j)
 				{
-					StdMeshTransformation other;
-					if (AnimationStack[j]->GetBoneTransform(i, other))
-						Transformation = StdMeshTransformation::Nlerp(Transformation, other, 1.0f); // TODO: Allow custom weighing for slot combination
+					if (have_transform)
+					{
+						StdMeshTransformation other;
+						if (AnimationStack[j]->GetBoneTransform(i, other))
+							Transformation = StdMeshTransformation::Nlerp(Transformation, other, 1.0f); // TODO: Allow custom weighing for slot combination
+					}
+					else
+					{
+						have_transform = AnimationStack[j]->GetBoneTransform(i, Transformation);
+					}
+				}
+
+				if (!have_transform)
+				{
+					if (parent)
+						BoneTransforms[i] = BoneTransforms[parent->Index];
+					else
+						BoneTransforms[i] = StdMeshMatrix::Identity();
 				}
 				else
 				{
-					have_transform = AnimationStack[j]->GetBoneTransform(i, Transformation);
+					BoneTransforms[i] = StdMeshMatrix::Transform(bone.Transformation * Transformation * bone.InverseTransformation);
+					if (parent) BoneTransforms[i] = BoneTransforms[parent->Index] * BoneTransforms[i];
 				}
 			}
 
-			if (!have_transform)
-			{
-				if (parent)
-					BoneTransforms[i] = BoneTransforms[parent->Index];
-				else
-					BoneTransforms[i] = StdMeshMatrix::Identity();
-			}
-			else
-			{
-				BoneTransforms[i] = StdMeshMatrix::Transform(bone.Transformation * Transformation * bone.InverseTransformation);
-				if (parent) BoneTransforms[i] = BoneTransforms[parent->Index] * BoneTransforms[i];
-			}
+			if (animation)
+				Mesh->GetSkeleton().CachePose(animation, position, BoneTransforms);
 		}
 	}
 
@@ -75,10 +75,16 @@ class StdMeshTrack
 	friend class StdMeshSkeleton;
 	friend class StdMeshSkeletonLoader;
 public:
-	StdMeshTransformation GetTransformAt(float time, float length) const;
+	// cursor remembers the keyframe found by the previous call, so that an animation
+	// played forward does not need to search the track again. Any value is allowed.
+	StdMeshTransformation GetTransformAt(float time, float length, unsigned int& cursor) const;
 
 private:
-	std::map<float, StdMeshKeyFrame> Frames;
+	StdMeshKeyFrame& InsertFrame(float time);
+
+	// Keyframes in contiguous arrays, sorted by time
+	std::vector<float> FrameTimes;
+	std::vector<StdMeshKeyFrame> Frames;
 };
 
 // Animation, consists of one Track for each animated Bone
@@ -130,8 +136,14 @@ public:
 
 	std::vector<const StdMeshAnimation*> GetAnimations() const;
 
+	// Bone transformations of an instance that plays nothing but the given animation at the
+	// given position. These are shared between all instances of meshes with this skeleton.
+	const std::vector<StdMeshMatrix>* GetCachedPose(const StdMeshAnimation* animation, float position) const;
+	void CachePose(const StdMeshAnimation* animation, float position, const std::vector<StdMeshMatrix>& bone_transforms) const;
+
 private:
 	void AddMasterBone(StdMeshBone* bone);
+	void ClearPoseCache();
 
 	StdMeshSkeleton(const StdMeshSkeleton& other); // non-copyable
 	StdMeshSkeleton& operator=(const StdMeshSkeleton& other); // non-assignable
@@ -139,6 +151,18 @@ private:
 	std::vector<StdMeshBone*> Bones; // Master Bone Table
 
 	std::map<StdCopyStrBuf, StdMeshAnimation> Animations;
+
+	// Recently computed poses, replaced round-robin
+	struct CachedPose
+	{
+		const StdMeshAnimation* Animation;
+		float Position;
+		std::vector<StdMeshMatrix> BoneTransforms;
+	};
+
+	static const unsigned int PoseCacheSize = 8;
+	mutable CachedPose PoseCache[PoseCacheSize];
+	mutable unsigned int PoseCacheNext;
 };
 
 struct StdMeshBox
@@ -444,6 +468,7 @@ public:
 		unsigned int Number;
 		NodeType Type;
 		AnimationNode* Parent; // NoSave
+		std::vector<unsigned int> FrameCursors; // NoSave, keyframe cursor per track of leaf nodes
 
 		union
 		{
@@ -556,7 +581,9 @@ public:
 	void SetAnimationWeight(AnimationNode* node, ValueProvider* weight);
 
 	// Update animations; call once a frame
-	// dt is used for texture animation, skeleton animation is updated via value providers
+	// dt is used for texture animation, skeleton animation is updated via value providers.
+	// This only advances animation positions, bone transformations are computed on demand
+	// by UpdateBoneTransforms, so instances that are never drawn stay cheap.
 	void ExecuteAnimation(float dt);
 
 	// Create a new instance and attach it to this mesh. Takes ownership of denumerator
@@ -638,7 +665,7 @@ protected:
 
 	AnimationNodeList AnimationNodes; // for simple lookup of animation nodes by their unique number
 	AnimationNodeList AnimationStack; // contains top level nodes only, ordered by slot number
-	std::vector<StdMeshMatrix> BoneTransforms;
+	std::vector<StdMeshMatrix> BoneTransforms; // empty until UpdateBoneTransforms is called
 
 	std::vector<StdSubMeshInstance*> SubMeshInstances;
 	std::vector<StdSubMeshInstance*> SubMeshInstancesOrdered; // ordered by opacity, in case materials were changed
@@ -93,7 +93,7 @@ void StdMeshUpdate::Update(StdMeshInstance* instance, const StdMesh& new_mesh) c
 
 	// Update instance to represent new mesh
 	instance->Mesh = &new_mesh;
-	instance->BoneTransforms = std::vector<StdMeshMatrix>(new_mesh.GetSkeleton().GetNumBones(), StdMeshMatrix::Identity());
+	instance->BoneTransforms.clear();
 	instance->BoneTransformsDirty = true;
 
 	for (unsigned int i = 0; i < instance->SubMeshInstances.size(); ++i)
@@ -211,6 +211,7 @@ void C4Command::Default()
 	cObj=NULL;
 	Evaluated=false;
 	PathChecked=false;
+	PathRequest=0;
 	Finished=false;
 	Tx=C4VNull;
 	Ty=0;
@@ -281,6 +282,9 @@ void C4Command::MoveTo()
 					// Path not free: find path
 					if (!PathFree(cx,cy,Tx._getInt(),Ty))
 					{
+						// Wait for our turn
+						if (!Game.PathFinder.RequestGranted(this)) return;
+						Game.PathFinder.CompleteRequest(this);
 						Game.PathFinder.EnableTransferZones(!cObj->Def->NoTransferZones);
 						Game.PathFinder.SetLevel(cObj->Def->Pathfinder);
 						if (!Game.PathFinder.Find( cObj->GetX(),cObj->GetY(),
@@ -293,6 +297,8 @@ void C4Command::MoveTo()
 					else
 						PathChecked=true;
 				}
+	// No path search needed anymore
+	if (PathRequest) Game.PathFinder.CancelRequest(this);
 	// Path recheck
 	if (!::Game.iTick35) PathChecked=false;
 
@@ -1453,6 +1459,7 @@ void C4Command::Clear()
 	cObj=NULL;
 	Evaluated=false;
 	PathChecked=false;
+	if (PathRequest) Game.PathFinder.CancelRequest(this);
 	Tx=C4VNull;
 	Ty=0;
 	Target=Target2=NULL;
@@ -1848,7 +1855,7 @@ void C4Command::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	int32_t iVersion = 0;
 	if (pComp->Separator(StdCompiler::SEP_DOLLAR))
 	{
-		iVersion = 1;
+		iVersion = 2;
 		pComp->Value(mkIntPackAdapt(iVersion));
 		pComp->Separator(StdCompiler::SEP_SEP);
 	}
@@ -1880,6 +1887,11 @@ void C4Command::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	{
 		pComp->Value(mkIntPackAdapt(BaseMode)); pComp->Separator(StdCompiler::SEP_SEP);
 	}
+	// Pending path search
+	if (iVersion > 1)
+	{
+		pComp->Value(mkIntPackAdapt(PathRequest)); pComp->Separator(StdCompiler::SEP_SEP);
+	}
 	// Text
 	StdStrBuf TextBuf;
 	if (pComp->isDecompiler())
@@ -1906,6 +1918,7 @@ void C4Command::Denumerate(C4ValueNumbers * numbers)
 	Target.DenumeratePointers();
 	Target2.DenumeratePointers();
 	Tx.Denumerate(numbers);
+	if (PathRequest) Game.PathFinder.RestoreRequest(this);
 }
 
 int32_t C4Command::CallFailed()
@@ -85,6 +85,7 @@ public:
 	C4Value Data;
 	int32_t UpdateInterval;
 	int32_t Evaluated,PathChecked,Finished;
+	int32_t PathRequest; // pending deferred path search (see C4PathFinder::RequestGranted); 0 if none
 	int32_t Failures,Retries,Permit;
 	C4String *Text;
 	C4Command *Next;
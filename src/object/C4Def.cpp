@@ -301,6 +301,7 @@ void C4Def::Default()
 	Filename[0]=0;
 	Creation=0;
 	Count=0;
+	for (int32_t i=0; i<C4OC_Count; ++i) CPUCost[i]=0;
 	MainFace.Set(NULL,0,0,0,0);
 	Script.Clear();
 	StringTable.Clear();
@@ -23,6 +23,7 @@
 #include <C4Shape.h>
 #include <C4InfoCore.h>
 #include <C4IDList.h>
+#include <C4ObjectCost.h>
 #include <C4ValueMap.h>
 #include <C4Facet.h>
 #include <C4Surface.h>
@@ -180,6 +181,7 @@ public:
 	char Filename[_MAX_FNAME+1];
 	int32_t Creation;
 	int32_t Count; // number of instanciations
+	int64_t CPUCost[C4OC_Count]; // host time in ns, see C4ObjectCost
 
 	C4DefScriptHost Script;
 	C4LangStringTable StringTable;
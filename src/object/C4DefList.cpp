@@ -26,11 +26,14 @@
 #include <C4FileMonitor.h>
 #include <C4GameVersion.h>
 #include <C4Language.h>
+#include <C4MeshAnimation.h>
 
 #include <C4Record.h>
 
 #include <StdMeshLoader.h>
 
+#include <chrono>
+
 namespace
 {
 	class C4SkeletonManager : public StdMeshSkeletonLoader
@@ -467,3 +470,70 @@ StdMeshSkeletonLoader& C4DefList::GetSkeletonLoader()
 {
 	return *SkeletonLoader;
 }
+
+namespace
+{
+	// Steps through an animation and loops at its end
+	class C4BenchmarkValueProvider: public StdMeshInstance::ValueProvider
+	{
+	public:
+		C4BenchmarkValueProvider(C4Real pos, C4Real step, C4Real length): Step(step), Length(length) { Value = pos; }
+		virtual bool Execute()
+		{
+			Value += Step;
+			if (Value > Length) Value -= Length;
+			return true;
+		}
+	private:
+		C4Real Step;
+		C4Real Length;
+	};
+}
+
+void C4DefList::BenchmarkMeshAnimation(int32_t iInstances)
+{
+	// instances of all animated meshes, which are never drawn. In the first run every
+	// instance has its own animation position, in the second run all instances playing
+	// the same animation are in step and can share their poses. The third run only
+	// advances the animation positions, like the dedicated server does.
+	const int32_t iSteps = 100;
+	double rates[3];
+	int32_t iMeshes = 0;
+	for (int32_t run = 0; run < 3; ++run)
+	{
+		std::vector<StdMeshInstance*> instances;
+		for (C4Def *def = FirstDef; def; def = def->Next)
+		{
+			if (!def->Graphics.IsMesh()) continue;
+			const StdMesh &mesh = *def->Graphics.Mesh;
+			std::vector<const StdMeshAnimation*> animations = mesh.GetSkeleton().GetAnimations();
+			if (animations.empty()) continue;
+			for (int32_t i = 0; i < iInstances; ++i)
+			{
+				const StdMeshAnimation &animation = *animations[i % animations.size()];
+				StdMeshInstance *instance = new StdMeshInstance(mesh, 1.0f);
+				C4Real length = ftofix(animation.Length);
+				C4Real pos = run == 1 ? Fix0 : length * i / iInstances;
+				instance->PlayAnimation(animation, 0, NULL, new C4BenchmarkValueProvider(pos, length / 50, length), new C4ValueProviderConst(itofix(1)));
+				instances.push_back(instance);
+			}
+		}
+		iMeshes = instances.size() / std::max<int32_t>(iInstances, 1);
+
+		typedef std::chrono::steady_clock Clock;
+		Clock::time_point start = Clock::now();
+		for (int32_t step = 0; step < iSteps; ++step)
+			for (std::vector<StdMeshInstance*>::iterator it = instances.begin(); it != instances.end(); ++it)
+			{
+				(*it)->ExecuteAnimation(1.0f / 37.0f);
+				if (run < 2) (*it)->UpdateBoneTransforms();
+			}
+		double time = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		rates[run] = time > 0.0 ? double(instances.size()) * iSteps / time : 0.0;
+
+		for (std::vector<StdMeshInstance*>::iterator it = instances.begin(); it != instances.end(); ++it)
+			delete *it;
+	}
+	LogF("Mesh animation benchmark: %d animated meshes with %d instances each, %d steps: %.0f updates/ms at distinct positions, %.0f updates/ms in step, %.0f updates/ms without bone transformations",
+	     (int) iMeshes, (int) iInstances, (int) iSteps, rates[0], rates[1], rates[2]);
+}
@@ -67,6 +67,7 @@ public:
 	void Synchronize();
 	void AppendAndIncludeSkeletons();
 	StdMeshSkeletonLoader& GetSkeletonLoader();
+	void BenchmarkMeshAnimation(int32_t iInstances); // local only, does not affect the game
 
 	// callback from font renderer: get ID image
 	virtual bool DrawFontImage(const char* szImageTag, C4Facet& rTarget, C4DrawTransform* pTransform);
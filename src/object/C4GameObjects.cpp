@@ -29,6 +29,7 @@
 #include <C4Log.h>
 #include <C4PlayerList.h>
 #include <C4Record.h>
+#include <C4Draw.h>
 
 C4GameObjects::C4GameObjects()
 {
@@ -45,6 +46,8 @@ void C4GameObjects::Default()
 	Sectors.Clear();
 	LastUsedMarker = 0;
 	ForeObjects.Default();
+	UnsectoredObjects.Default();
+	AwakeCount = SleepingCount = 0;
 }
 
 void C4GameObjects::Init(int32_t iWidth, int32_t iHeight)
@@ -61,6 +64,8 @@ bool C4GameObjects::Add(C4Object *nObj)
 	// if this is a foreground object, add it to the list
 	if (nObj->Category & C4D_Foreground)
 		ForeObjects.Add(nObj, C4ObjectList::stMain);
+	// parallax objects and lines can be drawn far from their sectors
+	UpdateUnsectored(nObj);
 	// manipulate main list
 	if (!C4ObjectList::Add(nObj, C4ObjectList::stMain))
 		return false;
@@ -78,15 +83,94 @@ bool C4GameObjects::Remove(C4Object *pObj)
 	Sectors.Remove(pObj);
 	// remove from forelist
 	ForeObjects.Remove(pObj);
+	UnsectoredObjects.Remove(pObj);
 	// manipulate main list
 	return C4ObjectList::Remove(pObj);
 }
 
+void C4GameObjects::UpdateUnsectored(C4Object *pObj)
+{
+	bool fUnsectored = pObj->Status == C4OS_NORMAL && ((pObj->Category & C4D_Parallax) || pObj->Def->Line);
+	if (fUnsectored == UnsectoredObjects.IsContained(pObj)) return;
+	if (fUnsectored)
+		UnsectoredObjects.Add(pObj, C4ObjectList::stMain);
+	else
+		UnsectoredObjects.Remove(pObj);
+}
+
 C4ObjectList &C4GameObjects::ObjectsAt(int ix, int iy)
 {
 	return Sectors.SectorAt(ix, iy)->ObjectShapes;
 }
 
+void C4GameObjects::Draw(C4TargetFacet &cgo, int iPlayer, int MinPlane, int MaxPlane)
+{
+	// graphics may exceed the shape that sorts an object into its sectors
+	const int32_t DrawMargin = 200;
+	// drawing also sets the audibility of objects near the view
+	const int32_t AudibleRange = 700;
+	C4Rect rcDraw(int32_t(cgo.TargetX) - DrawMargin, int32_t(cgo.TargetY) - DrawMargin, int32_t(cgo.Wdt) + 2 * DrawMargin, int32_t(cgo.Hgt) + 2 * DrawMargin);
+	rcDraw.Add(C4Rect(int32_t(cgo.TargetX + cgo.Wdt / 2) - AudibleRange, int32_t(cgo.TargetY + cgo.Hgt / 2) - AudibleRange, 2 * AudibleRange, 2 * AudibleRange));
+	// collect the objects of all sectors in range
+	DrawObjects.clear();
+	auto AddObjects = [&](const C4ObjectList &List)
+	{
+		for (C4ObjectLink *pLnk = List.First; pLnk; pLnk = pLnk->Next)
+		{
+			C4Object *pObj = pLnk->Obj;
+			if (!pObj->Status || (pObj->Category & C4D_Foreground)) continue;
+			if (!Inside<int32_t>(pObj->GetPlane(), MinPlane, MaxPlane)) continue;
+			DrawObjects.push_back(pObj);
+		}
+	};
+	C4LArea Area(&Sectors, rcDraw);
+	for (C4LSector *pSct = Area.First(); pSct; pSct = Area.Next(pSct))
+	{
+		AddObjects(pSct->Objects);
+		AddObjects(pSct->ObjectShapes);
+	}
+	AddObjects(UnsectoredObjects);
+	// back to front; objects of the same definition next to each other so their blits can be batched
+	std::sort(DrawObjects.begin(), DrawObjects.end(), [](const C4Object *pObj1, const C4Object *pObj2)
+	{
+		if (pObj1->GetPlane() != pObj2->GetPlane()) return pObj1->GetPlane() < pObj2->GetPlane();
+		if (pObj1->id.GetHandle() != pObj2->id.GetHandle()) return pObj1->id.GetHandle() < pObj2->id.GetHandle();
+		return pObj1->Number < pObj2->Number;
+	});
+	DrawObjects.erase(std::unique(DrawObjects.begin(), DrawObjects.end()), DrawObjects.end());
+	// Draw objects (base)
+	pDraw->BeginBatch();
+	for (C4Object *pObj : DrawObjects)
+		pObj->Draw(cgo, iPlayer);
+	// Draw objects (top face)
+	for (C4Object *pObj : DrawObjects)
+		pObj->DrawTopFace(cgo, iPlayer);
+	pDraw->EndBatch();
+}
+
+namespace
+{
+	void PrepareSleepChecksPart(void *pData, int32_t iBegin, int32_t iEnd)
+	{
+		C4Object **ppObjects = static_cast<C4Object **>(pData);
+		for (int32_t i = iBegin; i < iEnd; ++i)
+			ppObjects[i]->PrepareSleepCheck();
+	}
+}
+
+void C4GameObjects::PrepareSleepChecks() // Every Tick1 by ExecObjects
+{
+	// Hashing the landscape around sleeping objects only reads, so it can be done
+	// for all of them at once. Execute uses the result unless the landscape around
+	// the object was drawn to in the meantime, so it doesn't depend on the threads.
+	SleepingObjects.clear();
+	for (C4Object *pObj : *this)
+		if (pObj->Status && pObj->IsAsleep())
+			SleepingObjects.push_back(pObj);
+	if (SleepingObjects.empty()) return;
+	Game.WorkerPool.Run(&PrepareSleepChecksPart, &SleepingObjects[0], SleepingObjects.size(), 16);
+}
+
 void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 {
 	DWORD focf,tocf;
@@ -206,6 +290,7 @@ void C4GameObjects::DeleteObjects(bool fDeleteInactive)
 	C4ObjectList::DeleteObjects();
 	Sectors.ClearObjects();
 	ForeObjects.Clear();
+	UnsectoredObjects.Clear();
 	if (fDeleteInactive) InactiveObjects.DeleteObjects();
 }
 
@@ -228,6 +313,9 @@ int C4GameObjects::PostLoad(bool fKeepInactive, C4ValueNumbers * numbers)
 		// add to list of foreobjects
 		if (pObj->Category & C4D_Foreground)
 			ForeObjects.Add(pObj, C4ObjectList::stMain, this);
+		// and of objects not drawn by sector
+		if ((pObj->Category & C4D_Parallax) || pObj->Def->Line)
+			UnsectoredObjects.Add(pObj, C4ObjectList::stMain, this);
 		// Unterminate end
 	}
 
@@ -37,18 +37,25 @@ public:
 
 private:
 	uint32_t LastUsedMarker; // last used value for C4Object::Marker
+	std::vector<C4Object *> SleepingObjects; // for PrepareSleepChecks
+	std::vector<C4Object *> DrawObjects; // for Draw
 
 public:
 	C4LSectors Sectors; // section object lists
 	C4ObjectList InactiveObjects; // inactive objects (Status=2)
 	C4ObjectList ForeObjects; // objects in foreground (C4D_Foreground)
+	C4ObjectList UnsectoredObjects; // objects not drawn at their sector position (C4D_Parallax, lines)
+	int32_t AwakeCount, SleepingCount; // objects executed awake and asleep in the last frame
 
 	using C4ObjectList::Add;
 	bool Add(C4Object *nObj); // add object
 	bool Remove(C4Object *pObj); // clear pointers to object
+	void UpdateUnsectored(C4Object *pObj); // after category or definition changes
 
 	C4ObjectList &ObjectsAt(int ix, int iy); // get object list for map pos
 
+	void PrepareSleepChecks(); // check the landscape around sleeping objects on the worker threads
+	void Draw(C4TargetFacet &cgo, int iPlayer, int MinPlane, int MaxPlane); // draw objects in and near the view
 	void CrossCheck(); // various collision-checks
 	C4Object *AtObject(int ctx, int cty, DWORD &ocf, C4Object *exclude=NULL); // find object at ctx/cty
 	void Synchronize(); // network synchronization
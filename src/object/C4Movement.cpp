@@ -245,6 +245,13 @@ void C4Object::DoMovement()
 		{
 			// Next step
 			int step = Sign(new_x - fix_x);
+			// Skip the steps that are sure to be free. The last one is always
+			// checked below, so the contact state is the same as when stepping.
+			for (int32_t iFree = Shape.GetFreeSteps(GetX(), GetY(), step, 0, Abs(fixtoi(new_x) - GetX()) - 1); iFree > 0; --iFree)
+			{
+				DoMotion(step, 0);
+				fMoved = true;
+			}
 			uint32_t border_hack_contacts = 0;
 			iContact=ContactCheck(GetX() + step, GetY(), &border_hack_contacts);
 			if (iContact || border_hack_contacts)
@@ -275,6 +282,11 @@ void C4Object::DoMovement()
 		{
 			// Next step
 			int step = Sign(new_y - fix_y);
+			for (int32_t iFree = Shape.GetFreeSteps(GetX(), GetY(), 0, step, Abs(fixtoi(new_y) - GetY()) - 1); iFree > 0; --iFree)
+			{
+				DoMotion(0, step);
+				fMoved = true;
+			}
 			if ((iContact=ContactCheck(GetX(), GetY() + step, nullptr, ydir > 0)))
 			{
 				fAnyContact=true; iContacts |= t_contact;
@@ -517,6 +529,7 @@ void C4Object::ForcePosition(C4Real tx, C4Real ty)
 	fix_x=tx; fix_y=ty;
 	UpdatePos();
 	UpdateSolidMask(false);
+	Wake();
 }
 
 void C4Object::MovePosition(int32_t dx, int32_t dy)
@@ -532,6 +545,7 @@ void C4Object::MovePosition(C4Real dx, C4Real dy)
 	fix_y+=dy;
 	UpdatePos();
 	UpdateSolidMask(true);
+	Wake();
 }
 
 
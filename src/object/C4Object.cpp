@@ -46,6 +46,7 @@
 #include <C4Record.h>
 #include <C4MeshAnimation.h>
 #include <C4FoW.h>
+#include <C4Profiler.h>
 
 namespace
 {
@@ -188,6 +189,10 @@ void C4Object::Default()
 	fix_x=fix_y=fix_r=0;
 	xdir=ydir=rdir=0;
 	Mobile=0;
+	RestFrames=0;
+	SleepHash=0;
+	SleepCheckArea.Default();
+	SleepCheckHash=SleepCheckVersion=0;
 	Unsorted=false;
 	Initializing=false;
 	OnFire=0;
@@ -221,6 +226,8 @@ void C4Object::Default()
 	pMeshInstance=NULL;
 	pDrawTransform=NULL;
 	pEffects=NULL;
+	EffectTimer=C4EffectTimer();
+	CPUCost=0;
 	pGfxOverlay=NULL;
 	iLastAttachMovementFrame=-1;
 
@@ -1030,6 +1037,8 @@ bool C4Object::ExecLife()
 
 void C4Object::Execute()
 {
+	C4PROFILE_ZONE("C4Object::Execute");
+	C4ObjectCostScope CostScope(Def, this, C4OC_Other);
 	if (Config.General.DebugRec)
 	{
 		// record debug
@@ -1040,25 +1049,61 @@ void C4Object::Execute()
 		rc.fr=fix_r;
 		AddDbgRec(RCT_ExecObj, &rc, sizeof(rc));
 	}
+	// Asleep? Then only time and animation go on
+	if (IsAsleep())
+	{
+		uint32_t iHash;
+		bool fStaysAsleep = CanSleep() && GetSleepHash(iHash) && iHash == SleepHash;
+		SleepCheckArea.Default();
+		if (fStaysAsleep)
+		{
+			++::Objects.SleepingCount;
+			// Same as the gravity remobilization in ExecMovement of an object at rest
+			if (!(Category & C4D_StaticBack)) Mobile = !::Game.iTick10;
+			EffectTimer.Skip();
+			if (pMeshInstance && !pMeshInstance->GetAttachParent())
+				pMeshInstance->ExecuteAnimation(1.0f/37.0f /* play smoothly at 37 FPS */);
+			return;
+		}
+		Wake();
+	}
+	++::Objects.AwakeCount;
+	C4Real old_x = fix_x, old_y = fix_y, old_r = fix_r;
 	// OCF
 	UpdateOCF();
 	// Command
-	ExecuteCommand();
+	{
+		C4PROFILE_ZONE("C4Object::ExecuteCommand");
+		C4ObjectCostScope CostScope(Def, this, C4OC_Command);
+		ExecuteCommand();
+	}
 	// Action
 	// need not check status, because dead objects have lost their action
-	ExecAction();
+	{
+		C4PROFILE_ZONE("C4Object::ExecAction");
+		C4ObjectCostScope CostScope(Def, this, C4OC_Action);
+		ExecAction();
+	}
 	// commands and actions are likely to have removed the object, and movement
 	// *must not* be executed for dead objects (SolidMask-errors)
 	if (!Status) return;
 	// Movement
-	ExecMovement();
+	{
+		C4PROFILE_ZONE("C4Object::ExecMovement");
+		C4ObjectCostScope CostScope(Def, this, C4OC_Movement);
+		ExecMovement();
+	}
 	if (!Status) return;
 	// effects
-	if (pEffects)
+	if (pEffects && EffectTimer.IsDue())
 	{
+		C4PROFILE_ZONE("C4Effect::Execute");
+		C4ObjectCostScope CostScope(Def, this, C4OC_Effects);
 		pEffects->Execute(this);
 		if (!Status) return;
 	}
+	else
+		EffectTimer.Skip();
 	// Life
 	ExecLife();
 	// Animation. If the mesh is attached, then don't execute animation here but let the parent object do it to make sure it is only executed once a frame.
@@ -1066,6 +1111,75 @@ void C4Object::Execute()
 		pMeshInstance->ExecuteAnimation(1.0f/37.0f /* play smoothly at 37 FPS */);
 	// Menu
 	if (Menu) Menu->Execute();
+	// Rest
+	UpdateRest(old_x, old_y, old_r);
+}
+
+bool C4Object::CanSleep() const
+{
+	// No action is checked when falling asleep: setting one wakes the object.
+	// Mobile is not checked either, as it is set every ten frames at rest.
+	return Status == C4OS_NORMAL && !Contained && !xdir && !ydir && !rdir
+	       && !Command && !pEffects && !Menu && !OnFire && !Alive && !Def->ContactFunctionCalls
+	       && (Shape.ContactDensity == C4M_Solid || Shape.ContactDensity == C4M_Liquid)
+	       && (InMat == MNone || !::MaterialMap.Map[InMat].Incindiary);
+}
+
+void C4Object::GetSleepArea(C4Rect &rArea) const
+{
+	// Everything movement and OCF look at: the vertices and their neighbours,
+	// the shape, the center and the pixels above it
+	int32_t x1 = std::min<int32_t>(Shape.GetX(), 0), y1 = std::min<int32_t>(Shape.GetY(), -8);
+	int32_t x2 = std::max<int32_t>(Shape.GetX() + Shape.Wdt, 0), y2 = std::max<int32_t>(Shape.GetY() + Shape.Hgt, 0);
+	for (int32_t i = 0; i < Shape.VtxNum; ++i)
+	{
+		x1 = std::min(x1, Shape.VtxX[i]); x2 = std::max(x2, Shape.VtxX[i]);
+		y1 = std::min(y1, Shape.VtxY[i]); y2 = std::max(y2, Shape.VtxY[i]);
+	}
+	rArea.Set(GetX() + x1 - 1, GetY() + y1 - 1, x2 - x1 + 3, y2 - y1 + 3);
+}
+
+bool C4Object::GetLandscapeSleepHash(const C4Rect &rArea, uint32_t &rHash) const
+{
+	if (!::Landscape.GetDensityHash(rArea.x, rArea.y, rArea.x + rArea.Wdt - 1, rArea.y + rArea.Hgt - 1, rHash))
+		return false;
+	// The material at the center matters, too
+	rHash = (rHash ^ uint32_t(GBackMat(GetX(), GetY()))) * 16777619u;
+	return true;
+}
+
+void C4Object::PrepareSleepCheck()
+{
+	// Only reads the object and the landscape
+	GetSleepArea(SleepCheckArea);
+	SleepCheckVersion = ::Landscape.GetDensityVersion(SleepCheckArea.x, SleepCheckArea.y, SleepCheckArea.x + SleepCheckArea.Wdt - 1, SleepCheckArea.y + SleepCheckArea.Hgt - 1);
+	if (!GetLandscapeSleepHash(SleepCheckArea, SleepCheckHash))
+		SleepCheckArea.Default();
+}
+
+bool C4Object::GetSleepHash(uint32_t &rHash) const
+{
+	C4Rect Area;
+	GetSleepArea(Area);
+	// Use the prepared hash unless anything in the area was drawn to since
+	if (Area == SleepCheckArea
+	    && ::Landscape.GetDensityVersion(Area.x, Area.y, Area.x + Area.Wdt - 1, Area.y + Area.Hgt - 1) == SleepCheckVersion)
+		rHash = SleepCheckHash;
+	else if (!GetLandscapeSleepHash(Area, rHash))
+		return false;
+	// Gravity can change at any time
+	rHash ^= uint32_t(fixtoi(::Landscape.Gravity, 10000));
+	return true;
+}
+
+void C4Object::UpdateRest(C4Real old_x, C4Real old_y, C4Real old_r)
+{
+	if (fix_x != old_x || fix_y != old_y || fix_r != old_r || !CanSleep() || GetAction())
+		{ RestFrames = 0; return; }
+	// Remember the surroundings to notice any change while asleep
+	if (++RestFrames == C4O_SleepDelay)
+		if (!GetSleepHash(SleepHash))
+			RestFrames = 0;
 }
 
 bool C4Object::At(int32_t ctx, int32_t cty) const
@@ -1180,6 +1294,8 @@ bool C4Object::ChangeDef(C4ID idNew)
 	Def->Count++;
 	// new def: Needs to be resorted
 	Unsorted=true;
+	// lines are not found by sector
+	::Objects.UpdateUnsectored(this);
 	// graphics change
 	pGraphics = &pDef->Graphics;
 	// blit mode adjustment
@@ -2313,6 +2429,8 @@ void C4Object::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	pComp->Value(mkNamingAdapt( SolidMask,                        "SolidMask",          Def->SolidMask    ));
 	pComp->Value(mkNamingAdapt( PictureRect,                      "Picture"                               ));
 	pComp->Value(mkNamingAdapt( Mobile,                           "Mobile",             false             ));
+	pComp->Value(mkNamingAdapt( RestFrames,                       "RestFrames",         0                 ));
+	pComp->Value(mkNamingAdapt( SleepHash,                        "SleepHash",          0u                ));
 	pComp->Value(mkNamingAdapt( OnFire,                           "OnFire",             false             ));
 	pComp->Value(mkNamingAdapt( InLiquid,                         "InLiquid",           false             ));
 	pComp->Value(mkNamingAdapt( EntranceStatus,                   "EntranceStatus",     false             ));
@@ -2824,6 +2942,15 @@ bool C4Object::ExecuteCommand()
 	return true;
 }
 
+void C4Object::SetCategory(int32_t Category)
+{
+	this->Category = Category;
+	Resort();
+	SetOCF();
+	// parallax objects are not found by sector
+	::Objects.UpdateUnsectored(this);
+}
+
 void C4Object::Resort()
 {
 	// Flag resort
@@ -5010,6 +5137,7 @@ bool C4Object::IsUserPlayerObject()
 
 void C4Object::SetPropertyByS(C4String * k, const C4Value & to)
 {
+	Wake();
 	if (k >= &Strings.P[0] && k < &Strings.P[P_LAST])
 	{
 		switch(k - &Strings.P[0])
@@ -5025,6 +5153,7 @@ void C4Object::SetPropertyByS(C4String * k, const C4Value & to)
 
 void C4Object::ResetProperty(C4String * k)
 {
+	Wake();
 	if (k >= &Strings.P[0] && k < &Strings.P[P_LAST])
 	{
 		switch(k - &Strings.P[0])
@@ -28,6 +28,7 @@
 #include "C4Particles.h"
 #include "C4PropList.h"
 #include "C4ObjectPtr.h"
+#include "C4Effect.h"
 #include "StdMesh.h"
 
 /* Object status */
@@ -36,6 +37,10 @@
 #define C4OS_NORMAL   1
 #define C4OS_INACTIVE 2
 
+/* Objects that stay at rest for this many frames fall asleep until disturbed */
+
+#define C4O_SleepDelay 37
+
 /* Action.Dir is the direction the object is actually facing. */
 
 #define DIR_None  0
@@ -120,6 +125,8 @@ class C4Object: public C4PropListNumbered
 private:
 	void UpdateInMat();
 	void Splash();
+	void GetSleepArea(C4Rect &rArea) const;
+	bool GetLandscapeSleepHash(const C4Rect &rArea, uint32_t &rHash) const;
 public:
 	C4Object();
 	~C4Object();
@@ -144,6 +151,9 @@ public:
 	C4Real xdir,ydir,rdir;
 	int32_t iLastAttachMovementFrame; // last frame in which Attach-movement by a SolidMask was done
 	bool Mobile;
+	int32_t RestFrames; // consecutive frames at rest, see IsAsleep
+	uint32_t SleepHash; // landscape around the object when it fell asleep
+	C4Rect SleepCheckArea; uint32_t SleepCheckHash; uint64_t SleepCheckVersion; // NoSave // see PrepareSleepCheck
 	bool Unsorted; // NoSave //
 	bool Initializing; // NoSave //
 	bool InLiquid;
@@ -173,6 +183,8 @@ public:
 	C4DefGraphics *pGraphics; // currently set object graphics
 	StdMeshInstance* pMeshInstance; // Instance for mesh-type objects
 	C4Effect *pEffects; // linked list of effects
+	C4EffectTimer EffectTimer; // execution state of pEffects
+	int64_t CPUCost; // host time in ns, see C4ObjectCost
 	// particle lists that are bound to this object (either in front of behind it)
 	C4ParticleList *FrontParticles, *BackParticles;
 	void ClearParticleLists();
@@ -279,7 +291,7 @@ public:
 	bool SetActionByName(C4String * ActName, C4Object *pTarget=NULL, C4Object *pTarget2=NULL, int32_t iCalls = SAC_StartCall | SAC_AbortCall, bool fForce = false);
 	bool SetActionByName(const char * szActName, C4Object *pTarget=NULL, C4Object *pTarget2=NULL, int32_t iCalls = SAC_StartCall | SAC_AbortCall, bool fForce = false);
 	void SetDir(int32_t tdir);
-	void SetCategory(int32_t Category) { this->Category = Category; Resort(); SetOCF(); }
+	void SetCategory(int32_t Category);
 	int32_t GetProcedure() const;
 	bool Enter(C4Object *pTarget, bool fCalls=true, bool fCopyMotion=true, bool *pfRejectCollect=NULL);
 	bool Exit(int32_t iX=0, int32_t iY=0, int32_t iR=0, C4Real iXDir=Fix0, C4Real iYDir=Fix0, C4Real iRDir=Fix0, bool fCalls=true);
@@ -384,6 +396,15 @@ public:
 
 	bool CanConcatPictureWith(C4Object *pOtherObject) const; // return whether this object should be grouped with the other in activation lists, contents list, etc.
 
+	// Sleeping objects skip everything but their animation in Execute until the
+	// landscape around them changes or anything else wakes them
+	bool IsAsleep() const { return RestFrames >= C4O_SleepDelay; }
+	void Wake() { RestFrames = 0; }
+	bool CanSleep() const; // nothing going on that needs the object executed
+	bool GetSleepHash(uint32_t &rHash) const;
+	void PrepareSleepCheck(); // landscape part of GetSleepHash; may run for several objects in parallel
+	void UpdateRest(C4Real old_x, C4Real old_y, C4Real old_r);
+
 	bool IsMoveableBySolidMask(int ComparisonPlane) const
 	{
 		return (Status == C4OS_NORMAL)
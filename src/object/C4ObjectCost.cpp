@@ -0,0 +1,130 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* CPU time accounting per object and per definition */
+
+#include <C4Include.h>
+#include <C4ObjectCost.h>
+
+#include <C4Def.h>
+#include <C4DefList.h>
+#include <C4Game.h>
+#include <C4GameObjects.h>
+#include <C4Object.h>
+
+#include <algorithm>
+
+C4ObjectCost ObjectCost;
+bool C4ObjectCost::Enabled = false;
+
+static const char *CostTypeNames[C4OC_Count] = { "cmd", "act", "mov", "fx", "scr", "oth" };
+
+C4ObjectCost::C4ObjectCost()
+{
+	DumpInterval = 0;
+	StartFrame = LastFrame = 0;
+}
+
+void C4ObjectCost::Enable(bool fEnable, int32_t iDumpInterval)
+{
+	if (fEnable && !Enabled) Reset();
+	Enabled = fEnable;
+	DumpInterval = fEnable ? std::max<int32_t>(iDumpInterval, 0) : 0;
+	if (!fEnable) Stack.clear();
+}
+
+void C4ObjectCost::Reset()
+{
+	C4Def *pDef;
+	for (int32_t i = 0; (pDef = ::Definitions.GetDef(i)); ++i)
+		for (int32_t j = 0; j < C4OC_Count; ++j) pDef->CPUCost[j] = 0;
+	for (C4Object *pObj : ::Objects) pObj->CPUCost = 0;
+	for (C4Object *pObj : ::Objects.InactiveObjects) pObj->CPUCost = 0;
+	StartFrame = LastFrame = ::Game.FrameCounter;
+	LastTime = std::chrono::steady_clock::now();
+}
+
+void C4ObjectCost::Push(C4Def *pDef, C4Object *pObj, int32_t iType)
+{
+	Book();
+	Scope s = { pDef, pObj ? pObj->Number : 0, iType };
+	Stack.push_back(s);
+}
+
+void C4ObjectCost::PushScript(C4PropList *pScript)
+{
+	Push(pScript->GetDef(), pScript->GetObject(), C4OC_Script);
+}
+
+void C4ObjectCost::Book()
+{
+	std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+	if (!Stack.empty())
+	{
+		int64_t iTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Now - LastTime).count();
+		const Scope &s = Stack.back();
+		if (s.pDef) s.pDef->CPUCost[s.iType] += iTime;
+		if (s.iObjNumber)
+			if (C4Object *pObj = ::Objects.ObjectPointer(s.iObjNumber))
+				pObj->CPUCost += iTime;
+	}
+	LastTime = Now;
+}
+
+void C4ObjectCost::Log(int32_t iCount)
+{
+	double dFrames = std::max<int32_t>(LastFrame - StartFrame, 1);
+	// definitions
+	std::vector<std::pair<int64_t, C4Def *> > Defs;
+	C4Def *pDef;
+	for (int32_t i = 0; (pDef = ::Definitions.GetDef(i)); ++i)
+	{
+		int64_t iTotal = 0;
+		for (int32_t j = 0; j < C4OC_Count; ++j) iTotal += pDef->CPUCost[j];
+		if (iTotal) Defs.push_back(std::make_pair(iTotal, pDef));
+	}
+	std::sort(Defs.rbegin(), Defs.rend());
+	LogF("CPU cost per frame over %d frames:", (int) dFrames);
+	for (int32_t i = 0; i < iCount && i < int32_t(Defs.size()); ++i)
+	{
+		pDef = Defs[i].second;
+		StdStrBuf sParts;
+		for (int32_t j = 0; j < C4OC_Count; ++j)
+			if (pDef->CPUCost[j])
+				sParts.AppendFormat(" %s %.3f", CostTypeNames[j], pDef->CPUCost[j] / dFrames / 1e6);
+		LogF("  %s: %.3f ms (%d objects;%s)", pDef->id.ToString(), Defs[i].first / dFrames / 1e6, (int) pDef->Count, sParts.getData());
+	}
+	// objects
+	std::vector<std::pair<int64_t, C4Object *> > Objs;
+	for (C4Object *pObj : ::Objects)
+		if (pObj->CPUCost) Objs.push_back(std::make_pair(pObj->CPUCost, pObj));
+	std::sort(Objs.rbegin(), Objs.rend());
+	for (int32_t i = 0; i < iCount && i < int32_t(Objs.size()); ++i)
+	{
+		C4Object *pObj = Objs[i].second;
+		LogF("  #%d %s (%s): %.3f ms", (int) pObj->Number, pObj->GetName(), pObj->Def->id.ToString(), Objs[i].first / dFrames / 1e6);
+	}
+}
+
+void C4ObjectCost::Execute(int32_t iFrame)
+{
+	if (!Enabled) return;
+	LastFrame = iFrame;
+	if (DumpInterval && iFrame - StartFrame >= DumpInterval)
+	{
+		Log(10);
+		Reset();
+	}
+}
@@ -0,0 +1,91 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* CPU time accounting per object and per definition */
+
+#ifndef INC_C4ObjectCost
+#define INC_C4ObjectCost
+
+#include <chrono>
+#include <vector>
+
+enum C4ObjectCostType
+{
+	C4OC_Command = 0,
+	C4OC_Action,
+	C4OC_Movement,
+	C4OC_Effects,
+	C4OC_Script,   // callbacks into object and definition scripts
+	C4OC_Other,    // rest of C4Object::Execute
+	C4OC_Count
+};
+
+// Times are exclusive: while a nested scope runs (e.g. a script callback
+// made from ExecAction, or a callback into another object), the time is
+// booked to the nested scope only. Costs are measured on the host and
+// must never influence the game, so they are not visible to scripts.
+class C4ObjectCost
+{
+public:
+	C4ObjectCost();
+
+	static bool Enabled; // tested inline by scopes
+
+	void Enable(bool fEnable, int32_t iDumpInterval = 0); // dump and reset every iDumpInterval frames; 0 for never
+	void Reset(); // clear all accumulated times
+	void Log(int32_t iCount); // log the iCount most expensive definitions and objects
+	void Execute(int32_t iFrame); // periodic dump
+
+	void Push(C4Def *pDef, C4Object *pObj, int32_t iType);
+	void PushScript(C4PropList *pScript); // callback into the script of an object or definition
+	void Pop()
+	{
+		if (Stack.empty()) return; // reset while running
+		Book();
+		Stack.pop_back();
+	}
+
+private:
+	struct Scope
+	{
+		C4Def *pDef;
+		int32_t iObjNumber; // not a pointer: the object may be deleted during its own scope
+		int32_t iType;
+	};
+
+	void Book(); // add time since the last change to the innermost scope
+
+	std::vector<Scope> Stack;
+	std::chrono::steady_clock::time_point LastTime;
+	int32_t DumpInterval;
+	int32_t StartFrame, LastFrame; // frames covered by the accumulated times
+};
+
+extern C4ObjectCost ObjectCost;
+
+// Book the rest of the current scope to an object or definition
+class C4ObjectCostScope
+{
+public:
+	C4ObjectCostScope(C4Def *pDef, C4Object *pObj, int32_t iType) : fActive(C4ObjectCost::Enabled)
+	{ if (fActive) ObjectCost.Push(pDef, pObj, iType); }
+	C4ObjectCostScope(C4PropList *pScript) : fActive(C4ObjectCost::Enabled)
+	{ if (fActive) ObjectCost.PushScript(pScript); }
+	~C4ObjectCostScope() { if (fActive) ObjectCost.Pop(); }
+private:
+	bool fActive;
+};
+
+#endif // INC_C4ObjectCost
@@ -396,6 +396,22 @@ bool C4Shape::ContactCheck(int32_t cx, int32_t cy, uint32_t *border_hack_contact
 	return !!ContactCount;
 }
 
+int32_t C4Shape::GetFreeSteps(int32_t cx, int32_t cy, int32_t dx, int32_t dy, int32_t iMax) const
+{
+	// Scan the density planes along the way of every vertex. Stay off the
+	// leftmost column, where ContactCheck also reports border contacts.
+	for (int32_t cvtx=0; cvtx<VtxNum && iMax>0; cvtx++)
+		if (!(VtxCNAT[cvtx] & CNAT_NoCollision))
+		{
+			int32_t x = cx+VtxX[cvtx]+dx;
+			int32_t y = cy+VtxY[cvtx]+dy;
+			if (x < 1) return 0;
+			if (dx < 0) iMax = std::min(iMax, x);
+			iMax = ::Landscape.GetDensityRun(x, y, dx, dy, iMax, ContactDensity);
+		}
+	return std::max<int32_t>(iMax, 0);
+}
+
 bool C4Shape::CheckScaleToWalk(int x, int y)
 {
 	for (int32_t i = 0; i < VtxNum; i++)
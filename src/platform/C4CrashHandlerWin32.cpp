@@ -434,7 +434,8 @@ LONG WINAPI GenerateDump(EXCEPTION_POINTERS* pExceptionPointers)
 			filename[0] = L'\0';
 	}
 
-	// Write dump (human readable format)
+	// Write pending log lines, then dump (human readable format)
+	FlushLogOnCrash();
 	if (GetLogFD() != -1)
 		SafeTextDump(pExceptionPointers, GetLogFD(), filename);
 
@@ -127,6 +127,10 @@ void C4MusicSystem::DeinitializeMOD()
 
 bool C4MusicSystem::Init(const char * PlayList)
 {
+#ifdef USE_HEADLESS
+	// a dedicated server plays no music: don't open a device or scan the music folders
+	return true;
+#endif
 	// init mod
 	if (!MODInitialized && !InitializeMOD()) return false;
 	// Might be reinitialisation
@@ -148,6 +152,9 @@ bool C4MusicSystem::Init(const char * PlayList)
 
 bool C4MusicSystem::InitForScenario(C4Group & hGroup)
 {
+#ifdef USE_HEADLESS
+	return false;
+#endif
 	// check if the scenario contains music
 	bool fLocalMusic = false;
 	StdStrBuf MusicDir;
@@ -345,6 +352,9 @@ void C4MusicSystem::ClearGame()
 
 void C4MusicSystem::Execute(bool force_song_execution)
 {
+#ifdef USE_HEADLESS
+	return;
+#endif
 	// Execute music fading
 	if (FadeMusicFile)
 	{
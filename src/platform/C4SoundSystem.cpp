@@ -42,6 +42,10 @@ C4SoundSystem::~C4SoundSystem()
 
 bool C4SoundSystem::Init()
 {
+#ifdef USE_HEADLESS
+	// a dedicated server plays no sound: no device, no Sound.ocg
+	return true;
+#else
 	if (!Application.MusicSystem.MODInitialized &&
 	    !Application.MusicSystem.InitializeMOD())
 		return false;
@@ -59,6 +63,7 @@ bool C4SoundSystem::Init()
 	Mix_AllocateChannels(C4MaxSoundInstances);
 #endif
 	return true;
+#endif
 }
 
 void C4SoundSystem::Clear()
@@ -83,6 +88,7 @@ void C4SoundSystem::ClearEffects()
 
 void C4SoundSystem::Execute()
 {
+#ifndef USE_HEADLESS
 #if AUDIO_TK == AUDIO_TK_OPENAL
 	Application.MusicSystem.SelectContext();
 #endif
@@ -92,6 +98,7 @@ void C4SoundSystem::Execute()
 		// Instance removal check
 		csfx->Execute();
 	}
+#endif
 }
 
 C4SoundEffect* C4SoundSystem::GetEffect(const char *szSndName)
@@ -129,6 +136,10 @@ C4SoundEffect* C4SoundSystem::GetEffect(const char *szSndName)
 
 C4SoundInstance *C4SoundSystem::NewEffect(const char *szSndName, bool fLoop, int32_t iVolume, C4Object *pObj, int32_t iCustomFalloffDistance, int32_t iPitch, C4SoundModifier *modifier)
 {
+#ifdef USE_HEADLESS
+	// nothing loaded, nobody listening
+	return NULL;
+#endif
 	// Sound not active
 	if (!Config.Sound.RXSound) return NULL;
 	// Get sound
@@ -163,6 +174,10 @@ C4SoundInstance *C4SoundSystem::FindInstance(const char *szSndName, C4Object *pO
 
 int32_t C4SoundSystem::LoadEffects(C4Group &hGroup, const char *namespace_prefix, bool group_is_root)
 {
+#ifdef USE_HEADLESS
+	// sounds are never played on a dedicated server; don't read or decode them
+	return 0;
+#endif
 	// Local definition sounds: If there is a Sound.ocg in the group, load the sound from there
 	if(group_is_root && hGroup.FindEntry(C4CFN_Sound))
 	{
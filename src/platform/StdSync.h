@@ -129,14 +129,21 @@ public:
 	}
 	bool WaitFor(unsigned int iMillis)
 	{
+		// pthread_cond_timedwait takes an absolute time
+		timespec ts = { 0, 0 };
+		if (iMillis != INFINITE)
+		{
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_sec += iMillis / 1000;
+			ts.tv_nsec += (iMillis % 1000) * 1000000;
+			if (ts.tv_nsec >= 1000000000) { ++ts.tv_sec; ts.tv_nsec -= 1000000000; }
+		}
 		pthread_mutex_lock(&mutex);
 		// Already set?
 		while (!fSet)
 		{
 			// Use pthread_cond_wait or pthread_cond_timedwait depending on wait length. Check return value.
 			// Note this will temporarily unlock the mutex, so no deadlock should occur.
-			timespec ts = { static_cast<time_t>(iMillis / 1000),
-				static_cast<long>((iMillis % 1000) * 1000000) };
 			if (0 != (iMillis != INFINITE ? pthread_cond_timedwait(&cond, &mutex, &ts) : pthread_cond_wait(&cond, &mutex)))
 			{
 				pthread_mutex_unlock(&mutex);
@@ -0,0 +1,104 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+/* Helper threads that split a job over a range of indices */
+
+#include "C4Include.h"
+#include "StdWorkerPool.h"
+
+#include <thread>
+
+StdWorkerPool::StdWorkerPool() : DoneEvent(false), pJob(NULL), pJobData(NULL), iJobCount(0), iPartSize(1), iNext(0), iDone(0)
+{
+}
+
+void StdWorkerPool::SetThreadCount(int32_t iCount)
+{
+	if (iCount < 0) iCount = std::max<int32_t>(std::thread::hardware_concurrency(), 1) - 1;
+	// stop surplus threads
+	while (int32_t(Workers.size()) > iCount)
+	{
+		Worker *pWorker = Workers.back();
+		Workers.pop_back();
+		pWorker->SignalStop();
+		pWorker->GetStartEvent()->Set();
+		pWorker->Stop(); // join before the event goes away
+		delete pWorker;
+	}
+	// start missing ones, as far as the platform can
+	while (int32_t(Workers.size()) < iCount)
+	{
+		Worker *pWorker = new Worker(this);
+		if (!pWorker->Start()) { delete pWorker; break; }
+		Workers.push_back(pWorker);
+	}
+}
+
+void StdWorkerPool::Run(JobFunc pJob, void *pData, int32_t iCount, int32_t iMinPart, ProgressFunc pProgress)
+{
+	if (iCount <= 0) return;
+	if (Workers.empty() || iCount <= iMinPart)
+	{
+		pJob(pData, 0, iCount);
+		if (pProgress) pProgress(pData);
+		return;
+	}
+	{
+		CStdLock Lock(&JobLock);
+		this->pJob = pJob; pJobData = pData;
+		iJobCount = iCount; iNext = iDone = 0;
+		// a few parts per thread balance uneven parts
+		int32_t iParts = (Workers.size() + 1) * 4;
+		iPartSize = std::max(iMinPart, (iCount + iParts - 1) / iParts);
+	}
+	for (Worker *pWorker : Workers)
+		pWorker->GetStartEvent()->Set();
+	while (RunPart())
+		if (pProgress) pProgress(pData);
+	// every finished part sets the event; it may still be set from an earlier run
+	for (;;)
+	{
+		DoneEvent.WaitFor(INFINITE);
+		if (pProgress) pProgress(pData);
+		CStdLock Lock(&JobLock);
+		if (iDone == iJobCount) break;
+	}
+}
+
+bool StdWorkerPool::RunPart()
+{
+	JobFunc pPartJob; void *pPartData;
+	int32_t iBegin, iEnd;
+	{
+		CStdLock Lock(&JobLock);
+		if (iNext >= iJobCount) return false;
+		pPartJob = pJob; pPartData = pJobData;
+		iBegin = iNext;
+		iEnd = iNext = std::min(iNext + iPartSize, iJobCount);
+	}
+	pPartJob(pPartData, iBegin, iEnd);
+	{
+		CStdLock Lock(&JobLock);
+		iDone += iEnd - iBegin;
+		DoneEvent.Set();
+	}
+	return true;
+}
+
+void StdWorkerPool::Worker::Execute()
+{
+	StartEvent.WaitFor(INFINITE);
+	if (IsStopSignaled()) return;
+	while (pPool->RunPart()) {}
+}
@@ -0,0 +1,69 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+/* Helper threads that split a job over a range of indices */
+
+#ifndef STDWORKERPOOL_H
+#define STDWORKERPOOL_H
+
+#include "StdScheduler.h"
+#include <vector>
+
+// Run calls the job for consecutive parts of the range on the worker threads
+// and on the calling thread, and returns when all parts are done. Parts are
+// claimed in any order, so jobs must not depend on each other's parts; writing
+// results per index keeps them independent of the number of threads.
+// Without threads, or for small ranges, the caller does all of the work.
+// The optional progress function is called on the calling thread whenever
+// parts have finished, before Run returns.
+class StdWorkerPool
+{
+public:
+	typedef void (*JobFunc)(void *pData, int32_t iBegin, int32_t iEnd);
+	typedef void (*ProgressFunc)(void *pData);
+
+	StdWorkerPool();
+	~StdWorkerPool() { SetThreadCount(0); }
+
+	void SetThreadCount(int32_t iCount); // threads besides the caller; negative for one per additional core
+	int32_t GetThreadCount() const { return Workers.size(); }
+
+	void Run(JobFunc pJob, void *pData, int32_t iCount, int32_t iMinPart = 1, ProgressFunc pProgress = NULL);
+
+private:
+	class Worker : public StdThread
+	{
+	public:
+		Worker(StdWorkerPool *pPool) : pPool(pPool), StartEvent(false) { }
+		CStdEvent *GetStartEvent() { return &StartEvent; }
+	protected:
+		virtual void Execute();
+	private:
+		StdWorkerPool *pPool;
+		CStdEvent StartEvent;
+	};
+	friend class Worker;
+
+	std::vector<Worker *> Workers;
+	CStdCSec JobLock;
+	CStdEvent DoneEvent;
+	// the current job, guarded by JobLock
+	JobFunc pJob;
+	void *pJobData;
+	int32_t iJobCount, iPartSize, iNext, iDone;
+
+	bool RunPart(); // claim and run the next part; false if none is left
+};
+
+#endif // STDWORKERPOOL_H
@@ -258,6 +258,7 @@ protected:
 #define PARS(N) Par##N##_t
 #define CONV_TYPE(N) C4ValueConv<Par##N##_t>::Type()
 #define CONV_FROM_C4V(N) C4ValueConv<Par##N##_t>::_FromC4V(pPars[N])
+#define CHECK_PAR(N) pPars[N].CheckParConversion(C4ValueConv<Par##N##_t>::Type())
 
 // N is the number of parameters pFunc needs. Templates can only have a fixed number of arguments,
 // so eleven templates are needed
@@ -273,10 +274,18 @@ public C4AulDefFuncHelper {                   \
     { return C4ValueConv<RType>::Type(); }    \
 /* Constructor, using the base class to create the ParType array */ \
     C4AulDefFunc##N(C4AulScript *pOwner, const char *pName, Func pFunc, bool Public): \
-      C4AulDefFuncHelper(pOwner, pName, Public LIST(N, CONV_TYPE)), pFunc(pFunc) { } \
+      C4AulDefFuncHelper(pOwner, pName, Public LIST(N, CONV_TYPE)), pFunc(pFunc) { FastExec = &ExecOnStack; } \
 /* Extracts the parameters from C4Values and wraps the return value in a C4Value */ \
     virtual C4Value Exec(C4PropList * _this, C4Value pPars[], bool fPassErrors) \
     { return C4ValueConv<RType>::ToC4V(pFunc(_this LIST(N, CONV_FROM_C4V))); } \
+/* The same with the type checks inlined, called by the script executor */ \
+    static bool ExecOnStack(C4AulFunc *pThis, C4PropList * _this, C4Value pPars[], C4Value *pResult) \
+    { \
+      const bool ParsOk[] = { true LIST(N, CHECK_PAR) }; \
+      for (bool Ok : ParsOk) if (!Ok) return false; \
+      *pResult = C4ValueConv<RType>::ToC4V(static_cast<C4AulDefFunc##N *>(pThis)->pFunc(_this LIST(N, CONV_FROM_C4V))); \
+      return true; \
+    } \
   protected:                                  \
     Func pFunc;                               \
   };                                          \
@@ -291,13 +300,22 @@ public C4AulDefFuncHelper {                   \
     { return C4ValueConv<RType>::Type(); }    \
 /* Constructor, using the base class to create the ParType array */ \
     C4AulDefObjectFunc##N(C4AulScript *pOwner, const char *pName, Func pFunc, bool Public): \
-      C4AulDefFuncHelper(pOwner, pName, Public LIST(N, CONV_TYPE)), pFunc(pFunc) { } \
+      C4AulDefFuncHelper(pOwner, pName, Public LIST(N, CONV_TYPE)), pFunc(pFunc) { FastExec = &ExecOnStack; } \
 /* Extracts the parameters from C4Values and wraps the return value in a C4Value */ \
     virtual C4Value Exec(C4PropList * _this, C4Value pPars[], bool fPassErrors) \
     { \
       C4Object * Obj; if (!_this || !(Obj = _this->GetObject())) throw NeedObjectContext(GetName()); \
       return C4ValueConv<RType>::ToC4V(pFunc(Obj LIST(N, CONV_FROM_C4V))); \
     } \
+/* The same with the type checks inlined, called by the script executor */ \
+    static bool ExecOnStack(C4AulFunc *pThis, C4PropList * _this, C4Value pPars[], C4Value *pResult) \
+    { \
+      const bool ParsOk[] = { true LIST(N, CHECK_PAR) }; \
+      for (bool Ok : ParsOk) if (!Ok) return false; \
+      C4Object * Obj; if (!_this || !(Obj = _this->GetObject())) throw NeedObjectContext(pThis->GetName()); \
+      *pResult = C4ValueConv<RType>::ToC4V(static_cast<C4AulDefObjectFunc##N *>(pThis)->pFunc(Obj LIST(N, CONV_FROM_C4V))); \
+      return true; \
+    } \
   protected:                                  \
     Func pFunc;                               \
   };                                          \
@@ -342,6 +360,7 @@ TEMPLATE(10)
 #undef PARS
 #undef CONV_TYPE
 #undef CONV_FROM_C4V
+#undef CHECK_PAR
 #undef TEMPLATE
 
 
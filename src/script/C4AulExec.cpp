@@ -145,6 +145,10 @@ void C4AulExec::ClearPointers(C4Object * obj)
 
 C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4PropList * p, C4Value *pnPars, bool fPassErrors)
 {
+	// Calls from the host only (e.g. drawing or GUI) must not change sleep state
+	if (p && fSyncExec)
+		if (C4Object *pObj = p->GetObject())
+			pObj->Wake();
 	// Push parameters
 	C4Value *pPars = pCurVal + 1;
 	if (pnPars)
@@ -824,6 +828,28 @@ C4AulBCC *C4AulExec::Call(C4AulFunc *pFunc, C4Value *pReturn, C4Value *pPars, C4
 		assert(pCurCtx >= Contexts);
 		pContext = pCurCtx->Obj;
 	}
+	// Anything but a query done to an object may disturb its rest
+	if (pContext && fSyncExec && (pFunc->SFunc() || !pFunc->ReadOnly))
+		if (C4Object *pObj = pContext->GetObject())
+			pObj->Wake();
+
+#ifndef DEBUGREC_SCRIPT
+	// Engine functions with parameter types known at compile time
+	// read them straight from the stack
+	if (pFunc->FastExec)
+	{
+		if (pContext && !pContext->Status)
+			throw C4AulExecError("using removed object");
+		if (pReturn > pCurVal)
+			PushNullVals(1);
+		if (pFunc->FastExec(pFunc, pContext, pPars, pReturn))
+		{
+			PopValuesUntil(pReturn);
+			return NULL;
+		}
+		// Otherwise, CheckParTypes reports the error
+	}
+#endif
 
 	pFunc->CheckParTypes(pPars, true);
 
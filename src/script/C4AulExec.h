@@ -41,7 +41,7 @@ class C4AulExec
 
 public:
 	C4AulExec()
-			: pCurCtx(Contexts - 1), pCurVal(Values - 1), iTraceStart(-1)
+			: pCurCtx(Contexts - 1), pCurVal(Values - 1), iTraceStart(-1), fSyncExec(false)
 	{ }
 
 private:
@@ -53,6 +53,7 @@ private:
 	C4TimeMilliseconds tDirectExecStart;
 	uint32_t tDirectExecTotal; // profiler time for DirectExec
 	C4AulScript *pProfiledScript;
+	bool fSyncExec; // only synchronized calls may wake sleeping objects
 
 	C4AulScriptContext Contexts[MAX_CONTEXT_STACK];
 	C4Value Values[MAX_VALUE_STACK];
@@ -68,6 +69,8 @@ public:
 	inline void StartDirectExec() { if (fProfiling) tDirectExecStart = C4TimeMilliseconds::Now(); }
 	inline void StopDirectExec() { if (fProfiling) tDirectExecTotal += C4TimeMilliseconds::Now() - tDirectExecStart; }
 
+	void SetSyncExec(bool fSync) { fSyncExec = fSync; }
+
 	int GetContextDepth() const { return pCurCtx - Contexts + 1; }
 	C4AulScriptContext *GetContext(int iLevel) { return iLevel >= 0 && iLevel < GetContextDepth() ? Contexts + iLevel : NULL; }
 	void LogCallStack();
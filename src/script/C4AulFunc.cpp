@@ -19,10 +19,22 @@
 #include <C4AulFunc.h>
 #include <C4Aul.h>
 
+static bool IsQueryName(const char *szName)
+{
+	static const char *szPrefixes[] = { "Get", "Is", "Has", "Find", "Object", "Contents", "Contained",
+	                                    "GBack", "Format", "Log", "Translate", "Random", NULL };
+	if (!szName) return false;
+	for (const char **pPrefix = szPrefixes; *pPrefix; ++pPrefix)
+		if (SEqual2(szName, *pPrefix)) return true;
+	return false;
+}
+
 C4AulFunc::C4AulFunc(C4AulScript *pOwner, const char *pName):
 		iRefCnt(0),
 		Name(pName ? Strings.RegString(pName) : 0),
-		MapNext(NULL)
+		MapNext(NULL),
+		FastExec(NULL),
+		ReadOnly(IsQueryName(pName))
 {
 	Owner = pOwner;
 	// add to global lookuptable with this name
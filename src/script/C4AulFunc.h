@@ -87,6 +87,17 @@ public:
 	}
 	virtual C4Value Exec(C4PropList * p, C4Value pPars[], bool fPassErrors=false) = 0;
 	bool CheckParTypes(const C4Value pPars[], bool fPassErrors) const;
+
+	// Set by engine functions whose parameter types are known at compile time.
+	// Checks and unboxes the parameters directly on the value stack and stores
+	// the result in *pResult. Returns false without calling the function if a
+	// parameter fails the type check, so that the caller can report the error.
+	typedef bool (*FastExecFunc)(C4AulFunc *pFunc, C4PropList *pContext, C4Value pPars[], C4Value *pResult);
+	FastExecFunc FastExec;
+
+	// Set for engine functions that only query, like Get* or Find*. Calling
+	// them does not wake a sleeping object.
+	bool ReadOnly;
 };
 
 #endif
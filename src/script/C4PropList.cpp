@@ -20,45 +20,43 @@
 #include <C4GameObjects.h>
 #include <C4Game.h>
 #include <C4Object.h>
+#include <C4ObjectCost.h>
 #include <C4Record.h>
 
-void C4PropList::AddRef(C4Value *pRef)
-{
-#ifdef _DEBUG
-	C4Value * pVal = FirstRef;
-	while (pVal)
-	{
-		assert(pVal != pRef);
-		pVal = pVal->NextRef;
-	}
-#endif
-	pRef->NextRef = FirstRef;
-	FirstRef = pRef;
-}
+// Handles are allocated in blocks and live until the process ends, because
+// C4Values in static storage may still look at them during static destruction.
+static C4PropListHandle *FirstFreePropListHandle = NULL;
+static const int C4PropListHandleBlock = 1024;
 
-void C4PropList::DelRef(const C4Value * pRef, C4Value * pNextRef)
+C4PropListHandle *C4PropListHandle::New(C4PropList *pPropList, bool fCounted)
 {
-	assert(FirstRef);
-	// References to objects never have HasBaseArray set
-	if (pRef == FirstRef)
+	if (!FirstFreePropListHandle)
 	{
-		FirstRef = pNextRef;
-		if (pNextRef) return;
-	}
-	else
-	{
-		C4Value *pPrev = FirstRef;
-		while (pPrev->NextRef != pRef)
+		C4PropListHandle *pBlock = new C4PropListHandle[C4PropListHandleBlock];
+		for (int i = 0; i < C4PropListHandleBlock; ++i)
 		{
-			pPrev = pPrev->NextRef;
-			assert(pPrev);
+			pBlock[i].NextFree = i + 1 < C4PropListHandleBlock ? &pBlock[i + 1] : NULL;
+			pBlock[i].Generation = 0;
+			pBlock[i].RefCount = 0;
 		}
-		pPrev->NextRef = pNextRef;
-		return;
+		FirstFreePropListHandle = pBlock;
 	}
-	// Only pure script proplists are garbage collected here, host proplists
+	C4PropListHandle *pHandle = FirstFreePropListHandle;
+	FirstFreePropListHandle = pHandle->NextFree;
+	pHandle->PropList = pPropList;
+	// Only pure script proplists are garbage collected, host proplists
 	// like definitions and effects have their own memory management.
-	if (Delete()) delete this;
+	pHandle->Generation = (pHandle->Generation & ~1u) | (fCounted ? 1u : 0u);
+	pHandle->RefCount = 0;
+	return pHandle;
+}
+
+void C4PropListHandle::Release()
+{
+	Generation += 2;
+	RefCount = 0;
+	NextFree = FirstFreePropListHandle;
+	FirstFreePropListHandle = this;
 }
 
 C4PropList * C4PropList::New(C4PropList * prototype)
@@ -265,7 +263,7 @@ StdStrBuf C4PropListStatic::GetDataString() const
 }
 
 C4PropList::C4PropList(C4PropList * prototype):
-		FirstRef(NULL), prototype(prototype),
+		Handle(NULL), prototype(prototype),
 		constant(false), Status(1)
 {
 #ifdef _DEBUG	
@@ -287,14 +285,8 @@ void C4PropList::Denumerate(C4ValueNumbers * numbers)
 
 C4PropList::~C4PropList()
 {
-	while (FirstRef)
-	{
-		// Manually kill references so DelRef doesn't destroy us again
-		FirstRef->Data = 0; FirstRef->Type = C4V_Nil;
-		C4Value *ref = FirstRef;
-		FirstRef = FirstRef->NextRef;
-		ref->NextRef = NULL;
-	}
+	// remaining references read as nil, and won't destroy us again
+	ClearRefs();
 #ifdef _DEBUG
 	assert(PropLists.Has(this));
 	PropLists.Remove(this);
@@ -521,36 +513,6 @@ C4Effect * C4PropList::GetEffect()
 }
 
 
-template<> template<>
-unsigned int C4Set<C4Property>::Hash<C4String *>(C4String * const & e)
-{
-	assert(e);
-	unsigned int hash = 4, tmp;
-	hash += ((uintptr_t)e) >> 16;
-	tmp   = ((((uintptr_t)e) & 0xffff) << 11) ^ hash;
-	hash  = (hash << 16) ^ tmp;
-	hash += hash >> 11;
-	hash ^= hash << 3;
-	hash += hash >> 5;
-	hash ^= hash << 4;
-	hash += hash >> 17;
-	hash ^= hash << 25;
-	hash += hash >> 6;
-	return hash;
-}
-
-template<> template<>
-bool C4Set<C4Property>::Equals<C4String *>(C4Property const & a, C4String * const & b)
-{
-	return a.Key == b;
-}
-
-template<> template<>
-unsigned int C4Set<C4Property>::Hash<C4Property>(C4Property const & p)
-{
-	return C4Set<C4Property>::Hash(p.Key);
-}
-
 bool C4PropList::GetPropertyByS(C4String * k, C4Value *pResult) const
 {
 	if (Properties.Has(k))
@@ -627,6 +589,7 @@ C4Value C4PropList::Call(C4String * k, C4AulParSet *Pars, bool fPassErrors)
 	if (!Status) return C4Value();
 	C4AulFunc *pFn = GetFunc(k);
 	if (!pFn) return C4Value();
+	C4ObjectCostScope CostScope(this);
 	return pFn->Exec(this, Pars, fPassErrors);
 }
 
@@ -636,6 +599,7 @@ C4Value C4PropList::Call(const char * s, C4AulParSet *Pars, bool fPassErrors)
 	assert(s && s[0]);
 	C4AulFunc *pFn = GetFunc(s);
 	if (!pFn) return C4Value();
+	C4ObjectCostScope CostScope(this);
 	return pFn->Exec(this, Pars, fPassErrors);
 }
 
@@ -32,12 +32,30 @@
 All PropLists can be destroyed while there are still C4Values referencing them, though
 Definitions do not get destroyed during the game. So always check for nullpointers.
 
-The linked list formed by C4PropList::FirstRef and C4Value::NextRef is used to
-change all C4Values referencing the destroyed Proplist to contain nil instead.
+C4Values refer to a proplist through its C4PropListHandle and the handle's generation.
+When the proplist is destroyed, the handle gets a new generation, so all C4Values
+referencing the destroyed Proplist read as nil without having to be visited.
 Objects are also cleaned up via various ClearPointer functions.
-The list is also used as a reference count to remove unused Proplists.
+The handle also holds a reference count to remove unused Proplists.
 The exception are C4PropListNumbered and C4Def, which have implicit references
-from C4GameObjects, C4Object and C4DefList. They have to be destroyed when loosing that reference.*/
+from C4GameObjects, C4Object and C4DefList. They have to be destroyed when loosing that reference.
+References to those are not counted, so copying them doesn't touch any memory but the C4Value.*/
+
+// Weak reference target of a proplist. Handles are never freed, only reused for
+// other proplists with a new generation, so C4Values can always look at them.
+struct C4PropListHandle
+{
+	union
+	{
+		C4PropList *PropList; // while used
+		C4PropListHandle *NextFree; // while unused
+	};
+	uint32_t Generation; // bit 0 set if references are counted
+	int32_t RefCount; // references held by C4Values if counted
+
+	static C4PropListHandle *New(C4PropList *pPropList, bool fCounted);
+	void Release(); // proplist is gone: all C4Values referring to it read as nil
+};
 
 class C4Property
 {
@@ -61,6 +79,38 @@ public:
 	bool operator < (const C4Property &cmp) const { return strcmp(GetSafeKey(), cmp.GetSafeKey())<0; }
 	const char *GetSafeKey() const { if (Key && Key->GetCStr()) return Key->GetCStr(); return ""; } // get key as C string; return "" if undefined. never return NULL
 };
+
+// Inline, because C4Set hashes the elements it passes while probing
+template<> template<>
+inline unsigned int C4Set<C4Property>::Hash<C4String *>(C4String * const & e)
+{
+	assert(e);
+	unsigned int hash = 4, tmp;
+	hash += ((uintptr_t)e) >> 16;
+	tmp   = ((((uintptr_t)e) & 0xffff) << 11) ^ hash;
+	hash  = (hash << 16) ^ tmp;
+	hash += hash >> 11;
+	hash ^= hash << 3;
+	hash += hash >> 5;
+	hash ^= hash << 4;
+	hash += hash >> 17;
+	hash ^= hash << 25;
+	hash += hash >> 6;
+	return hash;
+}
+
+template<> template<>
+inline bool C4Set<C4Property>::Equals<C4String *>(C4Property const & a, C4String * const & b)
+{
+	return a.Key == b;
+}
+
+template<> template<>
+inline unsigned int C4Set<C4Property>::Hash<C4Property>(C4Property const & p)
+{
+	return C4Set<C4Property>::Hash(p.Key);
+}
+
 class C4PropListNumbered;
 class C4PropList
 {
@@ -140,12 +190,11 @@ public:
 
 protected:
 	C4PropList(C4PropList * prototype = 0);
-	void ClearRefs() { while (FirstRef) FirstRef->Set0(); }
+	void ClearRefs() { if (Handle) { Handle->Release(); Handle = NULL; } }
 
 private:
-	void AddRef(C4Value *pRef);
-	void DelRef(const C4Value *pRef, C4Value * pNextRef);
-	C4Value *FirstRef; // No-Save
+	C4PropListHandle *GetHandle() { if (!Handle) Handle = C4PropListHandle::New(this, Delete()); return Handle; }
+	C4PropListHandle *Handle; // No-Save
 	C4Set<C4Property> Properties;
 	C4Value prototype;
 	bool constant; // if true, this proplist is not changeable
@@ -233,6 +282,7 @@ class C4PropListScript: public C4PropList
 public:
 	C4PropListScript(C4PropList * prototype = 0) : C4PropList(prototype) { PropLists.Add(this);  }
 	virtual ~C4PropListScript() { PropLists.Remove(this); }
+	C4SCRIPTPOOL_ALLOCATED
 	bool Delete() { return true; }
 
 	static void ClearScriptPropLists(); // empty all properties in script-created prop lists. Used on game clear to ensure prop lists with circular references get cleared.
@@ -0,0 +1,84 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Pooled memory for the small, short lived objects scripts create */
+
+#include "C4Include.h"
+#include "C4ScriptPool.h"
+
+// zero initialized before any constructor runs
+C4ScriptPool ScriptPool;
+
+void *C4ScriptPool::Alloc(size_t iSize)
+{
+	++Frame.Allocs;
+	Frame.Bytes += iSize;
+	if (!iSize || iSize > MaxSize)
+	{
+		++Frame.Misses;
+		return ::operator new(iSize);
+	}
+	size_t iClass = (iSize - 1) / Granularity;
+	if (!FreeLists[iClass]) AddChunk(iClass);
+	FreeItem *pItem = FreeLists[iClass];
+	FreeLists[iClass] = pItem->Next;
+	return pItem;
+}
+
+void C4ScriptPool::Free(void *p, size_t iSize)
+{
+	if (!p) return;
+	++Frame.Frees;
+	if (!iSize || iSize > MaxSize)
+	{
+		::operator delete(p);
+		return;
+	}
+	size_t iClass = (iSize - 1) / Granularity;
+	FreeItem *pItem = static_cast<FreeItem *>(p);
+	pItem->Next = FreeLists[iClass];
+	FreeLists[iClass] = pItem;
+}
+
+void C4ScriptPool::AddChunk(size_t iClass)
+{
+	++Frame.Misses;
+	++Chunks;
+	size_t iItemSize = (iClass + 1) * Granularity;
+	char *pChunk = static_cast<char *>(::operator new(ChunkSize));
+	// thread the items in address order
+	FreeItem *pNext = FreeLists[iClass];
+	for (size_t i = ChunkSize / iItemSize; i--; )
+	{
+		FreeItem *pItem = reinterpret_cast<FreeItem *>(pChunk + i * iItemSize);
+		pItem->Next = pNext;
+		pNext = pItem;
+	}
+	FreeLists[iClass] = pNext;
+}
+
+void C4ScriptPool::NewFrame()
+{
+	LastFrame = Frame;
+	Frame.Allocs = Frame.Frees = Frame.Misses = 0;
+	Frame.Bytes = 0;
+}
+
+void C4ScriptPool::Log() const
+{
+	LogF("Script allocations last frame: %d (%d KB), frees: %d, not from free lists: %d",
+	     (int) LastFrame.Allocs, (int) (LastFrame.Bytes / 1024), (int) LastFrame.Frees, (int) LastFrame.Misses);
+	LogF("Script pool: %d KB in %d chunks", (int) (size_t(Chunks) * ChunkSize / 1024), (int) Chunks);
+}
@@ -0,0 +1,68 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Pooled memory for the small, short lived objects scripts create */
+
+#ifndef INC_C4ScriptPool
+#define INC_C4ScriptPool
+
+// Free lists per size class, carved from chunks that are never returned to
+// the system. Arrays, proplists and strings created by scripts mostly die
+// within a few frames, so their memory is reused instead of going through
+// malloc every time. Larger requests fall through to operator new.
+// Like the string table, the pool may only be used from the main thread.
+// It has no constructor, so it is usable during static initialization.
+class C4ScriptPool
+{
+public:
+	static const size_t Granularity = 16, MaxSize = 256;
+	static const size_t ChunkSize = 16384;
+
+	struct Stats
+	{
+		int32_t Allocs, Frees; // including those too large for the pool
+		int32_t Misses; // allocations that needed a new chunk or operator new
+		int64_t Bytes; // allocated bytes
+	};
+	Stats Frame, LastFrame; // counted since the last NewFrame and in the frame before that
+	int32_t Chunks; // total number of chunks
+
+	void *Alloc(size_t iSize);
+	void Free(void *p, size_t iSize);
+
+	void NewFrame(); // called at the start of each game frame
+	void Log() const;
+
+private:
+	struct FreeItem { FreeItem *Next; };
+	FreeItem *FreeLists[MaxSize / Granularity];
+
+	void AddChunk(size_t iClass);
+};
+
+extern C4ScriptPool ScriptPool;
+
+// Class specific allocation functions using the pool. The class must have a
+// virtual destructor if it has derived classes, so that the size is right.
+// Debug builds that track allocations by file and line leave them alone.
+#ifdef new_orig
+#define C4SCRIPTPOOL_ALLOCATED
+#else
+#define C4SCRIPTPOOL_ALLOCATED \
+	static void *operator new(size_t iSize) { return ScriptPool.Alloc(iSize); } \
+	static void operator delete(void *p, size_t iSize) { ScriptPool.Free(p, iSize); }
+#endif
+
+#endif // INC_C4ScriptPool
@@ -19,6 +19,7 @@
 #include <C4AulDebug.h>
 #include <C4Config.h>
 #include <C4Def.h>
+#include <C4ObjectCost.h>
 #include <C4PropList.h>
 #include <C4Record.h>
 #include <C4Reloc.h>
@@ -47,5 +48,11 @@ C4Reloc Reloc;
 bool C4Reloc::Open(C4Group&, char const*) const { return false; }
 
 void C4Def::IncludeDefinition(C4Def*) {}
+C4ObjectCost ObjectCost;
+bool C4ObjectCost::Enabled = false;
+C4ObjectCost::C4ObjectCost() {}
+void C4ObjectCost::Push(C4Def*, C4Object*, int32_t) {}
+void C4ObjectCost::PushScript(C4PropList*) {}
+void C4ObjectCost::Book() {}
 bool EraseItemSafe(const char *szFilename) {return false;}
 void AddDbgRec(C4RecordChunkType, const void *, int) {}
@@ -19,22 +19,59 @@
 #include <C4StringTable.h>
 
 
+// Multiplicative hash over eight bytes at a time. The values only need to
+// be stable within one process, so the words are read in host byte order.
+static unsigned int C4StringHash(const char *s, size_t iLen)
+{
+	const uint64_t Mul = 0x9fb21c651e98df25ull;
+	uint64_t h = 0x9e3779b97f4a7c15ull ^ iLen, w;
+	for (; iLen >= 8; s += 8, iLen -= 8)
+	{
+		memcpy(&w, s, 8);
+		h = (h ^ w) * Mul;
+		h ^= h >> 29;
+	}
+	w = 0;
+	memcpy(&w, s, iLen);
+	h = (h ^ w) * Mul;
+	h ^= h >> 32;
+	h *= Mul;
+	h ^= h >> 29;
+	return (unsigned int) h;
+}
+
+// Lookup key with the length and hash computed once
+struct C4StringKey
+{
+	const char *Data;
+	size_t Len;
+	unsigned int Hash;
+	C4StringKey(const char *s, size_t iLen): Data(s), Len(iLen), Hash(C4StringHash(s, iLen)) { }
+};
+
 // *** C4Set
 template<> template<>
 unsigned int C4Set<C4String *>::Hash<const char *>(const char * const & s)
 {
-	// Fowler/Noll/Vo hash
-	unsigned int h = 2166136261u;
-	const char * p = s;
-	while (*p)
-		h = (h ^ *(p++)) * 16777619;
-	return h;
+	return C4StringHash(s, strlen(s));
 }
 
 template<> template<>
 bool C4Set<C4String *>::Equals<const char *>(C4String * const & a, const char * const & b)
 {
-	return a->GetData() == b;
+	return !strcmp(a->GetCStr(), b);
+}
+
+template<> template<>
+unsigned int C4Set<C4String *>::Hash<C4StringKey>(C4StringKey const & k)
+{
+	return k.Hash;
+}
+
+template<> template<>
+bool C4Set<C4String *>::Equals<C4StringKey>(C4String * const & a, C4StringKey const & b)
+{
+	return a->Hash == b.Hash && a->GetLength() == b.Len && !memcmp(a->GetCStr(), b.Data, b.Len);
 }
 
 // *** C4String
@@ -44,7 +81,7 @@ C4String::C4String(StdStrBuf strString)
 {
 	// take string
 	Data.Take(std::move(strString));
-	Hash = Strings.Set.Hash(Data.getData());
+	Hash = C4StringHash(Data.getData(), Data.getLength());
 	// reg
 	Strings.Set.Add(this);
 }
@@ -74,7 +111,7 @@ void C4String::operator=(const char * s)
 	assert(!Data);
 	// ref string
 	Data.Ref(s);
-	Hash = Strings.Set.Hash(Data.getData());
+	Hash = C4StringHash(Data.getData(), Data.getLength());
 	// reg
 	Strings.Set.Add(this);
 }
@@ -297,7 +334,7 @@ C4StringTable::~C4StringTable()
 
 C4String *C4StringTable::RegString(StdStrBuf String)
 {
-	C4String * s = FindString(String.getData());
+	C4String * s = Set.Get(C4StringKey(String.getData(), String.getLength()));
 	if (s)
 		return s;
 	else
@@ -306,5 +343,5 @@ C4String *C4StringTable::RegString(StdStrBuf String)
 
 C4String *C4StringTable::FindString(const char *strString)
 {
-	return Set.Get(strString);
+	return Set.Get(C4StringKey(strString, strlen(strString)));
 }
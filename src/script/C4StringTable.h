@@ -18,6 +18,8 @@
 #ifndef C4STRINGTABLE_H
 #define C4STRINGTABLE_H
 
+#include "C4ScriptPool.h"
+
 class C4String
 {
 	int RefCnt;
@@ -34,11 +36,14 @@ private:
 public:
 	~C4String();
 
+	C4SCRIPTPOOL_ALLOCATED
+
 	// Add/Remove Reference
 	void IncRef() { ++RefCnt; }
 	void DecRef() { if (!--RefCnt) delete this; }
 
 	const char * GetCStr() const { return Data.getData(); }
+	size_t GetLength() const { return Data.getLength(); }
 	StdStrBuf GetData() const { return Data.getRef(); }
 
 };
@@ -90,42 +95,122 @@ private:
 	T * p;
 };
 
+// Open addressing hash set with Robin Hood linear probing and backward
+// shift deletion. Empty slots hold a value that converts to false. The
+// capacity is always a power of two. The order of iteration depends only
+// on the sequence of operations and the hashes.
+// Large tables grow incrementally: the old table is kept next to the new
+// one and moved over a few slots per Add, so that adding never has to
+// move everything at once. Lookups check both tables while growing.
 template<typename T> class C4Set
 {
+	enum { IncrementalRehashCapacity = 4096, RehashStep = 8 };
+
 	unsigned int Capacity;
-	unsigned int Size;
+	unsigned int Size; // in both tables
 	T * Table;
-	T * GetPlaceFor(T const & e)
+	// while growing incrementally
+	unsigned int OldCapacity;
+	T * OldTable; // NULL unless growing
+	unsigned int MigratePos; // last old slot that was moved over; always followed by an empty slot or done
+	unsigned int MigrateLeft; // old slots still to look at
+
+	// Slots away from its home slot
+	static unsigned int Distance(T const * pTable, unsigned int iMask, unsigned int i)
 	{
-		unsigned int h = Hash(e);
-		T * p = &Table[h % Capacity];
-		while (*p && !Equals(*p, e))
-		{
-			p = &Table[++h % Capacity];
-		}
-		return p;
+		return (i - Hash(pTable[i])) & iMask;
 	}
 	T * AddInternal(T const & e)
 	{
-		T * p = GetPlaceFor(e);
-		*p = e;
-		return p;
+		return AddInternal(T(e));
 	}
+	// Robin Hood insertion: an element takes the slot of the first element
+	// that is closer to its home, which then moves on in the same way.
 	T * AddInternal(T && e)
 	{
-		T * p = GetPlaceFor(e);
-		*p = std::move(e);
-		return p;
+		unsigned int iMask = Capacity - 1, i = Hash(e) & iMask, d = 0;
+		while (Table[i] && !Equals(Table[i], e) && Distance(Table, iMask, i) >= d)
+		{
+			i = (i + 1) & iMask;
+			++d;
+		}
+		T * r = &Table[i];
+		if (!*r || Equals(*r, e))
+		{
+			*r = std::move(e);
+			return r;
+		}
+		T Carry = std::move(*r);
+		*r = std::move(e);
+		d = (i - Hash(Carry)) & iMask;
+		for (;;)
+		{
+			i = (i + 1) & iMask;
+			++d;
+			if (!Table[i])
+			{
+				Table[i] = std::move(Carry);
+				return r;
+			}
+			unsigned int dHere = Distance(Table, iMask, i);
+			if (dHere < d)
+			{
+				std::swap(Table[i], Carry);
+				d = dHere;
+			}
+		}
+	}
+	// Elements are ordered by distance from their home slot, so a search
+	// can stop at the first element that is closer to its home than e would be.
+	template<typename H> static T * FindIn(T * pTable, unsigned int iMask, unsigned int h, H const & e)
+	{
+		for (unsigned int i = h & iMask, d = 0; pTable[i]; i = (i + 1) & iMask, ++d)
+		{
+			if (Equals(pTable[i], e)) return &pTable[i];
+			if (Distance(pTable, iMask, i) < d) break;
+		}
+		return 0;
+	}
+	// Returns the element, or NULL if there is none
+	template<typename H> T * Find(H const & e) const
+	{
+		unsigned int h = Hash(e);
+		T * r = FindIn(Table, Capacity - 1, h, e);
+		if (!r && OldTable)
+			r = FindIn(OldTable, OldCapacity - 1, h, e);
+		return r;
+	}
+	static T & EmptyElement()
+	{
+		static T Empty = T();
+		return Empty;
+	}
+	void ClearTable()
+	{
+		for (unsigned int i = 0; i < Capacity; ++i)
+			Table[i] = 0;
 	}
 	void MaintainCapacity()
 	{
+		if (OldTable) Migrate(RehashStep);
 		if (Capacity - Size < std::max(2u, Capacity / 4))
 		{
+			if (OldTable) Migrate(OldCapacity);
 			unsigned int OCapacity = Capacity;
 			Capacity *= 2;
 			T * OTable = Table;
 			Table = new T[Capacity];
-			Clear();
+			ClearTable();
+			if (OCapacity >= IncrementalRehashCapacity)
+			{
+				OldTable = OTable;
+				OldCapacity = OCapacity;
+				// start behind an empty slot, so that whole collision chains move together
+				MigratePos = 0;
+				while (OldTable[MigratePos]) ++MigratePos;
+				MigrateLeft = OldCapacity;
+				return;
+			}
 			for (unsigned int i = 0; i < OCapacity; ++i)
 			{
 				if (OTable[i])
@@ -134,19 +219,51 @@ template<typename T> class C4Set
 			delete [] OTable;
 		}
 	}
+	// Move at least iSlots slots of the old table over. Stops only after
+	// a complete chain, so the chains left in the old table stay intact.
+	void Migrate(unsigned int iSlots)
+	{
+		while (MigrateLeft)
+		{
+			unsigned int i = (MigratePos + 1) & (OldCapacity - 1);
+			if (!iSlots && !OldTable[i]) break;
+			MigratePos = i;
+			--MigrateLeft;
+			if (iSlots) --iSlots;
+			if (OldTable[i])
+			{
+				AddInternal(std::move(OldTable[i]));
+				OldTable[i] = 0;
+			}
+		}
+		if (!MigrateLeft)
+		{
+			delete [] OldTable;
+			OldTable = 0;
+		}
+	}
+	static T const * NextIn(T const * pTable, unsigned int iCapacity, T const * p)
+	{
+		while (++p != &pTable[iCapacity])
+		{
+			if (*p) return p;
+		}
+		return 0;
+	}
 public:
 	template<typename H> static unsigned int Hash(const H &);
 	template<typename H> static bool Equals(const T &, const H &);
 	static bool Equals(const T & a, const T & b) { return a == b; }
-	C4Set(): Capacity(2), Size(0), Table(new T[Capacity])
+	C4Set(): Capacity(2), Size(0), Table(new T[Capacity]), OldCapacity(0), OldTable(0)
 	{
-		Clear();
+		ClearTable();
 	}
 	~C4Set()
 	{
 		delete[] Table;
+		delete[] OldTable;
 	}
-	C4Set(const C4Set & b): Capacity(0), Size(0), Table(0)
+	C4Set(const C4Set & b): Capacity(0), Size(0), Table(0), OldCapacity(0), OldTable(0)
 	{
 		*this = b;
 	}
@@ -155,36 +272,38 @@ public:
 		Capacity = b.Capacity;
 		Size = b.Size;
 		delete[] Table;
+		delete[] OldTable;
+		OldTable = 0;
 		Table = new T[Capacity];
-		for (unsigned int i = 0; i < Capacity; ++i)
-			Table[i] = b.Table[i];
+		if (b.OldTable)
+		{
+			ClearTable();
+			for (T const * p = b.First(); p; p = b.Next(p))
+				AddInternal(*p);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < Capacity; ++i)
+				Table[i] = b.Table[i];
+		}
 		return *this;
 	}
 	void CompileFunc(StdCompiler *pComp, C4ValueNumbers *);
 	void Clear()
 	{
-		for (unsigned int i = 0; i < Capacity; ++i)
-			Table[i] = 0;
+		ClearTable();
+		delete[] OldTable;
+		OldTable = 0;
+		Size = 0;
 	}
 	template<typename H> T & Get(H e) const
 	{
-		unsigned int h = Hash(e);
-		T * r = &Table[h % Capacity];
-		while (*r && !Equals(*r, e))
-		{
-			r = &Table[++h % Capacity];
-		}
-		return *r;
+		T * r = Find(e);
+		return r ? *r : EmptyElement();
 	}
 	template<typename H> bool Has(H e) const
 	{
-		unsigned int h = Hash(e);
-		T * r = &Table[h % Capacity];
-		while (*r && !Equals(*r, e))
-		{
-			r = &Table[++h % Capacity];
-		}
-		return !!*r;
+		return !!Find(e);
 	}
 	unsigned int GetSize() const { return Size; }
 	T * Add(T const & e)
@@ -203,43 +322,55 @@ public:
 	}
 	template<typename H> void Remove(H e)
 	{
-		unsigned int h = Hash(e);
-		T * r = &Table[h % Capacity];
-		while (*r && !Equals(*r, e))
+		T * r = Find(e);
+		assert(r);
+		if (!r) return;
+		T * pTable = Table;
+		unsigned int iMask = Capacity - 1;
+		if (OldTable && r >= OldTable && r < OldTable + OldCapacity)
+		{
+			pTable = OldTable;
+			iMask = OldCapacity - 1;
+		}
+		// Backward shift: move the following elements of the chain one slot
+		// closer to their home, so that no tombstones are needed.
+		unsigned int i = r - pTable, j;
+		while (pTable[j = (i + 1) & iMask] && Distance(pTable, iMask, j))
 		{
-			r = &Table[++h % Capacity];
+			pTable[i] = std::move(pTable[j]);
+			i = j;
 		}
-		assert(*r);
-		*r = 0;
+		pTable[i] = 0;
 		--Size;
-		// Move entries which might have collided with e
-		while (*(r = &Table[++h % Capacity]))
+	}
+	T const * First() const
+	{
+		if (OldTable)
 		{
-			T m = *r;
-			*r = 0;
-			AddInternal(std::move(m));
+			T const * p = NextIn(OldTable, OldCapacity, OldTable - 1);
+			if (p) return p;
 		}
+		return NextIn(Table, Capacity, Table - 1);
 	}
-	T const * First() const { return Next(Table - 1); }
 	T const * Next(T const * p) const
 	{
-		while (++p != &Table[Capacity])
+		if (OldTable && p >= OldTable && p < OldTable + OldCapacity)
 		{
-			if (*p) return p;
+			p = NextIn(OldTable, OldCapacity, p);
+			return p ? p : NextIn(Table, Capacity, Table - 1);
 		}
-		return 0;
+		if (p < Table || p >= Table + Capacity) return 0;
+		return NextIn(Table, Capacity, p);
 	}
 	void Swap(C4Set<T> * S2)
 	{
-		unsigned int Capacity2 = S2->Capacity;
-		unsigned int Size2 = S2->Size;
-		T * Table2 = S2->Table;
-		S2->Capacity = Capacity;
-		S2->Size = Size;
-		S2->Table = Table;
-		Capacity = Capacity2;
-		Size = Size2;
-		Table = Table2;
+		std::swap(Capacity, S2->Capacity);
+		std::swap(Size, S2->Size);
+		std::swap(Table, S2->Table);
+		std::swap(OldCapacity, S2->OldCapacity);
+		std::swap(OldTable, S2->OldTable);
+		std::swap(MigratePos, S2->MigratePos);
+		std::swap(MigrateLeft, S2->MigrateLeft);
 	}
 	static bool SortFunc(const T *p1, const T*p2)
 	{
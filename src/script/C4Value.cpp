@@ -59,29 +59,31 @@ const char* GetC4VName(const C4V_Type Type)
 	}
 }
 
-C4Value::C4Value(C4Object *pObj): NextRef(NULL), Type(pObj ? C4V_PropList : C4V_Nil)
+C4Value::C4Value(C4Object *pObj): Type(pObj ? C4V_PropList : C4V_Nil), Generation(0)
 {
-	Data.PropList = pObj; AddDataRef();
+	Data.PropList = pObj; SetHandle(); AddDataRef();
 }
 
 C4Object * C4Value::getObj() const
 {
-	return CheckConversion(C4V_Object) ? Data.PropList->GetObject() : NULL;
+	return CheckConversion(C4V_Object) ? _getPropList()->GetObject() : NULL;
 }
 
 C4Object * C4Value::_getObj() const
 {
-	return Data.PropList ? Data.PropList->GetObject() : NULL;
+	C4PropList *p = _getPropList();
+	return p ? p->GetObject() : NULL;
 }
 
 C4Def * C4Value::getDef() const
 {
-	return CheckConversion(C4V_Def) ? Data.PropList->GetDef() : NULL;
+	return CheckConversion(C4V_Def) ? _getPropList()->GetDef() : NULL;
 }
 
 C4Def * C4Value::_getDef() const
 {
-	return Data.PropList ? Data.PropList->GetDef() : NULL;
+	C4PropList *p = _getPropList();
+	return p ? p->GetDef() : NULL;
 }
 
 C4Value C4VObj(C4Object *pObj) { return C4Value(static_cast<C4PropList*>(pObj)); }
@@ -89,21 +91,21 @@ C4Value C4VObj(C4Object *pObj) { return C4Value(static_cast<C4PropList*>(pObj));
 bool C4Value::FnCnvObject() const
 {
 	// try casting
-	if (Data.PropList->GetObject()) return true;
+	if (_getPropList()->GetObject()) return true;
 	return false;
 }
 
 bool C4Value::FnCnvDef() const
 {
 	// try casting
-	if (Data.PropList->GetDef()) return true;
+	if (_getPropList()->GetDef()) return true;
 	return false;
 }
 
 bool C4Value::FnCnvEffect() const
 {
 	// try casting
-	if (Data.PropList->GetEffect()) return true;
+	if (_getPropList()->GetEffect()) return true;
 	return false;
 }
 
@@ -138,17 +140,18 @@ StdStrBuf C4Value::GetDataString(int depth) const
 		return StdStrBuf(Data ? "true" : "false");
 	case C4V_PropList:
 	{
-		if (Data.PropList == ScriptEngine.GetPropList())
+		C4PropList *pPropList = _getPropList();
+		if (pPropList == ScriptEngine.GetPropList())
 			return StdStrBuf("Global");
-		C4Object * Obj = Data.PropList->GetObject();
-		if (Obj == Data.PropList)
+		C4Object * Obj = pPropList->GetObject();
+		if (Obj == pPropList)
 			return FormatString("Object(%d)", Obj->Number);
-		const C4PropListStatic * Def = Data.PropList->IsStatic();
+		const C4PropListStatic * Def = pPropList->IsStatic();
 		if (Def)
 			return Def->GetDataString();
 		StdStrBuf DataString;
 		DataString = "{";
-		Data.PropList->AppendDataString(&DataString, ", ", depth);
+		pPropList->AppendDataString(&DataString, ", ", depth);
 		DataString.AppendChar('}');
 		return DataString;
 	}
@@ -203,7 +206,7 @@ const C4Value & C4ValueNumbers::GetValue(uint32_t n)
 
 void C4Value::Denumerate(class C4ValueNumbers * numbers)
 {
-	switch (Type)
+	switch (GetType())
 	{
 	case C4V_Enum:
 		Set(numbers->GetValue(Data.Int)); break;
@@ -211,8 +214,8 @@ void C4Value::Denumerate(class C4ValueNumbers * numbers)
 		Data.Array->Denumerate(numbers); break;
 	case C4V_PropList:
 		// objects and effects are denumerated via the main object list
-		if (!Data.PropList->IsNumbered() && !Data.PropList->IsStatic())
-			Data.PropList->Denumerate(numbers);
+		if (!_getPropList()->IsNumbered() && !_getPropList()->IsStatic())
+			_getPropList()->Denumerate(numbers);
 		break;
 	case C4V_C4ObjectEnum:
 		{
@@ -258,7 +261,7 @@ void C4Value::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	if (!fCompiler)
 	{
 		assert(Type != C4V_Nil || !Data);
-		switch (Type)
+		switch (GetType())
 		{
 		case C4V_Nil:
 			cC4VID = 'n'; break;
@@ -53,6 +53,7 @@ union C4V_Data
 	C4String * Str;
 	C4ValueArray * Array;
 	C4AulFunc * Fn;
+	struct C4PropListHandle * Handle; // how C4Value stores proplists; GetData() returns PropList instead
 	// cheat a little - assume that all members have the same length
 	operator void * () { return Ptr; }
 	operator const void * () const { return Ptr; }
@@ -63,35 +64,38 @@ class C4Value
 {
 public:
 
-	C4Value() : NextRef(NULL), Type(C4V_Nil) { Data = 0; }
+	C4Value() : Type(C4V_Nil), Generation(0) { Data = 0; }
 
-	C4Value(const C4Value &nValue) : Data(nValue.Data), NextRef(NULL), Type(nValue.Type)
+	C4Value(const C4Value &nValue) : Data(nValue.Data), Type(nValue.Type), Generation(nValue.Generation)
 	{ AddDataRef(); }
+	C4Value(C4Value &&nValue) : Data(nValue.Data), Type(nValue.Type), Generation(nValue.Generation)
+	{ nValue.Data = 0; nValue.Type = C4V_Nil; }
 
-	explicit C4Value(bool data): NextRef(NULL), Type(C4V_Bool)
+	explicit C4Value(bool data): Type(C4V_Bool), Generation(0)
 	{ Data.Int = data; }
-	explicit C4Value(int32_t data):  NextRef(NULL), Type(C4V_Int)
+	explicit C4Value(int32_t data): Type(C4V_Int), Generation(0)
 	{ Data.Int = data; }
 	explicit C4Value(C4Object *pObj);
-	explicit C4Value(C4String *pStr): NextRef(NULL), Type(pStr ? C4V_String : C4V_Nil)
+	explicit C4Value(C4String *pStr): Type(pStr ? C4V_String : C4V_Nil), Generation(0)
 	{ Data.Str = pStr; AddDataRef(); }
-	explicit C4Value(C4ValueArray *pArray): NextRef(NULL), Type(pArray ? C4V_Array : C4V_Nil)
+	explicit C4Value(C4ValueArray *pArray): Type(pArray ? C4V_Array : C4V_Nil), Generation(0)
 	{ Data.Array = pArray; AddDataRef(); }
-	explicit C4Value(C4AulFunc * pFn): NextRef(NULL), Type(pFn ? C4V_Function : C4V_Nil)
+	explicit C4Value(C4AulFunc * pFn): Type(pFn ? C4V_Function : C4V_Nil), Generation(0)
 	{ Data.Fn = pFn; AddDataRef(); }
-	explicit C4Value(C4PropList *p): NextRef(NULL), Type(p ? C4V_PropList : C4V_Nil)
-	{ Data.PropList = p; AddDataRef(); }
+	explicit C4Value(C4PropList *p): Type(p ? C4V_PropList : C4V_Nil), Generation(0)
+	{ Data.PropList = p; SetHandle(); AddDataRef(); }
 
 	C4Value& operator = (const C4Value& nValue) { Set(nValue); return *this; }
+	C4Value& operator = (C4Value&& nValue);
 
-	~C4Value() { DelDataRef(Data, Type, NextRef); }
+	~C4Value() { DelDataRef(Data, Type, Generation); }
 
 	// Checked getters
 	int32_t getInt() const { return CheckConversion(C4V_Int) ? Data.Int : 0; }
 	bool getBool() const { return CheckConversion(C4V_Bool) ? !! Data : 0; }
 	C4Object * getObj() const;
 	C4Def * getDef() const;
-	C4PropList * getPropList() const { return CheckConversion(C4V_PropList) ? Data.PropList : NULL; }
+	C4PropList * getPropList() const { return CheckConversion(C4V_PropList) ? _getPropList() : NULL; }
 	C4String * getStr() const { return CheckConversion(C4V_String) ? Data.Str : NULL; }
 	C4ValueArray * getArray() const { return CheckConversion(C4V_Array) ? Data.Array : NULL; }
 	C4AulFunc * getFunction() const { return CheckConversion(C4V_Function) ? Data.Fn : NULL; }
@@ -104,12 +108,12 @@ public:
 	C4String *_getStr() const { return Data.Str; }
 	C4ValueArray *_getArray() const { return Data.Array; }
 	C4AulFunc *_getFunction() const { return Data.Fn; }
-	C4PropList *_getPropList() const { return Data.PropList; }
+	C4PropList *_getPropList() const; // NULL if the proplist is gone
 
 	bool operator ! () const { return !GetData(); }
 	inline operator const void* () const { return GetData() ? this : 0; }  // To allow use of C4Value in conditions
 
-	void Set(const C4Value &nValue) { Set(nValue.Data, nValue.Type); }
+	void Set(const C4Value &nValue);
 
 	void SetInt(int32_t i) { C4V_Data d; d.Int = i; Set(d, C4V_Int); }
 	void SetBool(bool b) { C4V_Data d; d.Int = b; Set(d, C4V_Bool); }
@@ -140,9 +144,9 @@ public:
 	C4Value & operator -- ()           { Data.Int--;     Type=C4V_Int; return *this; }
 	C4Value operator -- (int)          { C4Value old = *this; --(*this); return old; }
 
-	// getters
-	C4V_Data GetData()    const { return Data; }
-	C4V_Type GetType()    const { return Type; }
+	// getters; a value referring to a proplist that is gone reads as nil
+	C4V_Data GetData()    const;
+	C4V_Type GetType()    const;
 
 	const char *GetTypeName() const { return GetC4VName(GetType()); }
 
@@ -152,6 +156,7 @@ public:
 
 	ALWAYS_INLINE bool CheckParConversion(C4V_Type vtToType) const // convert to dest type
 	{
+		C4V_Type Type = GetType();
 		switch (vtToType)
 		{
 		case C4V_Nil:      return Type == C4V_Nil || (Type == C4V_Int && !*this);
@@ -170,6 +175,7 @@ public:
 	}
 	ALWAYS_INLINE bool CheckConversion(C4V_Type vtToType) const // convert to dest type
 	{
+		C4V_Type Type = GetType();
 		switch (vtToType)
 		{
 		case C4V_Nil:      return Type == C4V_Nil;
@@ -198,17 +204,18 @@ protected:
 	// data
 	C4V_Data Data;
 
-	// proplist reference list
-	C4Value * NextRef;
-
 	// data type
 	C4V_Type Type;
 
+	// proplists: generation of Data.Handle when the reference was taken
+	uint32_t Generation;
+
 
 	void Set(C4V_Data nData, C4V_Type nType);
+	void SetHandle(); // replace Data.PropList by its handle
 
 	void AddDataRef();
-	void DelDataRef(C4V_Data Data, C4V_Type Type, C4Value *pNextRef);
+	void DelDataRef(C4V_Data Data, C4V_Type Type, uint32_t iGeneration);
 
 	bool FnCnvObject() const;
 	bool FnCnvDef() const;
@@ -258,6 +265,32 @@ private:
 #include "C4PropList.h"
 #include "C4AulFunc.h"
 
+ALWAYS_INLINE C4PropList *C4Value::_getPropList() const
+{
+	if (Type != C4V_PropList) return Data.PropList;
+	return Data.Handle->Generation == Generation ? Data.Handle->PropList : NULL;
+}
+
+ALWAYS_INLINE C4V_Type C4Value::GetType() const
+{
+	if (Type == C4V_PropList && Data.Handle->Generation != Generation) return C4V_Nil;
+	return Type;
+}
+
+ALWAYS_INLINE C4V_Data C4Value::GetData() const
+{
+	if (Type != C4V_PropList) return Data;
+	C4V_Data d; d.PropList = _getPropList();
+	return d;
+}
+
+ALWAYS_INLINE void C4Value::SetHandle()
+{
+	if (Type != C4V_PropList) return;
+	Data.Handle = Data.PropList->GetHandle();
+	Generation = Data.Handle->Generation;
+}
+
 ALWAYS_INLINE void C4Value::AddDataRef()
 {
 	assert(Type < C4V_Any);
@@ -265,14 +298,22 @@ ALWAYS_INLINE void C4Value::AddDataRef()
 	switch (Type)
 	{
 	case C4V_PropList:
+		// only script proplists are reference counted
+		if (!(Generation & 1)) break;
+		if (Data.Handle->Generation != Generation)
+		{
+			// copy of a reference to a deleted proplist
+			Data = 0; Type = C4V_Nil;
+			break;
+		}
 #ifdef _DEBUG
-		assert(C4PropList::PropLists.Has(Data.PropList));
-		if (!Data.PropList->Status)
+		assert(C4PropList::PropLists.Has(Data.Handle->PropList));
+		if (!Data.Handle->PropList->Status)
 		{
-			LogDeletedObjectWarning(Data.PropList);
+			LogDeletedObjectWarning(Data.Handle->PropList);
 		}
 #endif
-		Data.PropList->AddRef(this);
+		++Data.Handle->RefCount;
 		break;
 	case C4V_String: Data.Str->IncRef(); break;
 	case C4V_Array: Data.Array->IncRef(); break;
@@ -281,14 +322,18 @@ ALWAYS_INLINE void C4Value::AddDataRef()
 	}
 }
 
-ALWAYS_INLINE void C4Value::DelDataRef(C4V_Data Data, C4V_Type Type, C4Value *pNextRef)
+ALWAYS_INLINE void C4Value::DelDataRef(C4V_Data Data, C4V_Type Type, uint32_t iGeneration)
 {
 	assert(Type < C4V_Any);
 	assert(Type != C4V_Nil || !Data);
 	// clean up
 	switch (Type)
 	{
-	case C4V_PropList: Data.PropList->DelRef(this, pNextRef); break;
+	case C4V_PropList:
+		if ((iGeneration & 1) && Data.Handle->Generation == iGeneration && !--Data.Handle->RefCount)
+			// last reference: the proplist releases the handle when deleted
+			delete Data.Handle->PropList;
+		break;
 	case C4V_String: Data.Str->DecRef(); break;
 	case C4V_Array: Data.Array->DecRef(); break;
 	case C4V_Function: Data.Fn->DecRef(); break;
@@ -296,22 +341,53 @@ ALWAYS_INLINE void C4Value::DelDataRef(C4V_Data Data, C4V_Type Type, C4Value *pN
 	}
 }
 
-ALWAYS_INLINE void C4Value::Set(C4V_Data nData, C4V_Type nType)
+ALWAYS_INLINE void C4Value::Set(const C4Value &nValue)
 {
-	// Do not add this to the same linked list twice.
-	if (Data == nData && Type >= C4V_FirstPointer) return;
+	C4V_Data oData = Data;
+	C4V_Type oType = Type;
+	uint32_t oGeneration = Generation;
+
+	// change
+	Data = nValue.Data;
+	Type = nValue.Type;
+	Generation = nValue.Generation;
+
+	// hold new data & clean up old
+	AddDataRef();
+	DelDataRef(oData, oType, oGeneration);
+}
 
+ALWAYS_INLINE void C4Value::Set(C4V_Data nData, C4V_Type nType)
+{
 	C4V_Data oData = Data;
 	C4V_Type oType = Type;
-	C4Value * oNextRef = NextRef;
+	uint32_t oGeneration = Generation;
 
 	// change
 	Data = nData;
 	Type = nData || IsNullableType(nType) ? nType : C4V_Nil;
+	SetHandle();
 
 	// hold new data & clean up old
 	AddDataRef();
-	DelDataRef(oData, oType, oNextRef);
+	DelDataRef(oData, oType, oGeneration);
+}
+
+ALWAYS_INLINE C4Value &C4Value::operator = (C4Value &&nValue)
+{
+	if (this == &nValue) return *this;
+	C4V_Data oData = Data;
+	C4V_Type oType = Type;
+	uint32_t oGeneration = Generation;
+
+	// take over the reference
+	Data = nValue.Data;
+	Type = nValue.Type;
+	Generation = nValue.Generation;
+	nValue.Data = 0; nValue.Type = C4V_Nil;
+
+	DelDataRef(oData, oType, oGeneration);
+	return *this;
 }
 
 ALWAYS_INLINE void C4Value::Set0()
@@ -324,7 +400,7 @@ ALWAYS_INLINE void C4Value::Set0()
 	Type = C4V_Nil;
 
 	// clean up (save even if Data was 0 before)
-	DelDataRef(oData, oType, NextRef);
+	DelDataRef(oData, oType, Generation);
 }
 
 #endif
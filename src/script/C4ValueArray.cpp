@@ -21,39 +21,110 @@
 #include <C4FindObject.h>
 #include <C4Object.h>
 
+// Heap storage for the items of one or more arrays
+class C4ValueArrayBuffer
+{
+public:
+	int32_t iRefCnt, iCapacity;
+
+	C4Value *Values() { return reinterpret_cast<C4Value *>(this + 1); }
+
+	static C4ValueArrayBuffer *New(int32_t iCapacity)
+	{
+		C4ValueArrayBuffer *pBuffer = static_cast<C4ValueArrayBuffer *>(ScriptPool.Alloc(sizeof(C4ValueArrayBuffer) + iCapacity * sizeof(C4Value)));
+		pBuffer->iRefCnt = 1;
+		pBuffer->iCapacity = iCapacity;
+		C4Value *pValues = pBuffer->Values();
+		for (int32_t i = 0; i < iCapacity; i++) new (&pValues[i]) C4Value();
+		return pBuffer;
+	}
+
+	void DecRef()
+	{
+		if (--iRefCnt) return;
+		C4Value *pValues = Values();
+		for (int32_t i = 0; i < iCapacity; i++) pValues[i].~C4Value();
+		ScriptPool.Free(this, sizeof(C4ValueArrayBuffer) + iCapacity * sizeof(C4Value));
+	}
+};
+
 C4ValueArray::C4ValueArray()
-		: iRefCnt(0), iSize(0), iCapacity(0), pData(NULL)
+		: iRefCnt(0), iSize(0), iCapacity(InlineSize), pData(InlineData), pBuffer(NULL)
 {
 }
 
 C4ValueArray::C4ValueArray(int32_t inSize)
-		: iRefCnt(0), iSize(0), iCapacity(0), pData(NULL)
+		: iRefCnt(0), iSize(0), iCapacity(InlineSize), pData(InlineData), pBuffer(NULL)
 {
 	SetSize(inSize);
 }
 
 C4ValueArray::C4ValueArray(const C4ValueArray &ValueArray2)
-		: iSize(0), iCapacity(0), pData(NULL)
+		: iRefCnt(0), iSize(0), iCapacity(InlineSize), pData(InlineData), pBuffer(NULL)
 {
-	SetSize(ValueArray2.GetSize());
-	for (int32_t i = 0; i < iSize; i++)
-		pData[i].Set(ValueArray2.GetItem(i));
+	*this = ValueArray2;
 }
 
 C4ValueArray::~C4ValueArray()
 {
-	delete[] pData; pData = NULL;
-	iSize = iCapacity = 0;
+	if (pBuffer) pBuffer->DecRef();
 }
 
 C4ValueArray &C4ValueArray::operator =(const C4ValueArray& ValueArray2)
 {
-	this->SetSize(ValueArray2.GetSize());
-	for (int32_t i = 0; i < iSize; i++)
-		pData[i].Set(ValueArray2.GetItem(i));
+	if (&ValueArray2 == this) return *this;
+	Reset();
+	if (ValueArray2.pBuffer)
+	{
+		// share the items until either array is modified
+		pBuffer = ValueArray2.pBuffer;
+		++pBuffer->iRefCnt;
+		pData = ValueArray2.pData;
+		iSize = ValueArray2.iSize;
+		iCapacity = 0;
+	}
+	else
+	{
+		for (int32_t i = 0; i < ValueArray2.iSize; i++)
+			InlineData[i] = ValueArray2.pData[i];
+		iSize = ValueArray2.iSize;
+	}
 	return *this;
 }
 
+void C4ValueArray::MakeOwn()
+{
+	if (pBuffer && (!iCapacity || pBuffer->iRefCnt > 1))
+		Reallocate(std::max(iSize, iCapacity));
+}
+
+void C4ValueArray::Reallocate(int32_t inCapacity)
+{
+	assert(inCapacity >= iSize);
+	C4ValueArrayBuffer *pnBuffer = NULL;
+	C4Value *pnData = InlineData;
+	if (inCapacity <= InlineSize && pData != InlineData)
+		inCapacity = InlineSize;
+	else
+	{
+		pnBuffer = C4ValueArrayBuffer::New(inCapacity);
+		pnData = pnBuffer->Values();
+	}
+	// shared items are copied, own items are moved
+	bool fShared = pBuffer && (!iCapacity || pBuffer->iRefCnt > 1);
+	for (int32_t i = 0; i < iSize; i++)
+	{
+		if (fShared)
+			pnData[i] = pData[i];
+		else
+			pnData[i] = std::move(pData[i]);
+	}
+	if (pBuffer) pBuffer->DecRef();
+	pBuffer = pnBuffer;
+	pData = pnData;
+	iCapacity = inCapacity;
+}
+
 class C4SortObjectSTL
 {
 private:
@@ -77,6 +148,7 @@ public:
 
 void C4ValueArray::Sort(class C4SortObject &rSort)
 {
+	MakeOwn();
 	if (rSort.PrepareCache(this))
 	{
 		// Initialize position array
@@ -108,6 +180,7 @@ struct C4ValueArraySortStringscomp
 
 void C4ValueArray::SortStrings()
 {
+	MakeOwn();
 	std::stable_sort(pData, pData+iSize, C4ValueArraySortStringscomp());
 }
 
@@ -125,6 +198,7 @@ struct C4ValueArraySortcomp
 void C4ValueArray::Sort(bool descending)
 {
 	// sort by whatever type the values have
+	MakeOwn();
 	std::stable_sort(pData, pData+iSize, C4ValueArraySortcomp());
 	if (descending) std::reverse(pData, pData+iSize);
 }
@@ -150,6 +224,7 @@ bool C4ValueArray::SortByProperty(C4String *prop_name, bool descending)
 		if (!pData[i].getPropList())
 			return false;
 	// now sort
+	MakeOwn();
 	std::stable_sort(pData, pData+iSize, C4ValueArraySortPropertycomp(prop_name));
 	if (descending) std::reverse(pData, pData+iSize);
 	return true;
@@ -178,6 +253,7 @@ bool C4ValueArray::SortByArrayElement(int32_t element_idx, bool descending)
 			return false;
 	}
 	// now sort
+	MakeOwn();
 	std::stable_sort(pData, pData+iSize, C4ValueArraySortArrayElementcomp(element_idx));
 	if (descending) std::reverse(pData, pData+iSize);
 	return true;
@@ -187,6 +263,7 @@ C4Value &C4ValueArray::operator[](int32_t iElem)
 {
 	assert(iElem < MaxSize);
 	assert(iElem >= 0);
+	MakeOwn();
 	if (iElem >= iSize && iElem < MaxSize) this->SetSize(iElem + 1);
 	// out-of-memory? This might not get caught, but it's better than a segfault
 	assert(iElem < iSize);
@@ -206,6 +283,7 @@ void C4ValueArray::SetItem(int32_t iElem, const C4Value &Value)
 	if (iElem >= iSize)
 		throw C4AulExecError("array access: index too large");
 	// set
+	MakeOwn();
 	pData[iElem]=Value;
 }
 
@@ -213,6 +291,11 @@ void C4ValueArray::SetSize(int32_t inSize)
 {
 	if(inSize == iSize) return;
 
+	// bounds check
+	if (inSize > MaxSize) return;
+
+	MakeOwn();
+
 	// array not larger than allocated memory? Well, just ignore the additional allocated mem then
 	if (inSize <= iCapacity)
 	{
@@ -222,22 +305,9 @@ void C4ValueArray::SetSize(int32_t inSize)
 		return;
 	}
 
-	// bounds check
-	if (inSize > MaxSize) return;
-
-	// create new array
-	C4Value* pnData = new C4Value [inSize];
-	if (!pnData) return;
-
-	// move existing values
-	int32_t i;
-	for (i=0; i<iSize; i++)
-		pnData[i] = pData[i];
-
-	// replace
-	delete[] pData;
-	pData = pnData;
-	iSize = iCapacity = inSize;
+	// grow geometrically, so appending items one by one takes amortized constant time
+	Reallocate(std::max(inSize, std::min<int32_t>(iCapacity * 2, MaxSize)));
+	iSize = inSize;
 }
 
 bool C4ValueArray::operator==(const C4ValueArray& IntList2) const
@@ -251,12 +321,15 @@ bool C4ValueArray::operator==(const C4ValueArray& IntList2) const
 
 void C4ValueArray::Reset()
 {
-	delete[] pData; pData = NULL;
-	iSize = iCapacity = 0;
+	if (pBuffer) { pBuffer->DecRef(); pBuffer = NULL; }
+	for (int32_t i = 0; i < InlineSize; i++) InlineData[i].Set0();
+	pData = InlineData;
+	iSize = 0; iCapacity = InlineSize;
 }
 
 void C4ValueArray::Denumerate(C4ValueNumbers * numbers)
 {
+	MakeOwn();
 	for (int32_t i = 0; i < iSize; i++)
 		pData[i].Denumerate(numbers);
 }
@@ -272,7 +345,7 @@ void C4ValueArray::CompileFunc(class StdCompiler *pComp, C4ValueNumbers * number
 	// Separator
 	pComp->Separator(StdCompiler::SEP_SEP2);
 	// Allocate
-	if (pComp->isCompiler()) this->SetSize(inSize);
+	if (pComp->isCompiler()) { this->SetSize(inSize); MakeOwn(); }
 	// Values
 	pComp->Value(mkArrayAdaptMap(pData, iSize, C4Value(), mkParAdaptMaker(numbers)));
 }
@@ -290,7 +363,19 @@ C4ValueArray * C4ValueArray::GetSlice(int32_t startIndex, int32_t endIndex)
 	else if (endIndex < -iSize) throw C4AulExecError("array slice: end index out of range");
 	else if (endIndex < 0) endIndex += iSize;
 
-	C4ValueArray* NewArray = new C4ValueArray(std::max(0, endIndex - startIndex));
+	int32_t inSize = std::max(0, endIndex - startIndex);
+	C4ValueArray* NewArray = new C4ValueArray();
+	if (pBuffer && inSize > InlineSize)
+	{
+		// share the items until either array is modified
+		NewArray->pBuffer = pBuffer;
+		++pBuffer->iRefCnt;
+		NewArray->pData = pData + startIndex;
+		NewArray->iSize = inSize;
+		NewArray->iCapacity = 0;
+		return NewArray;
+	}
+	NewArray->SetSize(inSize);
 	for (int i = startIndex; i < endIndex; ++i)
 		NewArray->pData[i - startIndex] = pData[i];
 	return NewArray;
@@ -315,72 +400,43 @@ void C4ValueArray::SetSlice(int32_t startIndex, int32_t endIndex, const C4Value
 	// setting an array?
 	if(Val.GetType() == C4V_Array)
 	{
-		const C4ValueArray &Other = *Val._getArray(); // Remember that &Other could be equal to this, carefull with modifying pData
+		// Take a snapshot, because the other array could be this one or share its items
+		const C4ValueArray Other(*Val._getArray());
+		int32_t iOtherSize = Other.GetSize();
 
 		// Calculcate new size
-		int32_t iNewEnd = std::min(startIndex + Other.GetSize(), (int32_t)MaxSize);
+		int32_t iNewEnd = std::min(startIndex + iOtherSize, (int32_t)MaxSize);
 		int32_t iNewSize = iNewEnd;
 		if(endIndex < iSize)
 			iNewSize += iSize - endIndex;
 		iNewSize = std::min(iNewSize, (int32_t)MaxSize);
-		int32_t iOtherSize = Other.GetSize();
 
-		if(iNewSize != iSize)
+		// Move the items behind the slice to their new place
+		int32_t i,j;
+		if(iNewSize > iSize)
 		{
-			int32_t i,j;
-			C4Value* pnData = pData;
-
-			if(iNewSize > iCapacity)
-			{
-				 pnData = new C4Value [iNewSize];
-
-				 // Copy first part of old array
-				for(i = 0; i < startIndex && i < iSize; ++i)
-					pnData[i] = pData[i];
-			}
-
-			// Copy the second slice of the new array
+			SetSize(iNewSize);
+			for(i = iNewSize - 1, j = endIndex + iNewSize - 1 - iNewEnd; i >= iNewEnd; --i, --j)
+				pData[i] = std::move(pData[j]);
+		}
+		else
+		{
+			MakeOwn();
 			for(i = iNewEnd, j = endIndex; i < iNewSize; ++i, ++j)
-			{
-				assert(j < iSize);
-				pnData[i] = pData[j];
-			}
-
-			// Copy the data
-			// Since pnData and pData can be the same, we can not copy with
-			//for(i = startIndex, j = 0; i < iNewEnd; ++i, ++j)
-			// but have to start from the end of the copied sequence. That works, since j <= i
-			for(i = iNewEnd - 1, j = iNewEnd - startIndex - 1; i >= startIndex; --i, --j)
-			{
-				assert(j < iOtherSize);
-				pnData[i] = Other.pData[j];
-			}
-
-			// Other values should have been initialized to 0 by new
-			if(pData != pnData)
-			{
-				delete [] pData;
-				pData = pnData;
-				iCapacity = iSize = iNewSize;
-			}
-			else
-			{
-				// "ignore" the now unused part
-				for(i = iNewSize; i < iSize; ++i)
-					pData[i].Set0();
-				iSize = iNewSize;
-			}
-
-		} else // slice has the same size as inserted array
-			// Copy the data. changing pData does not break because if &Other == this and iNewSize == iSize, nothing happens at all
-			for(int32_t i = startIndex, j = 0; j < iOtherSize; i++, j++)
-				pData[i] = Other.pData[j];
+				pData[i] = std::move(pData[j]);
+			SetSize(iNewSize);
+		}
+
+		// Copy the data
+		for(i = startIndex, j = 0; i < iNewEnd; ++i, ++j)
+			pData[i] = Other.pData[j];
 
 	} else /* if(Val.GetType() != C4V_Array) */ {
 		if(endIndex > MaxSize) endIndex = iSize;
 
 		// Need resize?
 		if(endIndex > iSize) SetSize(endIndex);
+		MakeOwn();
 
 		// Fill
 		for(int32_t i = startIndex; i < endIndex; i++)
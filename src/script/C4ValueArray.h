@@ -15,15 +15,19 @@
  */
 
 #include "C4Value.h"
+#include "C4ScriptPool.h"
 
 #ifndef INC_C4ValueList
 #define INC_C4ValueList
 
 // reference counted array of C4Values
+// Short arrays keep their items inline. Longer arrays keep them in a heap
+// buffer that copies and slices share until one of them is modified.
 class C4ValueArray
 {
 public:
 	enum { MaxSize = 1000000 }; // ye shalt not create arrays larger than that!
+	enum { InlineSize = 4 }; // arrays up to this size don't allocate
 
 	C4ValueArray();
 	C4ValueArray(int32_t inSize);
@@ -33,6 +37,8 @@ public:
 
 	C4ValueArray &operator =(const C4ValueArray&);
 
+	C4SCRIPTPOOL_ALLOCATED
+
 	int32_t GetSize() const { return iSize; }
 
 	const C4Value &GetItem(int32_t iElem) const
@@ -55,7 +61,7 @@ public:
 
 	void Reset();
 	void SetItem(int32_t iElemNr, const C4Value &Value); // interface for script
-	void SetSize(int32_t inSize); // (enlarge only!)
+	void SetSize(int32_t inSize); // grows the capacity geometrically
 
 	void Denumerate(C4ValueNumbers *);
 
@@ -82,10 +88,15 @@ public:
 	bool SortByArrayElement(int32_t array_idx, bool descending=false); // checks that this is an array of all arrays and sorts by array elements at index. returns false if an element is not an array or smaller than array_idx+1
 
 private:
+	void MakeOwn(); // copy shared items before modifying them
+	void Reallocate(int32_t inCapacity); // move items to own storage for inCapacity items
+
 	// Reference counter
 	unsigned int iRefCnt;
-	int32_t iSize, iCapacity;
-	C4Value* pData;
+	int32_t iSize, iCapacity; // iCapacity is 0 while the items are shared with another array
+	C4Value* pData; // points into InlineData or into *pBuffer
+	class C4ValueArrayBuffer *pBuffer; // heap storage, possibly shared; NULL while inline
+	C4Value InlineData[InlineSize]; // all nil unless in use
 };
 
 #endif
@@ -0,0 +1,67 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "script/C4ScriptPool.h"
+#include "script/C4ValueArray.h"
+
+#include <gtest/gtest.h>
+
+TEST(C4ScriptPoolTest, ReusesFreedMemory)
+{
+	void *p = ScriptPool.Alloc(40);
+	ScriptPool.Free(p, 40);
+	// same size class
+	void *q = ScriptPool.Alloc(48);
+	EXPECT_EQ(p, q);
+	ScriptPool.Free(q, 48);
+	// other size class
+	void *r = ScriptPool.Alloc(64);
+	EXPECT_NE(p, r);
+	ScriptPool.Free(r, 64);
+}
+
+TEST(C4ScriptPoolTest, Counters)
+{
+	ScriptPool.NewFrame();
+	void *p = ScriptPool.Alloc(24), *pLarge = ScriptPool.Alloc(C4ScriptPool::MaxSize + 1);
+	ScriptPool.Free(p, 24);
+	EXPECT_EQ(2, ScriptPool.Frame.Allocs);
+	EXPECT_EQ(1, ScriptPool.Frame.Frees);
+	EXPECT_EQ(int64_t(C4ScriptPool::MaxSize + 25), ScriptPool.Frame.Bytes);
+	ScriptPool.Free(pLarge, C4ScriptPool::MaxSize + 1);
+	ScriptPool.NewFrame();
+	EXPECT_EQ(2, ScriptPool.LastFrame.Frees);
+	EXPECT_EQ(0, ScriptPool.Frame.Allocs);
+}
+
+TEST(C4ScriptPoolTest, ArraysDontGrowThePool)
+{
+	// warm up, then the chunks stay the same for arrays of the same sizes
+	for (int i = 0; i < 2; ++i)
+	{
+		int32_t iChunks = ScriptPool.Chunks;
+		for (int j = 0; j < 1000; ++j)
+		{
+			C4ValueArray *pArray = new C4ValueArray(j % 10);
+			pArray->IncRef();
+			pArray->DecRef();
+		}
+		if (i)
+		{
+			EXPECT_EQ(iChunks, ScriptPool.Chunks);
+		}
+	}
+}
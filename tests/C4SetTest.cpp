@@ -0,0 +1,130 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "script/C4PropList.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <set>
+#include <vector>
+
+class C4SetTest: public ::testing::Test
+{
+protected:
+	std::vector<C4String *> Keys;
+
+	void SetUp()
+	{
+		for (int i = 0; i < 10000; ++i)
+		{
+			Keys.push_back(Strings.RegString(FormatString("C4SetTest%d", i)));
+			Keys.back()->IncRef();
+		}
+	}
+	void TearDown()
+	{
+		for (size_t i = 0; i < Keys.size(); ++i)
+			Keys[i]->DecRef();
+	}
+};
+
+TEST_F(C4SetTest, RandomOperations)
+{
+	// compare against std::set with adds and removes mixed, on small and large sets
+	for (int iRange = 8; iRange <= 10000; iRange *= 10)
+	{
+		C4Set<C4Property> Set;
+		std::set<C4String *> Reference;
+		srand(iRange);
+		for (int i = 0; i < 20 * iRange; ++i)
+		{
+			C4String *pKey = Keys[rand() % iRange];
+			if (rand() % 3)
+			{
+				if (!Set.Has(pKey)) Set.Add(C4Property(pKey, C4VInt(i)));
+				else Set.Get(pKey).Value = C4VInt(i);
+				Reference.insert(pKey);
+			}
+			else if (Set.Has(pKey))
+			{
+				Set.Remove(pKey);
+				Reference.erase(pKey);
+			}
+		}
+		ASSERT_EQ(Reference.size(), Set.GetSize());
+		for (int i = 0; i < iRange; ++i)
+			EXPECT_EQ(Reference.count(Keys[i]) != 0, Set.Has(Keys[i]));
+		// iteration sees every element once
+		size_t iCount = 0;
+		for (const C4Property *p = Set.First(); p; p = Set.Next(p))
+		{
+			EXPECT_EQ(1u, Reference.count(p->Key));
+			++iCount;
+		}
+		EXPECT_EQ(Reference.size(), iCount);
+	}
+}
+
+TEST_F(C4SetTest, Benchmark)
+{
+	typedef std::chrono::steady_clock Clock;
+	typedef std::chrono::duration<double, std::nano> ns;
+	// proplist sized sets: insert, lookup hits and misses, remove
+	const int iSets = 2000, iProps = 24;
+	std::vector<C4Set<C4Property> > Sets(iSets);
+	Clock::time_point tStart = Clock::now();
+	for (int n = 0; n < iSets; ++n)
+		for (int i = 0; i < iProps; ++i)
+			Sets[n].Add(C4Property(Keys[(n * 7 + i * 13) % Keys.size()], C4VInt(i)));
+	double dInsert = ns(Clock::now() - tStart).count() / (iSets * iProps);
+	int iFound = 0;
+	tStart = Clock::now();
+	for (int j = 0; j < 20; ++j)
+		for (int n = 0; n < iSets; ++n)
+			for (int i = 0; i < iProps; ++i)
+				if (Sets[n].Has(Keys[(n * 7 + i * 13) % Keys.size()])) ++iFound;
+	double dHit = ns(Clock::now() - tStart).count() / (20 * iSets * iProps);
+	EXPECT_EQ(20 * iSets * iProps, iFound);
+	tStart = Clock::now();
+	for (int j = 0; j < 20; ++j)
+		for (int n = 0; n < iSets; ++n)
+			for (int i = 0; i < iProps; ++i)
+				if (Sets[n].Has(Keys[(n * 7 + i * 13 + 1) % Keys.size()])) ++iFound;
+	double dMiss = ns(Clock::now() - tStart).count() / (20 * iSets * iProps);
+	tStart = Clock::now();
+	for (int n = 0; n < iSets; ++n)
+		for (int i = 0; i < iProps; i += 2)
+			Sets[n].Remove(Keys[(n * 7 + i * 13) % Keys.size()]);
+	double dRemove = ns(Clock::now() - tStart).count() / (iSets * iProps / 2);
+	printf("C4Set small sets: insert %.1f ns, hit %.1f ns, miss %.1f ns, remove %.1f ns\n", dInsert, dHit, dMiss, dRemove);
+
+	// one large set with mixed adds, lookups and removes
+	tStart = Clock::now();
+	C4Set<C4Property> Set;
+	int iOps = 0;
+	iFound = 0;
+	for (int j = 0; j < 20; ++j)
+	{
+		for (size_t i = j % 2; i < Keys.size(); i += 2, ++iOps)
+			if (!Set.Has(Keys[i])) Set.Add(C4Property(Keys[i], C4VInt(j)));
+		for (size_t i = 0; i < Keys.size(); ++i, ++iOps)
+			if (Set.Has(Keys[i])) ++iFound;
+		for (size_t i = j % 3; i < Keys.size(); i += 3, ++iOps)
+			if (Set.Has(Keys[i])) Set.Remove(Keys[i]);
+	}
+	printf("C4Set large set: %.1f ns per operation\n", ns(Clock::now() - tStart).count() / iOps);
+	EXPECT_LT(0, iFound);
+}
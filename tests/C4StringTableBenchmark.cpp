@@ -0,0 +1,67 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "script/C4StringTable.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+// Prints timings; fails only if the table loses strings.
+TEST(C4StringTableBenchmark, RegisterAndFind)
+{
+	const int iCount = 200000;
+	std::vector<StdCopyStrBuf> Names(iCount);
+	for (int i = 0; i < iCount; ++i)
+		Names[i].Format("Benchmark_Property_%d_%x", i, i * 7919);
+	std::vector<C4String *> Registered(iCount);
+
+	// registering; the longest single call shows rehashing pauses
+	double dMax = 0;
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < iCount; ++i)
+	{
+		std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+		Registered[i] = Strings.RegString(Names[i].getData());
+		Registered[i]->IncRef();
+		dMax = std::max(dMax, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t).count());
+	}
+	double dTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - tStart).count();
+	printf("C4StringTable register: %.1f ns per string, longest %.1f us\n", dTime / iCount, dMax);
+
+	// lookup of existing strings
+	tStart = std::chrono::steady_clock::now();
+	int iFound = 0;
+	for (int j = 0; j < 5; ++j)
+		for (int i = 0; i < iCount; ++i)
+			if (Strings.FindString(Names[i].getData()) == Registered[i]) ++iFound;
+	dTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - tStart).count();
+	printf("C4StringTable find: %.1f ns per string\n", dTime / (5 * iCount));
+	EXPECT_EQ(5 * iCount, iFound);
+
+	// lookup of missing strings
+	tStart = std::chrono::steady_clock::now();
+	int iMissing = 0;
+	for (int i = 0; i < iCount; ++i)
+		if (!Strings.FindString(FormatString("Missing_Property_%d", i).getData())) ++iMissing;
+	dTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - tStart).count();
+	printf("C4StringTable find missing: %.1f ns per string\n", dTime / iCount);
+	EXPECT_EQ(iCount, iMissing);
+
+	for (int i = 0; i < iCount; ++i)
+		Registered[i]->DecRef();
+	EXPECT_FALSE(Strings.FindString(Names[0].getData()));
+}
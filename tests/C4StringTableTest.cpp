@@ -51,3 +51,28 @@ TEST(C4StringTableTest, ComparisonOperators)
 	EXPECT_NE(v1, v2);
 	EXPECT_EQ(v1, v3);
 }
+
+TEST(C4StringTableTest, GrowWhileRemoving)
+{
+	// enough strings to make the table grow incrementally, while others get removed
+	std::vector<C4String *> Live;
+	for (int i = 0; i < 20000; ++i)
+	{
+		C4String * str = Strings.RegString(FormatString("GrowWhileRemoving%d", i));
+		str->IncRef();
+		Live.push_back(str);
+		if (i % 3 == 2)
+		{
+			Live[i / 2]->DecRef();
+			Live[i / 2] = NULL;
+		}
+	}
+	for (size_t i = 0; i < Live.size(); ++i)
+	{
+		StdStrBuf Name(FormatString("GrowWhileRemoving%d", (int) i));
+		EXPECT_EQ(Live[i], Strings.FindString(Name.getData()));
+		if (Live[i]) Live[i]->DecRef();
+	}
+	EXPECT_FALSE(Strings.FindString("GrowWhileRemoving0"));
+	EXPECT_FALSE(Strings.FindString("GrowWhileRemoving19999"));
+}
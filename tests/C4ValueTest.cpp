@@ -17,6 +17,7 @@
 #include "script/C4Value.h"
 
 #include <gtest/gtest.h>
+#include <chrono>
 
 TEST(C4ValueTest, SanityTests)
 {
@@ -34,3 +35,66 @@ TEST(C4ValueTest, SanityTests)
 	EXPECT_TRUE(C4Value(true));
 	EXPECT_FALSE(C4Value(false));
 }
+
+namespace
+{
+	// host proplist like objects and effects: deleted explicitly, references not counted
+	class TestPropList: public C4PropList { };
+}
+
+TEST(C4ValueTest, DeletedPropListReadsNil)
+{
+	TestPropList *p = new TestPropList;
+	C4Value v1(p), v2(v1), v3;
+	v3 = v2;
+	EXPECT_EQ(C4V_PropList, v3.GetType());
+	EXPECT_EQ(p, v3.getPropList());
+	EXPECT_TRUE(v1.IsIdenticalTo(v3));
+	delete p;
+	EXPECT_EQ(C4V_Nil, v1.GetType());
+	EXPECT_FALSE(v2);
+	EXPECT_FALSE(v3.getPropList());
+	EXPECT_EQ(C4VNull, v3);
+	C4Value v4(v3);
+	EXPECT_EQ(C4V_Nil, v4.GetType());
+	// a new proplist reusing the handle is not mistaken for the deleted one
+	TestPropList *q = new TestPropList;
+	C4Value w(q);
+	EXPECT_EQ(C4V_Nil, v1.GetType());
+	EXPECT_FALSE(v1.IsIdenticalTo(w));
+	delete q;
+}
+
+TEST(C4ValueTest, ScriptPropListRefCount)
+{
+	C4Value v(C4PropList::New());
+	C4Value w(v);
+	v.Set0();
+	ASSERT_EQ(C4V_PropList, w.GetType());
+	w.getPropList()->SetProperty(P_Name, w);
+	EXPECT_EQ(w.getPropList(), w.getPropList()->GetPropertyPropList(P_Name));
+	// the cycle is broken by emptying the proplist, then the last reference deletes it
+	w.getPropList()->Clear();
+	w.Set0();
+	EXPECT_EQ(C4V_Nil, w.GetType());
+}
+
+TEST(C4ValueTest, CopyBenchmark)
+{
+	// copying references to host proplists only touches the C4Value
+	EXPECT_LE(sizeof(C4Value), 16u);
+	TestPropList *p = new TestPropList;
+	std::vector<C4Value> Values(1000, C4Value(p));
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < 1000; ++i)
+	{
+		std::vector<C4Value> Copy(Values);
+		for (size_t j = 0; j < Values.size(); ++j)
+			Values[j] = Copy[Values.size() - 1 - j];
+	}
+	double dTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - tStart).count();
+	printf("C4Value copy and assign: %.2f ns\n", dTime / (2 * 1000 * Values.size()));
+	delete p;
+	for (size_t j = 0; j < Values.size(); ++j)
+		EXPECT_EQ(C4V_Nil, Values[j].GetType());
+}
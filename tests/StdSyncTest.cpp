@@ -0,0 +1,39 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "platform/StdSync.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+TEST(StdSyncTest, TimedWaitWaitsForTimeout)
+{
+	CStdEvent Event(false);
+	auto tStart = std::chrono::steady_clock::now();
+	EXPECT_FALSE(Event.WaitFor(100));
+	EXPECT_GE(std::chrono::steady_clock::now() - tStart, std::chrono::milliseconds(90));
+}
+
+TEST(StdSyncTest, TimedWaitReturnsWhenSet)
+{
+	CStdEvent Event(false);
+	std::thread Setter([&Event]() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); Event.Set(); });
+	EXPECT_TRUE(Event.WaitFor(10000));
+	Setter.join();
+	// auto reset
+	EXPECT_FALSE(Event.WaitFor(0));
+}
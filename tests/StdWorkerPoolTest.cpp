@@ -0,0 +1,141 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "platform/StdWorkerPool.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace
+{
+	// counts how often each index was visited
+	void CountPart(void *pData, int32_t iBegin, int32_t iEnd)
+	{
+		int32_t *piCounts = static_cast<int32_t *>(pData);
+		for (int32_t i = iBegin; i < iEnd; ++i) ++piCounts[i];
+	}
+
+	// a result per index that takes some work
+	void HashPart(void *pData, int32_t iBegin, int32_t iEnd)
+	{
+		uint32_t *piHashes = static_cast<uint32_t *>(pData);
+		for (int32_t i = iBegin; i < iEnd; ++i)
+		{
+			uint32_t h = 2166136261u;
+			for (int32_t j = 0; j < 1000; ++j) h = (h ^ uint32_t(i + j)) * 16777619u;
+			piHashes[i] = h;
+		}
+	}
+
+	// notes which parts are done, for the progress function to look at
+	struct Progress
+	{
+		std::unique_ptr<std::atomic<int32_t>[]> Done;
+		std::thread::id Caller;
+		int32_t iCalls, iLastDone;
+		bool fOtherThread;
+	};
+
+	void MarkPart(void *pData, int32_t iBegin, int32_t iEnd)
+	{
+		Progress *pProgress = static_cast<Progress *>(pData);
+		for (int32_t i = iBegin; i < iEnd; ++i) ++pProgress->Done[i];
+	}
+
+	void CheckProgress(void *pData)
+	{
+		Progress *pProgress = static_cast<Progress *>(pData);
+		if (std::this_thread::get_id() != pProgress->Caller) pProgress->fOtherThread = true;
+		++pProgress->iCalls;
+		pProgress->iLastDone = 0;
+		for (int32_t i = 0; i < 1000; ++i) pProgress->iLastDone += pProgress->Done[i];
+	}
+}
+
+TEST(StdWorkerPoolTest, EveryIndexOnce)
+{
+	StdWorkerPool Pool;
+	for (int32_t iThreads : { 0, 1, 3 })
+	{
+		Pool.SetThreadCount(iThreads);
+		for (int32_t iCount : { 0, 1, 7, 100, 10000 })
+			for (int32_t iMinPart : { 1, 16 })
+			{
+				std::vector<int32_t> Counts(iCount + 1, 0);
+				Pool.Run(&CountPart, &Counts[0], iCount, iMinPart);
+				for (int32_t i = 0; i < iCount; ++i)
+					ASSERT_EQ(1, Counts[i]) << "index " << i << " of " << iCount << " with " << iThreads << " threads";
+				EXPECT_EQ(0, Counts[iCount]);
+			}
+	}
+}
+
+TEST(StdWorkerPoolTest, SameResultsForAnyThreadCount)
+{
+	// The game relies on this for synchronization: one thread and many
+	// compute the same, however the parts get distributed
+	const int32_t iCount = 5000;
+	std::vector<uint32_t> Single(iCount), Multi(iCount);
+	StdWorkerPool Pool;
+	Pool.Run(&HashPart, &Single[0], iCount);
+	Pool.SetThreadCount(4);
+	for (int32_t i = 0; i < 50; ++i)
+	{
+		std::fill(Multi.begin(), Multi.end(), 0);
+		Pool.Run(&HashPart, &Multi[0], iCount, 1 + i % 8);
+		ASSERT_TRUE(Single == Multi) << "run " << i;
+	}
+}
+
+TEST(StdWorkerPoolTest, ChangeThreadCount)
+{
+	StdWorkerPool Pool;
+	Pool.SetThreadCount(3);
+	EXPECT_LE(Pool.GetThreadCount(), 3);
+	Pool.SetThreadCount(1);
+	EXPECT_LE(Pool.GetThreadCount(), 1);
+	std::vector<int32_t> Counts(50, 0);
+	Pool.Run(&CountPart, &Counts[0], 50);
+	EXPECT_EQ(50, std::count(Counts.begin(), Counts.end(), 1));
+	Pool.SetThreadCount(0);
+	EXPECT_EQ(0, Pool.GetThreadCount());
+}
+
+TEST(StdWorkerPoolTest, ProgressOnCallingThread)
+{
+	// the progress function may release what the calling thread holds,
+	// and sees all parts done before Run returns
+	StdWorkerPool Pool;
+	for (int32_t iThreads : { 0, 3 })
+	{
+		Pool.SetThreadCount(iThreads);
+		for (int32_t iRun = 0; iRun < 20; ++iRun)
+		{
+			Progress Data;
+			Data.Done.reset(new std::atomic<int32_t>[1000]);
+			for (int32_t i = 0; i < 1000; ++i) Data.Done[i] = 0;
+			Data.Caller = std::this_thread::get_id();
+			Data.iCalls = Data.iLastDone = 0;
+			Data.fOtherThread = false;
+			Pool.Run(&MarkPart, &Data, 1000, 1, &CheckProgress);
+			EXPECT_FALSE(Data.fOtherThread);
+			EXPECT_LE(1, Data.iCalls);
+			ASSERT_EQ(1000, Data.iLastDone) << "run " << iRun << " with " << iThreads << " threads";
+		}
+	}
+}
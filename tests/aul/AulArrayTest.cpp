@@ -0,0 +1,73 @@
+/*
+* OpenClonk, http://www.openclonk.org
+*
+* Copyright (c) 2015-2016, The OpenClonk Team and contributors
+*
+* Distributed under the terms of the ISC license; see accompanying file
+* "COPYING" for details.
+*
+* "Clonk" is a registered trademark of Matthes Bender, used with permission.
+* See accompanying file "TRADEMARK" for details.
+*
+* To redistribute this file separately, substitute the full license texts
+* for the above references.
+*/
+
+// Testing C4Aul array behaviour.
+
+#include "C4Include.h"
+#include "AulTest.h"
+
+#include <chrono>
+
+class AulArrayTest : public AulTest
+{
+protected:
+	// Run code and print how long it took
+	C4Value RunBenchmark(const char *szName, const char *code)
+	{
+		std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+		C4Value v = RunCode(code);
+		printf("%s: %.3f ms\n", szName, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tStart).count());
+		return v;
+	}
+};
+
+TEST_F(AulArrayTest, References)
+{
+	// arrays are passed by reference
+	EXPECT_EQ(C4VInt(5), RunCode("var a = [1, 2, 3], b = a; b[0] = 5; return a[0];"));
+	EXPECT_EQ(C4VInt(5), RunCode("var a = [1, 2, 3, 4, 5, 6, 7], b = a; b[6] = 5; return a[6];"));
+}
+
+TEST_F(AulArrayTest, Slices)
+{
+	// slices are copies, also when they share the items internally
+	EXPECT_EQ(C4VArray(C4VInt(2), C4VInt(3)), RunExpr("[1, 2, 3][1:]"));
+	EXPECT_EQ(C4VInt(2), RunCode("var a = [1, 2, 3, 4, 5, 6, 7], b = a[1:]; b[0] = 9; return a[1];"));
+	EXPECT_EQ(C4VInt(2), RunCode("var a = [1, 2, 3, 4, 5, 6, 7], b = a[1:]; a[1] = 9; return b[0];"));
+	EXPECT_EQ(C4VInt(7), RunCode("var a = [1, 2, 3, 4, 5, 6, 7], b = a[1:]; a = nil; return b[5];"));
+	EXPECT_EQ(C4VInt(6), RunCode("var a = [1, 2, 3, 4, 5, 6, 7], b = a[:]; SetLength(a, 2); return GetLength(b[1:]);"));
+	EXPECT_EQ(C4VArray(C4VInt(3), C4VInt(4), C4VInt(5), C4VInt(6), C4VInt(7), C4VInt(1)),
+		RunCode("var a = [1, 2, 3, 4, 5, 6, 7]; a = a[1:]; a = a[1:]; a[5] = 1; return a;"));
+}
+
+TEST_F(AulArrayTest, SliceAssignment)
+{
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(8), C4VInt(9), C4VInt(4)), RunCode("var a = [1, 2, 3, 4]; a[1:3] = [8, 9]; return a;"));
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(8), C4VInt(4)), RunCode("var a = [1, 2, 3, 4]; a[1:3] = [8]; return a;"));
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(7), C4VInt(8), C4VInt(9), C4VInt(4)), RunCode("var a = [1, 2, 3, 4]; a[1:3] = [7, 8, 9]; return a;"));
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(2), C4VNull, C4VInt(5)), RunCode("var a = [1, 2]; a[3:] = [5]; return a;"));
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(1), C4VInt(2), C4VInt(3), C4VInt(4), C4VInt(5), C4VInt(6), C4VInt(2), C4VInt(3), C4VInt(4), C4VInt(5), C4VInt(6)),
+		RunCode("var a = [1, 2, 3, 4, 5, 6]; a[1:1] = a; return a;"));
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(2), C4VInt(3), C4VInt(4), C4VInt(5), C4VInt(6), C4VInt(2), C4VInt(3), C4VInt(4), C4VInt(5), C4VInt(6)),
+		RunCode("var a = [1, 2, 3, 4, 5, 6]; a[1:1] = a[:]; a[1:2] = []; return a;"));
+}
+
+TEST_F(AulArrayTest, Benchmarks)
+{
+	EXPECT_EQ(C4VInt(20000), RunBenchmark("Append 20000 items", "var a = []; for (var i = 0; i < 20000; ++i) a[GetLength(a)] = i; return GetLength(a);"));
+	EXPECT_EQ(C4VInt(5000), RunBenchmark("Pop 5000 items from the front", "var a = []; SetLength(a, 5000); var n; while (GetLength(a)) { a = a[1:]; ++n; } return n;"));
+	EXPECT_EQ(C4VInt(5000), RunBenchmark("Copy a 5000 item array 5000 times", "var a = []; SetLength(a, 5000); var n; for (var i = 0; i < 5000; ++i) n = GetLength(a[:]); return n;"));
+	EXPECT_EQ(C4VInt(200000), RunBenchmark("Create 100000 pairs", "var n; for (var i = 0; i < 100000; ++i) n += GetLength([i, i]); return n;"));
+}
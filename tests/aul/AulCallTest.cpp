@@ -0,0 +1,67 @@
+/*
+* OpenClonk, http://www.openclonk.org
+*
+* Copyright (c) 2015-2016, The OpenClonk Team and contributors
+*
+* Distributed under the terms of the ISC license; see accompanying file
+* "COPYING" for details.
+*
+* "Clonk" is a registered trademark of Matthes Bender, used with permission.
+* See accompanying file "TRADEMARK" for details.
+*
+* To redistribute this file separately, substitute the full license texts
+* for the above references.
+*/
+
+// Testing calls of engine functions from C4Aul.
+
+#include "C4Include.h"
+#include "AulTest.h"
+
+#include "script/C4Aul.h"
+
+#include <chrono>
+
+class AulCallTest : public AulTest
+{
+protected:
+	// Run code and print how long it took
+	C4Value RunBenchmark(const char *szName, const char *code)
+	{
+		std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+		C4Value v = RunCode(code);
+		printf("%s: %.3f ms\n", szName, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tStart).count());
+		return v;
+	}
+};
+
+TEST_F(AulCallTest, Parameters)
+{
+	// missing parameters and nil convert to the parameter type
+	EXPECT_EQ(C4VInt(0), RunExpr("Abs()"));
+	EXPECT_EQ(C4VInt(0), RunExpr("Abs(nil)"));
+	EXPECT_EQ(C4VInt(5), RunExpr("Abs(-5)"));
+	EXPECT_EQ(C4VInt(1), RunExpr("Abs(true)"));
+	EXPECT_EQ(C4VInt(5), RunExpr("BoundBy(7, 0, 5)"));
+	EXPECT_EQ(C4VInt(5), RunExpr("Distance(0, 0, 3, 4)"));
+	EXPECT_EQ(C4VInt(5), RunCode("var a = -5; return Abs(a);"));
+	EXPECT_EQ(C4VInt(3), RunCode("var a = [1, 2, 3]; return GetLength(a);"));
+	// parameters of the wrong type
+	EXPECT_THROW(RunExpr("Abs(\"5\")"), C4AulExecError);
+	EXPECT_THROW(RunExpr("Abs([])"), C4AulExecError);
+	EXPECT_THROW(RunExpr("BoundBy(1, {}, 5)"), C4AulExecError);
+	EXPECT_THROW(RunCode("var a = []; return Distance(0, 0, 3, a);"), C4AulExecError);
+	// results can be used in any way
+	EXPECT_EQ(C4VInt(10), RunCode("var a = [Abs(-10)]; return a[0];"));
+	EXPECT_EQ(C4VInt(7), RunCode("var x = 2; x += Abs(-5); return x;"));
+	EXPECT_EQ(C4VInt(3), RunExpr("Abs(Abs(-1) + Abs(-2))"));
+}
+
+TEST_F(AulCallTest, Benchmarks)
+{
+	EXPECT_EQ(C4VInt(1000000), RunBenchmark("Loop without calls 1000000 times", "var n; for (var i = 0; i < 1000000; ++i) n += 1; return n;"));
+	EXPECT_EQ(C4VInt(1000000), RunBenchmark("Call Abs 1000000 times", "var n; for (var i = 0; i < 1000000; ++i) n += Abs(-1); return n;"));
+	EXPECT_EQ(C4VInt(1000000), RunBenchmark("Call BoundBy 1000000 times", "var n; for (var i = 0; i < 1000000; ++i) n += BoundBy(i, 0, 1); return n + 1;"));
+	EXPECT_EQ(C4VInt(5000000), RunBenchmark("Call Distance 1000000 times", "var n; for (var i = 0; i < 1000000; ++i) n += Distance(0, 0, 3, 4); return n;"));
+	EXPECT_EQ(C4VInt(2000000), RunBenchmark("Call GetLength 1000000 times", "var a = [1, 2], n; for (var i = 0; i < 1000000; ++i) n += GetLength(a); return n;"));
+}
@@ -0,0 +1,116 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+// Testing that blits of the same texture are batched into one draw call.
+
+#include <C4Include.h>
+#include "graphics/C4DrawT.h"
+#include "graphics/C4Surface.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+	// the device of the dedicated server, which counts draw calls without drawing
+	class TestDraw : public CStdNoGfx
+	{
+	public:
+		TestDraw() { CreatePrimarySurfaces(640, 480, 32, 0); }
+	};
+
+	// a render target without a window
+	class TestTarget : public C4Surface
+	{
+	public:
+		TestTarget() { fPrimary = true; Wdt = 640; Hgt = 480; NoClip(); }
+	};
+}
+
+class C4DrawTest : public ::testing::Test
+{
+protected:
+	virtual void SetUp()
+	{
+		pDraw = &Draw;
+		ASSERT_TRUE(Sprites.Create(128, 32));
+		ASSERT_TRUE(Other.Create(32, 32));
+	}
+	virtual void TearDown()
+	{
+		// textures are freed through the device
+		Sprites.Clear();
+		Other.Clear();
+	}
+
+	// one of the 32x32 phases of a surface
+	void DrawPhase(C4Surface &sfc, int iPhase, float tx)
+	{
+		pDraw->Blit(&sfc, iPhase * 32, 0, 32, 32, &Target, tx, 0, 32, 32);
+	}
+
+	TestDraw Draw;
+	TestTarget Target;
+	C4Surface Sprites, Other;
+};
+
+TEST_F(C4DrawTest, UnbatchedBlitsDrawOneByOne)
+{
+	for (int i = 0; i < 4; ++i) DrawPhase(Sprites, i, 40 * i);
+	EXPECT_EQ(4u, Draw.DrawCalls);
+}
+
+TEST_F(C4DrawTest, SharedTextureIsOneDrawCall)
+{
+	pDraw->BeginBatch();
+	for (int i = 0; i < 4; ++i) DrawPhase(Sprites, i, 40 * i);
+	// nothing is drawn until the batch ends
+	EXPECT_EQ(0u, Draw.DrawCalls);
+	pDraw->EndBatch();
+	EXPECT_EQ(1u, Draw.DrawCalls);
+}
+
+TEST_F(C4DrawTest, NestedBatchesDrawAtTheOutermostEnd)
+{
+	pDraw->BeginBatch();
+	pDraw->BeginBatch();
+	for (int i = 0; i < 4; ++i) DrawPhase(Sprites, i, 40 * i);
+	pDraw->EndBatch();
+	EXPECT_EQ(0u, Draw.DrawCalls);
+	pDraw->EndBatch();
+	EXPECT_EQ(1u, Draw.DrawCalls);
+}
+
+TEST_F(C4DrawTest, OtherTextureStartsANewDrawCall)
+{
+	pDraw->BeginBatch();
+	DrawPhase(Sprites, 0, 0);
+	DrawPhase(Sprites, 1, 40);
+	DrawPhase(Other, 0, 80);
+	DrawPhase(Sprites, 2, 120);
+	pDraw->EndBatch();
+	EXPECT_EQ(3u, Draw.DrawCalls);
+}
+
+TEST_F(C4DrawTest, BlitStateChangeStartsANewDrawCall)
+{
+	pDraw->BeginBatch();
+	DrawPhase(Sprites, 0, 0);
+	pDraw->ActivateBlitModulation(0x80ffffff);
+	DrawPhase(Sprites, 1, 40);
+	DrawPhase(Sprites, 2, 80);
+	pDraw->DeactivateBlitModulation();
+	pDraw->EndBatch();
+	EXPECT_EQ(2u, Draw.DrawCalls);
+}
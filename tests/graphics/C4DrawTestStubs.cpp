@@ -0,0 +1,28 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2015, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+// Parts of the engine that C4Draw refers to, but the draw test does not use.
+
+#include <C4Include.h>
+#include "graphics/C4FontLoader.h"
+#include "lib/StdMesh.h"
+
+void CStdFont::DrawText(C4Surface *, float, float, DWORD, const char *, DWORD, C4Markup &, float) {}
+
+bool StdMeshInstance::UpdateBoneTransforms() { return false; }
+void StdMeshInstance::ReorderFaces(StdMeshMatrix *) {}
+
+StdMeshMatrix StdMeshMatrix::Identity() { return StdMeshMatrix(); }
+StdMeshMatrix operator*(const StdMeshMatrix &, const StdMeshMatrix &) { return StdMeshMatrix(); }